@@ -304,8 +304,7 @@ add_pending_items (gpointer data)
       current = g_queue_pop_head (to_add);
 
       /* Make sure object is registerd so we are notified if it goes away */
-      g_free (spi_register_object_to_path (spi_global_register,
-                                           G_OBJECT (current)));
+      spi_register_peek_object_path (spi_global_register, G_OBJECT (current));
 
       add_object (cache, G_OBJECT (current));
       g_object_unref (G_OBJECT (current));
@@ -438,6 +437,26 @@ spi_cache_in (SpiCache *cache, GObject *object)
     return FALSE;
 }
 
+guint
+spi_cache_get_n_objects (SpiCache *cache)
+{
+  return g_hash_table_size (cache->objects);
+}
+
+/*
+ * Estimates the memory used by the cache in bytes, including the objects
+ * waiting to be added to it but not the objects themselves.
+ */
+gsize
+spi_cache_get_memory_size (SpiCache *cache)
+{
+  gsize size = sizeof (SpiCache);
+
+  size += g_hash_table_size (cache->objects) * 3 * sizeof (gpointer);
+  size += g_queue_get_length (cache->add_traversal) * sizeof (GList);
+  return size;
+}
+
 #ifdef SPI_ATK_DEBUG
 void
 spi_cache_print_info (GObject *obj)
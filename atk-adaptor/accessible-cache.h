@@ -63,5 +63,11 @@ spi_cache_foreach (SpiCache *cache, GHFunc func, gpointer data);
 gboolean
 spi_cache_in (SpiCache *cache, GObject *object);
 
+guint
+spi_cache_get_n_objects (SpiCache *cache);
+
+gsize
+spi_cache_get_memory_size (SpiCache *cache);
+
 G_END_DECLS
 #endif /* ACCESSIBLE_CACHE_H */
@@ -33,13 +33,25 @@
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * Leased objects are kept alive by a reference from the leasing object until
+ * their lease expires. Each object has at most one lease; leasing it again
+ * extends that lease. Leases are kept in a timer wheel of one second slots,
+ * indexed by expiry time, so that taking, extending and ending a lease are
+ * all constant time.
+ */
+
 SpiLeasing *spi_global_leasing;
 
-typedef struct _ExpiryElement
+/* The number of one second slots in the timer wheel, more than any lease */
+#define WHEEL_SIZE 32
+
+typedef struct _Lease
 {
-  gint64 expiry_s;
   GObject *object;
-} ExpiryElement;
+  gint64 expiry_s;
+  GList link; /* In the wheel slot of expiry_s */
+} Lease;
 
 static void spi_leasing_dispose (GObject *object);
 
@@ -65,7 +77,9 @@ spi_leasing_class_init (SpiLeasingClass *klass)
 static void
 spi_leasing_init (SpiLeasing *leasing)
 {
-  leasing->expiry_queue = g_queue_new ();
+  leasing->leases = g_hash_table_new (g_direct_hash, g_direct_equal);
+  leasing->wheel = g_new0 (GQueue, WHEEL_SIZE);
+  leasing->wheel_time_s = g_get_monotonic_time () / 1000000;
   leasing->expiry_func_id = 0;
 }
 
@@ -76,20 +90,35 @@ spi_leasing_finalize (GObject *object)
 
   if (leasing->expiry_func_id)
     g_source_remove (leasing->expiry_func_id);
-  g_queue_free (leasing->expiry_queue);
+  g_hash_table_unref (leasing->leases);
+  g_free (leasing->wheel);
   G_OBJECT_CLASS (spi_leasing_parent_class)->finalize (object);
 }
 
+static void
+end_lease (SpiLeasing *leasing, Lease *lease)
+{
+#ifdef SPI_ATK_DEBUG
+  g_debug ("REVOKE - ");
+  spi_cache_print_info (lease->object);
+#endif
+
+  g_queue_unlink (&leasing->wheel[lease->expiry_s % WHEEL_SIZE], &lease->link);
+  g_hash_table_remove (leasing->leases, lease->object);
+  g_object_unref (lease->object);
+  g_slice_free (Lease, lease);
+}
+
 static void
 spi_leasing_dispose (GObject *object)
 {
   SpiLeasing *leasing = SPI_LEASING (object);
+  gint i;
 
-  ExpiryElement *head;
-  while ((head = g_queue_pop_head (leasing->expiry_queue)))
+  for (i = 0; i < WHEEL_SIZE; i++)
     {
-      g_object_unref (head->object);
-      g_slice_free (ExpiryElement, head);
+      while (leasing->wheel[i].head)
+        end_lease (leasing, leasing->wheel[i].head->data);
     }
   G_OBJECT_CLASS (spi_leasing_parent_class)->dispose (object);
 }
@@ -105,25 +134,25 @@ static gboolean
 expiry_func (gpointer data)
 {
   SpiLeasing *leasing = SPI_LEASING (data);
-
-  ExpiryElement *head, *current;
   gint64 secs = g_get_monotonic_time () / 1000000;
+  gint64 t;
 
-  head = g_queue_peek_head (leasing->expiry_queue);
-  while (head != NULL && head->expiry_s <= secs)
+  /* Go through the slots of the seconds that passed since the last time */
+  t = MAX (leasing->wheel_time_s + 1, secs - WHEEL_SIZE + 1);
+  for (; t <= secs; t++)
     {
-      current = g_queue_pop_head (leasing->expiry_queue);
-
-#ifdef SPI_ATK_DEBUG
-      g_debug ("REVOKE - ");
-      spi_cache_print_info (current->object);
-#endif
+      GList *l = leasing->wheel[t % WHEEL_SIZE].head;
 
-      g_object_unref (current->object);
-      g_slice_free (ExpiryElement, current);
+      while (l)
+        {
+          Lease *lease = l->data;
 
-      head = g_queue_peek_head (leasing->expiry_queue);
+          l = l->next;
+          if (lease->expiry_s <= secs)
+            end_lease (leasing, lease);
+        }
     }
+  leasing->wheel_time_s = secs;
 
   leasing->expiry_func_id = 0;
   add_expiry_timeout (leasing);
@@ -134,12 +163,9 @@ expiry_func (gpointer data)
 /*---------------------------------------------------------------------------*/
 
 /*
-  Checks if an expiry timeout is already scheduled, if so returns.
-  This is becasue events will always be added to the end of the queue.
-  Events are always later in time to previoulsy added events.
-
-  Otherwise calculate the next wake time using the top of the queue
-  and add the next expiry function.
+  Finds the next second with leases ending, and schedules the expiry
+  function for it, unless it is already scheduled for that time or
+  earlier.
 
   This function is called when a lease is added or at the end of the
   expiry function to add the next expiry timeout.
@@ -147,19 +173,27 @@ expiry_func (gpointer data)
 static void
 add_expiry_timeout (SpiLeasing *leasing)
 {
-  ExpiryElement *elem;
   gint64 secs = g_get_monotonic_time () / 1000000;
-  guint next_expiry;
+  gint64 t;
 
-  if (leasing->expiry_func_id != 0)
+  if (g_hash_table_size (leasing->leases) == 0)
     return;
 
-  elem = (ExpiryElement *) g_queue_peek_head (leasing->expiry_queue);
-  if (elem == NULL)
-    return;
+  for (t = secs + 1; t <= secs + WHEEL_SIZE; t++)
+    {
+      if (leasing->wheel[t % WHEEL_SIZE].head)
+        break;
+    }
 
-  next_expiry = elem->expiry_s - secs;
-  leasing->expiry_func_id = spi_timeout_add_seconds (next_expiry,
+  if (leasing->expiry_func_id != 0)
+    {
+      if (leasing->expiry_s <= t)
+        return;
+      g_source_remove (leasing->expiry_func_id);
+    }
+
+  leasing->expiry_s = t;
+  leasing->expiry_func_id = spi_timeout_add_seconds (t - secs,
                                                      expiry_func, leasing);
 }
 
@@ -171,9 +205,25 @@ add_expiry_timeout (SpiLeasing *leasing)
 
   The lease time is going to be rounded up, as the lease time should be
   considered a MINIMUM that the object will be leased for.
+
+  When more than LEASE_PRESSURE_THRESHOLD objects are leased, as happens
+  when bursts of events come from many transient objects, new leases get
+  proportionally shorter, down to LEASE_TIME_MIN_S, so that fewer objects
+  are kept alive at the peak.
 */
 #define LEASE_TIME_S 15
-#define EXPIRY_TIME_S (LEASE_TIME_S + 1)
+#define LEASE_TIME_MIN_S 2
+#define LEASE_PRESSURE_THRESHOLD 1000
+
+static guint
+lease_time (SpiLeasing *leasing)
+{
+  guint n_leases = g_hash_table_size (leasing->leases);
+
+  if (n_leases <= LEASE_PRESSURE_THRESHOLD)
+    return LEASE_TIME_S;
+  return MAX (LEASE_TIME_MIN_S, LEASE_TIME_S * LEASE_PRESSURE_THRESHOLD / n_leases);
+}
 
 GObject *
 spi_leasing_take (SpiLeasing *leasing, GObject *object)
@@ -181,22 +231,35 @@ spi_leasing_take (SpiLeasing *leasing, GObject *object)
   /*
      Get the current time.
      Quantize the time.
-     Add the release event to the queue.
+     Add or extend the lease in the wheel.
      Check the next expiry.
    */
 
   gint64 secs = g_get_monotonic_time () / 1000000;
-  guint expiry_s;
+  gint64 expiry_s;
 
-  ExpiryElement *elem;
+  Lease *lease;
 
-  expiry_s = secs + EXPIRY_TIME_S;
+  expiry_s = secs + lease_time (leasing) + 1;
 
-  elem = g_slice_new (ExpiryElement);
-  elem->expiry_s = expiry_s;
-  elem->object = g_object_ref (object);
+  lease = g_hash_table_lookup (leasing->leases, object);
+  if (lease)
+    {
+      /* Extend the lease, but never shorten it */
+      if (lease->expiry_s >= expiry_s)
+        return object;
+      g_queue_unlink (&leasing->wheel[lease->expiry_s % WHEEL_SIZE], &lease->link);
+    }
+  else
+    {
+      lease = g_slice_new0 (Lease);
+      lease->object = g_object_ref (object);
+      lease->link.data = lease;
+      g_hash_table_insert (leasing->leases, object, lease);
+    }
 
-  g_queue_push_tail (leasing->expiry_queue, elem);
+  lease->expiry_s = expiry_s;
+  g_queue_push_tail_link (&leasing->wheel[expiry_s % WHEEL_SIZE], &lease->link);
 
   add_expiry_timeout (leasing);
 
@@ -208,4 +271,23 @@ spi_leasing_take (SpiLeasing *leasing, GObject *object)
   return object;
 }
 
+guint
+spi_leasing_get_n_leases (SpiLeasing *leasing)
+{
+  return g_hash_table_size (leasing->leases);
+}
+
+/*
+ * Estimates the memory used by the leases in bytes, not counting the leased
+ * objects.
+ */
+gsize
+spi_leasing_get_memory_size (SpiLeasing *leasing)
+{
+  gsize size = sizeof (SpiLeasing) + WHEEL_SIZE * sizeof (GQueue);
+
+  size += g_hash_table_size (leasing->leases) * (sizeof (Lease) + 3 * sizeof (gpointer));
+  return size;
+}
+
 /*END------------------------------------------------------------------------*/
@@ -42,7 +42,10 @@ struct _SpiLeasing
 {
   GObject parent;
 
-  GQueue *expiry_queue;
+  GHashTable *leases;  /* GObject -> lease */
+  GQueue *wheel;       /* Leases, by expiry time in seconds */
+  gint64 wheel_time_s; /* The last second whose leases were ended */
+  gint64 expiry_s;     /* When the expiry function is due to run */
   guint expiry_func_id;
 };
 
@@ -57,5 +60,9 @@ extern SpiLeasing *spi_global_leasing;
 
 GObject *spi_leasing_take (SpiLeasing *leasing, GObject *object);
 
+guint spi_leasing_get_n_leases (SpiLeasing *leasing);
+
+gsize spi_leasing_get_memory_size (SpiLeasing *leasing);
+
 G_END_DECLS
 #endif /* ACCESSIBLE_LEASING_H */
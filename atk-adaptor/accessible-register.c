@@ -37,23 +37,80 @@
  * path for it. The D-Bus object paths used have a standard prefix
  * (SPI_ATK_OBJECT_PATH_PREFIX). Appended to this prefix is a string
  * representation of an integer reference. So to access an AtkObject
- * remotely we keep a Hashtable that maps the given reference to
- * the AtkObject pointer. An object in this hash table is said to be 'registered'.
+ * remotely we keep a table that maps the given reference to
+ * the AtkObject pointer. An object in this table is said to be 'registered'.
+ *
+ * A reference is the index of the object's slot in the table, tagged in its
+ * high bits with the generation of the slot. Slots are reused once their
+ * object is deregistered, oldest freed first, and the generation changes on
+ * every reuse, so that the path of an object that has gone away does not
+ * lead to whatever object is in its slot now. A slot whose generation has
+ * run out is retired rather than reused, since its generation would wrap
+ * around to that of old paths.
  *
  * The architecture of AT-SPI dbus is such that AtkObjects are not
  * remotely reference counted. This means that we need to keep track of
  * object destruction. When an object is destroyed it must be 'deregistered'
  * To do this lookup we keep a dbus-id attribute on each AtkObject.
  *
+ * Cells of tables that manage their descendants are handled differently,
+ * as such tables can have millions of them, usually created on demand by
+ * the toolkit. Rather than being registered (and leased), such a cell gets
+ * a 'virtual' path made of the reference of its table and its row and
+ * column, SPI_ATK_OBJECT_PATH_PREFIX "<table>_<row>_<column>". A bounded
+ * pool keeps the most recently used cells alive; a cell that has been
+ * dropped from it is simply asked for again from its table when its path
+ * is used, so the path stays valid for as long as the position exists.
+ *
+ * The path of a registered object or pooled cell is rendered once, and
+ * kept with it, so that marshalling references to it does not need to
+ * allocate a string each time.
+ *
  */
 
 #define SPI_ATK_PATH_PREFIX_LENGTH 27
 #define SPI_ATK_OBJECT_PATH_PREFIX "/org/a11y/atspi/accessible/"
 #define SPI_ATK_OBJECT_PATH_ROOT "root"
 
-#define SPI_ATK_OBJECT_REFERENCE_TEMPLATE SPI_ATK_OBJECT_PATH_PREFIX "%d"
+#define SPI_ATK_OBJECT_REFERENCE_TEMPLATE SPI_ATK_OBJECT_PATH_PREFIX "%u"
 
 #define SPI_DBUS_ID "spi-dbus-id"
+#define SPI_DBUS_PATH "spi-dbus-path"
+
+#define SPI_ATK_VIRTUAL_CELL_TEMPLATE SPI_ATK_OBJECT_PATH_PREFIX "%u_%d_%d"
+
+#define SPI_VIRTUAL_CELL "spi-virtual-cell"
+
+/* References are made of a slot index and a generation */
+#define REF_INDEX_BITS 22
+#define REF_INDEX_MASK ((1u << REF_INDEX_BITS) - 1)
+#define REF_GENERATION_MASK ((1u << (32 - REF_INDEX_BITS)) - 1)
+
+/*
+ * The number of freed slots that are kept unused, so that a slot is not
+ * handed out again right after its object went away
+ */
+#define FREE_SLOT_RESERVE 1024
+
+struct _SpiRegisterSlot
+{
+  GObject *object;   /* NULL if the slot is free */
+  guint generation;
+  guint next_free;   /* The next slot in the free list, or 0 */
+};
+
+/* The number of virtual cells kept alive at any time */
+#define VIRTUAL_CELL_POOL_SIZE 256
+
+typedef struct _VirtualCell
+{
+  guint table_ref;
+  gint row;
+  gint column;
+  GObject *cell;
+  gchar *path;
+  GList link; /* In the most recently used first queue */
+} VirtualCell;
 
 SpiRegister *spi_global_register = NULL;
 
@@ -67,6 +124,10 @@ enum
 };
 static guint register_signals[LAST_SIGNAL] = { 0 };
 
+static GQuark quark_dbus_id;
+static GQuark quark_dbus_path;
+static GQuark quark_virtual_cell;
+
 /*---------------------------------------------------------------------------*/
 
 static void
@@ -85,6 +146,10 @@ spi_register_class_init (SpiRegisterClass *klass)
 
   object_class->finalize = spi_register_finalize;
 
+  quark_dbus_id = g_quark_from_static_string (SPI_DBUS_ID);
+  quark_dbus_path = g_quark_from_static_string (SPI_DBUS_PATH);
+  quark_virtual_cell = g_quark_from_static_string (SPI_VIRTUAL_CELL);
+
   register_signals[OBJECT_REGISTERED] =
       g_signal_new ("object-registered",
                     SPI_REGISTER_TYPE,
@@ -110,13 +175,38 @@ spi_register_class_init (SpiRegisterClass *klass)
                     G_TYPE_OBJECT);
 }
 
+static guint
+virtual_cell_hash (gconstpointer key)
+{
+  const VirtualCell *vc = key;
+
+  return (vc->table_ref * 31 + vc->row) * 31 + vc->column;
+}
+
+static gboolean
+virtual_cell_equal (gconstpointer a, gconstpointer b)
+{
+  const VirtualCell *vc_a = a, *vc_b = b;
+
+  return (vc_a->table_ref == vc_b->table_ref &&
+          vc_a->row == vc_b->row &&
+          vc_a->column == vc_b->column);
+}
+
 static void
 spi_register_init (SpiRegister *reg)
 {
-  reg->ref2ptr = g_hash_table_new (g_direct_hash, g_direct_equal);
-  reg->reference_counter = 0;
+  reg->slots = g_array_new (FALSE, TRUE, sizeof (SpiRegisterSlot));
+  /* Slot 0 is never used, so that no reference is 0 */
+  g_array_set_size (reg->slots, 1);
+  reg->free_head = reg->free_tail = 0;
+  reg->n_free = 0;
+  reg->virtual_cells = g_hash_table_new (virtual_cell_hash, virtual_cell_equal);
+  g_queue_init (&reg->virtual_cell_lru);
 }
 
+static void remove_virtual_cell (SpiRegister *reg, VirtualCell *vc);
+
 static void
 deregister_object (gpointer data, GObject *gobj)
 {
@@ -125,19 +215,24 @@ deregister_object (gpointer data, GObject *gobj)
   spi_register_deregister_object (reg, gobj, FALSE);
 }
 
-static void
-spi_register_remove_weak_ref (gpointer key, gpointer val, gpointer reg)
-{
-  g_object_weak_unref (val, deregister_object, reg);
-}
-
 static void
 spi_register_finalize (GObject *object)
 {
   SpiRegister *reg = SPI_REGISTER (object);
+  guint i;
+
+  for (i = 1; i < reg->slots->len; i++)
+    {
+      SpiRegisterSlot *slot = &g_array_index (reg->slots, SpiRegisterSlot, i);
 
-  g_hash_table_foreach (reg->ref2ptr, spi_register_remove_weak_ref, reg);
-  g_hash_table_unref (reg->ref2ptr);
+      if (slot->object)
+        g_object_weak_unref (slot->object, deregister_object, reg);
+    }
+  g_array_unref (reg->slots);
+
+  while (reg->virtual_cell_lru.head)
+    remove_virtual_cell (reg, reg->virtual_cell_lru.head->data);
+  g_hash_table_unref (reg->virtual_cells);
 
   G_OBJECT_CLASS (spi_register_parent_class)->finalize (object);
 }
@@ -148,38 +243,89 @@ spi_register_finalize (GObject *object)
  * Each AtkObject must be asssigned a D-Bus path (Reference)
  *
  * This function provides an integer reference for a new
- * AtkObject.
- *
- * TODO: Make this reference a little more unique, this is shoddy.
+ * AtkObject, or 0 if the table is full.
  */
 static guint
-assign_reference (SpiRegister *reg)
+assign_reference (SpiRegister *reg, GObject *gobj)
 {
-  reg->reference_counter++;
-  /* Reference of 0 not allowed as used as direct key in hash table */
-  if (reg->reference_counter == 0)
-    reg->reference_counter++;
-  return reg->reference_counter;
+  SpiRegisterSlot *slot;
+  guint index;
+
+  if (reg->free_head &&
+      (reg->n_free > FREE_SLOT_RESERVE || reg->slots->len > REF_INDEX_MASK))
+    {
+      index = reg->free_head;
+      slot = &g_array_index (reg->slots, SpiRegisterSlot, index);
+      reg->free_head = slot->next_free;
+      if (!reg->free_head)
+        reg->free_tail = 0;
+      reg->n_free--;
+    }
+  else if (reg->slots->len <= REF_INDEX_MASK)
+    {
+      index = reg->slots->len;
+      g_array_set_size (reg->slots, index + 1);
+      slot = &g_array_index (reg->slots, SpiRegisterSlot, index);
+    }
+  else
+    return 0;
+
+  slot->object = gobj;
+  slot->next_free = 0;
+  return (slot->generation << REF_INDEX_BITS) | index;
 }
 
-/*---------------------------------------------------------------------------*/
+/*
+ * Frees the slot of a reference, appending it to the free list unless it
+ * has had all its generations.
+ */
+static void
+release_reference (SpiRegister *reg, guint ref)
+{
+  guint index = ref & REF_INDEX_MASK;
+  SpiRegisterSlot *slot = &g_array_index (reg->slots, SpiRegisterSlot, index);
+
+  slot->object = NULL;
+  slot->next_free = 0;
+  if (slot->generation == REF_GENERATION_MASK)
+    return;
+  slot->generation++;
+
+  if (reg->free_tail)
+    g_array_index (reg->slots, SpiRegisterSlot, reg->free_tail).next_free = index;
+  else
+    reg->free_head = index;
+  reg->free_tail = index;
+  reg->n_free++;
+}
 
 /*
- * Returns the reference of the object, or 0 if it is not registered.
+ * Returns the object with a reference, or NULL if there is none.
  */
-static guint
-object_to_ref (GObject *gobj)
+static GObject *
+ref_to_object (SpiRegister *reg, guint ref)
 {
-  return GPOINTER_TO_INT (g_object_get_data (gobj, SPI_DBUS_ID));
+  guint index = ref & REF_INDEX_MASK;
+  SpiRegisterSlot *slot;
+
+  if (index == 0 || index >= reg->slots->len)
+    return NULL;
+
+  slot = &g_array_index (reg->slots, SpiRegisterSlot, index);
+  if (slot->generation != ref >> REF_INDEX_BITS)
+    return NULL;
+  return slot->object;
 }
 
+/*---------------------------------------------------------------------------*/
+
 /*
- * Converts the Accessible object reference to its D-Bus object path
+ * Returns the reference of the object, or 0 if it is not registered.
  */
-static gchar *
-ref_to_path (guint ref)
+static guint
+object_to_ref (GObject *gobj)
 {
-  return g_strdup_printf (SPI_ATK_OBJECT_REFERENCE_TEMPLATE, ref);
+  return GPOINTER_TO_UINT (g_object_get_qdata (gobj, quark_dbus_id));
 }
 
 /*---------------------------------------------------------------------------*/
@@ -196,7 +342,7 @@ spi_register_deregister_object (SpiRegister *reg, GObject *gobj, gboolean unref)
   guint ref;
 
   ref = object_to_ref (gobj);
-  if (ref != 0)
+  if (ref != 0 && ref_to_object (reg, ref) == gobj)
     {
       g_signal_emit (reg,
                      register_signals[OBJECT_DEREGISTERED],
@@ -204,10 +350,10 @@ spi_register_deregister_object (SpiRegister *reg, GObject *gobj, gboolean unref)
                      gobj);
       if (unref)
         g_object_weak_unref (gobj, deregister_object, reg);
-      g_hash_table_remove (reg->ref2ptr, GINT_TO_POINTER (ref));
+      release_reference (reg, ref);
 
 #ifdef SPI_ATK_DEBUG
-      g_debug ("DEREG  - %d", ref);
+      g_debug ("DEREG  - %u", ref);
 #endif
     }
 }
@@ -218,14 +364,21 @@ register_object (SpiRegister *reg, GObject *gobj)
   guint ref;
   g_return_if_fail (G_IS_OBJECT (gobj));
 
-  ref = assign_reference (reg);
+  ref = assign_reference (reg, gobj);
+  if (!ref)
+    {
+      g_warning ("atk-bridge: too many accessible objects to register another one");
+      return;
+    }
 
-  g_hash_table_insert (reg->ref2ptr, GINT_TO_POINTER (ref), gobj);
-  g_object_set_data (G_OBJECT (gobj), SPI_DBUS_ID, GINT_TO_POINTER (ref));
+  g_object_set_qdata (gobj, quark_dbus_id, GUINT_TO_POINTER (ref));
+  g_object_set_qdata_full (gobj, quark_dbus_path,
+                           g_strdup_printf (SPI_ATK_OBJECT_REFERENCE_TEMPLATE, ref),
+                           g_free);
   g_object_weak_ref (G_OBJECT (gobj), deregister_object, reg);
 
 #ifdef SPI_ATK_DEBUG
-  g_debug ("REG  - %d", ref);
+  g_debug ("REG  - %u", ref);
 #endif
 
   g_signal_emit (reg, register_signals[OBJECT_REGISTERED], 0, gobj);
@@ -233,6 +386,226 @@ register_object (SpiRegister *reg, GObject *gobj)
 
 /*---------------------------------------------------------------------------*/
 
+static void
+remove_virtual_cell (SpiRegister *reg, VirtualCell *vc)
+{
+  g_hash_table_remove (reg->virtual_cells, vc);
+  g_queue_unlink (&reg->virtual_cell_lru, &vc->link);
+  g_object_set_qdata (vc->cell, quark_virtual_cell, NULL);
+  g_object_unref (vc->cell);
+  g_free (vc->path);
+  g_free (vc);
+}
+
+static VirtualCell *
+add_virtual_cell (SpiRegister *reg, GObject *gobj, guint table_ref, gint row, gint column)
+{
+  VirtualCell *vc;
+
+  vc = g_new0 (VirtualCell, 1);
+  vc->table_ref = table_ref;
+  vc->row = row;
+  vc->column = column;
+  vc->cell = g_object_ref (gobj);
+  vc->path = g_strdup_printf (SPI_ATK_VIRTUAL_CELL_TEMPLATE, table_ref, row, column);
+  vc->link.data = vc;
+
+  g_hash_table_insert (reg->virtual_cells, vc, vc);
+  g_queue_push_head_link (&reg->virtual_cell_lru, &vc->link);
+  g_object_set_qdata (gobj, quark_virtual_cell, vc);
+
+  while (reg->virtual_cell_lru.length > VIRTUAL_CELL_POOL_SIZE)
+    remove_virtual_cell (reg, reg->virtual_cell_lru.tail->data);
+
+  return vc;
+}
+
+/* Marks a pooled cell as the most recently used one */
+static void
+touch_virtual_cell (SpiRegister *reg, VirtualCell *vc)
+{
+  g_queue_unlink (&reg->virtual_cell_lru, &vc->link);
+  g_queue_push_head_link (&reg->virtual_cell_lru, &vc->link);
+}
+
+static gboolean
+table_manages_descendants (AtkObject *table)
+{
+  AtkStateSet *set;
+  gboolean ret;
+
+  set = atk_object_ref_state_set (table);
+  if (!set)
+    return FALSE;
+  ret = atk_state_set_contains_state (set, ATK_STATE_MANAGES_DESCENDANTS);
+  g_object_unref (set);
+  return ret;
+}
+
+/*
+ * Checks whether an object that is not registered yet should be given a
+ * virtual path, and if so, adds it to the pool.
+ */
+static VirtualCell *
+try_add_virtual_cell (SpiRegister *reg, GObject *gobj)
+{
+  AtkObject *table;
+  VirtualCell *vc = NULL;
+  gint row, column;
+  guint table_ref;
+
+  if (!ATK_IS_TABLE_CELL (gobj))
+    return NULL;
+
+  table = atk_table_cell_get_table (ATK_TABLE_CELL (gobj));
+  if (!table)
+    return NULL;
+
+  if (ATK_IS_TABLE (table) &&
+      (void *) table != (void *) spi_global_app_data->root &&
+      table_manages_descendants (table) &&
+      atk_table_cell_get_position (ATK_TABLE_CELL (gobj), &row, &column) &&
+      row >= 0 && column >= 0)
+    {
+      table_ref = object_to_ref (G_OBJECT (table));
+      if (!table_ref)
+        {
+          register_object (reg, G_OBJECT (table));
+          table_ref = object_to_ref (G_OBJECT (table));
+        }
+      if (table_ref)
+        vc = add_virtual_cell (reg, gobj, table_ref, row, column);
+    }
+
+  g_object_unref (table);
+  return vc;
+}
+
+/*
+ * Re-keys a pooled cell under its current position if it has moved since
+ * it was given its path, as rows can be inserted, removed or reordered
+ * under the cells of a table. Returns FALSE if the cell has no position
+ * any more, in which case it cannot keep a virtual path.
+ */
+static gboolean
+update_virtual_cell (SpiRegister *reg, VirtualCell *vc)
+{
+  VirtualCell *other;
+  gint row, column;
+
+  if (!ATK_IS_TABLE_CELL (vc->cell))
+    return TRUE;
+  if (!atk_table_cell_get_position (ATK_TABLE_CELL (vc->cell), &row, &column) ||
+      row < 0 || column < 0)
+    return FALSE;
+  if (row == vc->row && column == vc->column)
+    return TRUE;
+
+  g_hash_table_remove (reg->virtual_cells, vc);
+  vc->row = row;
+  vc->column = column;
+  /* Whatever was pooled at the new position has moved away from it */
+  other = g_hash_table_lookup (reg->virtual_cells, vc);
+  if (other)
+    remove_virtual_cell (reg, other);
+  g_free (vc->path);
+  vc->path = g_strdup_printf (SPI_ATK_VIRTUAL_CELL_TEMPLATE, vc->table_ref, row, column);
+  g_hash_table_insert (reg->virtual_cells, vc, vc);
+  return TRUE;
+}
+
+/*
+ * Looks up the cell for a virtual path, asking the table for it if it is
+ * not in the pool any more, or if the cell in the pool has moved.
+ */
+static GObject *
+virtual_cell_path_to_object (SpiRegister *reg, guint table_ref, gint row, gint column)
+{
+  VirtualCell key, *vc;
+  GObject *table;
+  AtkObject *cell;
+
+  key.table_ref = table_ref;
+  key.row = row;
+  key.column = column;
+  vc = g_hash_table_lookup (reg->virtual_cells, &key);
+  if (vc)
+    {
+      if (!update_virtual_cell (reg, vc))
+        remove_virtual_cell (reg, vc);
+      else if (vc->row == row && vc->column == column)
+        {
+          touch_virtual_cell (reg, vc);
+          return vc->cell;
+        }
+    }
+
+  table = ref_to_object (reg, table_ref);
+  if (!table || !ATK_IS_TABLE (table))
+    return NULL;
+
+  cell = atk_table_ref_at (ATK_TABLE (table), row, column);
+  if (!cell)
+    return NULL;
+
+  /* The cell may already be known under another path */
+  vc = g_object_get_qdata (G_OBJECT (cell), quark_virtual_cell);
+  if (vc)
+    remove_virtual_cell (reg, vc);
+  if (object_to_ref (G_OBJECT (cell)))
+    {
+      g_object_unref (cell);
+      return G_OBJECT (cell);
+    }
+
+  vc = add_virtual_cell (reg, G_OBJECT (cell), table_ref, row, column);
+  g_object_unref (cell);
+  return vc->cell;
+}
+
+/*
+ * Returns TRUE if the object has a virtual path, marking it as recently
+ * used. Such objects are kept alive by the register and need no lease.
+ */
+gboolean
+spi_register_object_is_virtual (SpiRegister *reg, GObject *gobj)
+{
+  VirtualCell *vc = g_object_get_qdata (gobj, quark_virtual_cell);
+
+  if (!vc)
+    return FALSE;
+  touch_virtual_cell (reg, vc);
+  return TRUE;
+}
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * Reads a decimal number from *str, advancing it past the digits. Returns
+ * FALSE if there are none, or too many to be a reference or position.
+ */
+static gboolean
+read_number (const char **str, guint *number)
+{
+  const char *p = *str;
+  guint n = 0;
+
+  if (*p < '0' || *p > '9')
+    return FALSE;
+  do
+    {
+      if (n > (G_MAXUINT - (*p - '0')) / 10)
+        return FALSE;
+      n = n * 10 + (*p - '0');
+      p++;
+    }
+  while (*p >= '0' && *p <= '9');
+
+  *str = p;
+  *number = n;
+  return TRUE;
+}
+
 /*
  * Used to lookup an GObject from its D-Bus path.
  *
@@ -241,8 +614,7 @@ register_object (SpiRegister *reg, GObject *gobj)
 GObject *
 spi_register_path_to_object (SpiRegister *reg, const char *path)
 {
-  guint index;
-  void *data;
+  guint index, row, column;
 
   g_return_val_if_fail (path, NULL);
 
@@ -252,15 +624,23 @@ spi_register_path_to_object (SpiRegister *reg, const char *path)
   path += SPI_ATK_PATH_PREFIX_LENGTH; /* Skip over the prefix */
 
   /* Map the root path to the root object. */
-  if (!g_strcmp0 (SPI_ATK_OBJECT_PATH_ROOT, path))
-    return G_OBJECT (spi_global_app_data->root);
+  if (*path == 'r')
+    return g_strcmp0 (SPI_ATK_OBJECT_PATH_ROOT, path) ? NULL : G_OBJECT (spi_global_app_data->root);
 
-  index = atoi (path);
-  data = g_hash_table_lookup (reg->ref2ptr, GINT_TO_POINTER (index));
-  if (data)
-    return G_OBJECT (data);
-  else
+  if (!read_number (&path, &index))
     return NULL;
+
+  if (*path == '_')
+    {
+      path++;
+      if (!read_number (&path, &row) || *path++ != '_' ||
+          !read_number (&path, &column) || *path != '\0' ||
+          row > G_MAXINT || column > G_MAXINT)
+        return NULL;
+      return virtual_cell_path_to_object (reg, index, row, column);
+    }
+
+  return ref_to_object (reg, index);
 }
 
 GObject *
@@ -274,30 +654,52 @@ spi_global_register_path_to_object (const char *path)
  *
  * If the objects is not already registered,
  * this function will register it.
+ *
+ * The path belongs to the register. It stays valid for as long as the
+ * object is registered, or, for a table cell with a virtual path, until the
+ * register is next asked for a path, so it should be used straight away.
+ * The caller must hold a reference to the object, as a cell that has lost
+ * its position is dropped from the pool of virtual cells.
  */
-gchar *
-spi_register_object_to_path (SpiRegister *reg, GObject *gobj)
+const gchar *
+spi_register_peek_object_path (SpiRegister *reg, GObject *gobj)
 {
-  guint ref;
-
   if (gobj == NULL)
     return NULL;
 
   /* Map the root object to the root path. */
   if ((void *) gobj == (void *) spi_global_app_data->root)
-    return g_strdup (spi_register_root_path);
+    return spi_register_root_path;
 
-  ref = object_to_ref (gobj);
-  if (!ref)
+  if (!object_to_ref (gobj))
     {
+      VirtualCell *vc = g_object_get_qdata (gobj, quark_virtual_cell);
+
+      /* The cell may have moved since it was given its path */
+      if (vc && !update_virtual_cell (reg, vc))
+        {
+          remove_virtual_cell (reg, vc);
+          vc = NULL;
+        }
+      if (!vc)
+        vc = try_add_virtual_cell (reg, gobj);
+      if (vc)
+        return vc->path;
+
       register_object (reg, gobj);
-      ref = object_to_ref (gobj);
     }
 
-  if (!ref)
-    return NULL;
-  else
-    return ref_to_path (ref);
+  return g_object_get_qdata (gobj, quark_dbus_path);
+}
+
+/*
+ * Like spi_register_peek_object_path, but returns a newly allocated copy
+ * of the path.
+ */
+gchar *
+spi_register_object_to_path (SpiRegister *reg, GObject *gobj)
+{
+  return g_strdup (spi_register_peek_object_path (reg, gobj));
 }
 
 guint
@@ -306,6 +708,38 @@ spi_register_object_to_ref (GObject *gobj)
   return object_to_ref (gobj);
 }
 
+/*
+ * Returns the number of registered objects, not counting virtual cells.
+ */
+guint
+spi_register_get_n_objects (SpiRegister *reg)
+{
+  return reg->slots->len - 1 - reg->n_free;
+}
+
+guint
+spi_register_get_n_virtual_cells (SpiRegister *reg)
+{
+  return g_hash_table_size (reg->virtual_cells);
+}
+
+/*
+ * Estimates the memory used by the register in bytes: its table, the
+ * rendered paths and the pool of virtual cells, but not the objects.
+ */
+gsize
+spi_register_get_memory_size (SpiRegister *reg)
+{
+  gsize size = sizeof (SpiRegister);
+  guint n_cells = g_hash_table_size (reg->virtual_cells);
+
+  size += reg->slots->len * sizeof (SpiRegisterSlot);
+  size += spi_register_get_n_objects (reg) * (SPI_ATK_PATH_PREFIX_LENGTH + 8);
+  size += n_cells * (sizeof (VirtualCell) + 3 * sizeof (gpointer));
+  size += n_cells * (SPI_ATK_PATH_PREFIX_LENGTH + 24);
+  return size;
+}
+
 /*
  * Gets the path that indicates the accessible desktop object.
  * This object is logically located on the registry daemon and not
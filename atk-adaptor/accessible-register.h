@@ -29,6 +29,7 @@
 
 typedef struct _SpiRegister SpiRegister;
 typedef struct _SpiRegisterClass SpiRegisterClass;
+typedef struct _SpiRegisterSlot SpiRegisterSlot;
 
 G_BEGIN_DECLS
 
@@ -42,8 +43,13 @@ struct _SpiRegister
 {
   GObject parent;
 
-  GHashTable *ref2ptr;
-  guint reference_counter;
+  GArray *slots; /* of SpiRegisterSlot, indexed by reference */
+  guint free_head;
+  guint free_tail;
+  guint n_free;
+
+  GHashTable *virtual_cells;
+  GQueue virtual_cell_lru;
 };
 
 struct _SpiRegisterClass
@@ -63,6 +69,9 @@ spi_register_path_to_object (SpiRegister *reg, const char *path);
 GObject *
 spi_global_register_path_to_object (const char *path);
 
+const gchar *
+spi_register_peek_object_path (SpiRegister *reg, GObject *gobj);
+
 gchar *
 spi_register_object_to_path (SpiRegister *reg, GObject *gobj);
 
@@ -75,6 +84,18 @@ spi_register_root_object_path ();
 void
 spi_register_deregister_object (SpiRegister *reg, GObject *gobj, gboolean unref);
 
+gboolean
+spi_register_object_is_virtual (SpiRegister *reg, GObject *gobj);
+
+guint
+spi_register_get_n_objects (SpiRegister *reg);
+
+guint
+spi_register_get_n_virtual_cells (SpiRegister *reg);
+
+gsize
+spi_register_get_memory_size (SpiRegister *reg);
+
 /*---------------------------------------------------------------------------*/
 
 #endif /* ACCESSIBLE_REGISTER_H */
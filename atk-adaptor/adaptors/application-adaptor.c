@@ -30,6 +30,13 @@
 
 /* for spi_global_app_data  is there a better way? */
 #include "../bridge.h"
+#include "accessible-cache.h"
+#include "accessible-leasing.h"
+#include "accessible-register.h"
+#include "event.h"
+
+/* When the application interface was set up, for GetStatistics */
+static gint64 start_time_us;
 
 static dbus_bool_t
 impl_get_ToolkitName (DBusMessageIter *iter, void *user_data)
@@ -107,11 +114,181 @@ impl_get_app_bus (DBusConnection *bus, DBusMessage *msg, void *data)
   return reply;
 }
 
+static DBusMessage *
+impl_GetExtentsBatch (DBusConnection *bus, DBusMessage *message, void *user_data)
+{
+  char **paths = NULL;
+  int n_paths = 0;
+  dbus_uint32_t coord_type;
+  DBusMessage *reply;
+  DBusMessageIter iter, iter_array, iter_struct;
+  int i;
+
+  if (!dbus_message_get_args (message, NULL, DBUS_TYPE_ARRAY,
+                              DBUS_TYPE_OBJECT_PATH, &paths, &n_paths,
+                              DBUS_TYPE_UINT32, &coord_type, DBUS_TYPE_INVALID))
+    return droute_invalid_arguments_error (message);
+
+  reply = dbus_message_new_method_return (message);
+  if (!reply)
+    {
+      dbus_free_string_array (paths);
+      return NULL;
+    }
+
+  dbus_message_iter_init_append (reply, &iter);
+  dbus_message_iter_open_container (&iter, DBUS_TYPE_ARRAY, "(iiii)", &iter_array);
+  for (i = 0; i < n_paths; i++)
+    {
+      GObject *obj = spi_global_register_path_to_object (paths[i]);
+      gint ix = -1, iy = -1, iw = -1, ih = -1;
+      dbus_int32_t x, y, width, height;
+
+      if (obj && ATK_IS_COMPONENT (obj))
+        atk_component_get_extents (ATK_COMPONENT (obj), &ix, &iy, &iw, &ih,
+                                   (AtkCoordType) coord_type);
+      x = ix;
+      y = iy;
+      width = iw;
+      height = ih;
+      dbus_message_iter_open_container (&iter_array, DBUS_TYPE_STRUCT, NULL,
+                                        &iter_struct);
+      dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_INT32, &x);
+      dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_INT32, &y);
+      dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_INT32, &width);
+      dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_INT32, &height);
+      dbus_message_iter_close_container (&iter_array, &iter_struct);
+    }
+  dbus_message_iter_close_container (&iter, &iter_array);
+
+  dbus_free_string_array (paths);
+  return reply;
+}
+
+static void
+append_uint64_entry (DBusMessageIter *iter, const char *name, dbus_uint64_t val)
+{
+  DBusMessageIter iter_entry, iter_variant;
+
+  dbus_message_iter_open_container (iter, DBUS_TYPE_DICT_ENTRY, NULL, &iter_entry);
+  dbus_message_iter_append_basic (&iter_entry, DBUS_TYPE_STRING, &name);
+  dbus_message_iter_open_container (&iter_entry, DBUS_TYPE_VARIANT, "t", &iter_variant);
+  dbus_message_iter_append_basic (&iter_variant, DBUS_TYPE_UINT64, &val);
+  dbus_message_iter_close_container (&iter_entry, &iter_variant);
+  dbus_message_iter_close_container (iter, &iter_entry);
+}
+
+typedef struct
+{
+  dbus_uint64_t calls;
+  dbus_uint64_t time_us;
+} InterfaceCalls;
+
+/* Sums the calls to each interface over all the paths that implement it */
+static void
+add_interface_calls (const char *iface, guint64 calls, guint64 time_us, void *user_data)
+{
+  GHashTable *totals = user_data;
+  InterfaceCalls *total = g_hash_table_lookup (totals, iface);
+
+  if (!total)
+    {
+      total = g_new0 (InterfaceCalls, 1);
+      g_hash_table_insert (totals, (gpointer) iface, total);
+    }
+  total->calls += calls;
+  total->time_us += time_us;
+}
+
+static void
+append_interface_calls (DBusMessageIter *iter)
+{
+  GHashTable *totals = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, g_free);
+  DBusMessageIter iter_entry, iter_variant, iter_array, iter_calls, iter_struct;
+  const char *name = "InterfaceCalls";
+  GHashTableIter iter_totals;
+  gpointer key, value;
+
+  droute_context_foreach_interface_stats (spi_global_app_data->droute,
+                                          add_interface_calls, totals);
+
+  dbus_message_iter_open_container (iter, DBUS_TYPE_DICT_ENTRY, NULL, &iter_entry);
+  dbus_message_iter_append_basic (&iter_entry, DBUS_TYPE_STRING, &name);
+  dbus_message_iter_open_container (&iter_entry, DBUS_TYPE_VARIANT, "a{s(tt)}", &iter_variant);
+  dbus_message_iter_open_container (&iter_variant, DBUS_TYPE_ARRAY, "{s(tt)}", &iter_array);
+  g_hash_table_iter_init (&iter_totals, totals);
+  while (g_hash_table_iter_next (&iter_totals, &key, &value))
+    {
+      InterfaceCalls *total = value;
+
+      dbus_message_iter_open_container (&iter_array, DBUS_TYPE_DICT_ENTRY, NULL, &iter_calls);
+      dbus_message_iter_append_basic (&iter_calls, DBUS_TYPE_STRING, &key);
+      dbus_message_iter_open_container (&iter_calls, DBUS_TYPE_STRUCT, NULL, &iter_struct);
+      dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_UINT64, &total->calls);
+      dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_UINT64, &total->time_us);
+      dbus_message_iter_close_container (&iter_calls, &iter_struct);
+      dbus_message_iter_close_container (&iter_array, &iter_calls);
+    }
+  dbus_message_iter_close_container (&iter_variant, &iter_array);
+  dbus_message_iter_close_container (&iter_entry, &iter_variant);
+  dbus_message_iter_close_container (iter, &iter_entry);
+
+  g_hash_table_unref (totals);
+}
+
+static DBusMessage *
+impl_GetStatistics (DBusConnection *bus, DBusMessage *message, void *user_data)
+{
+  DBusMessage *reply;
+  DBusMessageIter iter, iter_dict;
+  guint64 emitted, suppressed;
+
+  reply = dbus_message_new_method_return (message);
+  if (!reply)
+    return NULL;
+
+  spi_event_get_counts (&emitted, &suppressed);
+
+  dbus_message_iter_init_append (reply, &iter);
+  dbus_message_iter_open_container (&iter, DBUS_TYPE_ARRAY, "{sv}", &iter_dict);
+  append_uint64_entry (&iter_dict, "UptimeMs",
+                       (g_get_monotonic_time () - start_time_us) / 1000);
+  append_uint64_entry (&iter_dict, "RegisteredObjects",
+                       spi_register_get_n_objects (spi_global_register));
+  append_uint64_entry (&iter_dict, "VirtualCells",
+                       spi_register_get_n_virtual_cells (spi_global_register));
+  append_uint64_entry (&iter_dict, "RegisterBytes",
+                       spi_register_get_memory_size (spi_global_register));
+  if (spi_global_cache)
+    {
+      append_uint64_entry (&iter_dict, "CachedObjects",
+                           spi_cache_get_n_objects (spi_global_cache));
+      append_uint64_entry (&iter_dict, "CacheBytes",
+                           spi_cache_get_memory_size (spi_global_cache));
+    }
+  append_uint64_entry (&iter_dict, "LeasedObjects",
+                       spi_leasing_get_n_leases (spi_global_leasing));
+  append_uint64_entry (&iter_dict, "LeasingBytes",
+                       spi_leasing_get_memory_size (spi_global_leasing));
+  append_uint64_entry (&iter_dict, "EventListeners",
+                       g_list_length (spi_global_app_data->events));
+  append_uint64_entry (&iter_dict, "EventListenerBytes",
+                       spi_event_get_listeners_memory_size ());
+  append_uint64_entry (&iter_dict, "EventsEmitted", emitted);
+  append_uint64_entry (&iter_dict, "EventsSuppressed", suppressed);
+  append_interface_calls (&iter_dict);
+  dbus_message_iter_close_container (&iter, &iter_dict);
+
+  return reply;
+}
+
 static DRouteMethod methods[] = {
   { impl_registerToolkitEventListener, "registerToolkitEventListener" },
   { impl_registerObjectEventListener, "registerObjectEventListener" },
   { impl_GetLocale, "GetLocale" },
   { impl_get_app_bus, "GetApplicationBusAddress" },
+  { impl_GetExtentsBatch, "GetExtentsBatch" },
+  { impl_GetStatistics, "GetStatistics" },
   { NULL, NULL }
 };
 
@@ -133,6 +310,7 @@ obj_is_root (const char *path, void *user_data)
 void
 spi_initialize_application (DRoutePath *path)
 {
+  start_time_us = g_get_monotonic_time ();
   droute_path_add_interface (path,
                              ATSPI_DBUS_INTERFACE_APPLICATION,
                              spi_org_a11y_atspi_Application,
@@ -32,6 +32,7 @@
 
 #include "introspection.h"
 #include "object.h"
+#include "spatial-index.h"
 
 static DBusMessage *
 impl_Contains (DBusConnection *bus, DBusMessage *message, void *user_data)
@@ -78,9 +79,12 @@ impl_GetAccessibleAtPoint (DBusConnection *bus, DBusMessage *message, void *user
     {
       return droute_invalid_arguments_error (message);
     }
-  child =
-      atk_component_ref_accessible_at_point (component, x, y,
-                                             (AtkCoordType) coord_type);
+  if (!spi_spatial_index_ref_accessible_at_point (component, x, y,
+                                                  (AtkCoordType) coord_type,
+                                                  &child))
+    child =
+        atk_component_ref_accessible_at_point (component, x, y,
+                                               (AtkCoordType) coord_type);
   reply = spi_object_return_reference (message, child);
   if (child)
     g_object_unref (child);
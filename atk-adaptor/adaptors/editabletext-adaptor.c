@@ -22,11 +22,14 @@
  * Boston, MA 02110-1301, USA.
  */
 
+#include <string.h>
+
 #include "bridge.h"
 #include "introspection.h"
 #include <atk/atk.h>
 #include <droute/droute.h>
 
+#include "event.h"
 #include "spi-dbus.h"
 
 static DBusMessage *
@@ -182,6 +185,147 @@ impl_PasteText (DBusConnection *bus, DBusMessage *message, void *user_data)
   return reply;
 }
 
+typedef struct
+{
+  dbus_int32_t type;
+  dbus_int32_t start;
+  dbus_int32_t end;
+  const char *text;
+} TextEdit;
+
+/*
+ * Checks a batch of edits against the current text, keeping track of its
+ * length as each edit would change it. The length of what a paste inserts
+ * can't be known in advance, so a batch that uses offsets after a paste is
+ * rejected, as is one that uses offsets on an object without AtkText.
+ */
+static gboolean
+text_edits_are_valid (AtkEditableText *editable, GArray *edits)
+{
+  gint length = -1;
+  guint i;
+
+  if (ATK_IS_TEXT (editable))
+    length = atk_text_get_character_count (ATK_TEXT (editable));
+
+  for (i = 0; i < edits->len; i++)
+    {
+      TextEdit *edit = &g_array_index (edits, TextEdit, i);
+
+      switch (edit->type)
+        {
+        case ATSPI_TEXT_EDIT_SET_CONTENTS:
+          length = g_utf8_strlen (edit->text, -1);
+          break;
+        case ATSPI_TEXT_EDIT_INSERT:
+          if (length < 0 || edit->start < 0 || edit->start > length)
+            return FALSE;
+          length += g_utf8_strlen (edit->text, -1);
+          break;
+        case ATSPI_TEXT_EDIT_DELETE:
+        case ATSPI_TEXT_EDIT_CUT:
+        case ATSPI_TEXT_EDIT_COPY:
+          if (length < 0 || edit->start < 0 || edit->end < edit->start ||
+              edit->end > length)
+            return FALSE;
+          if (edit->type != ATSPI_TEXT_EDIT_COPY)
+            length -= edit->end - edit->start;
+          break;
+        case ATSPI_TEXT_EDIT_PASTE:
+          if (length < 0 || edit->start < 0 || edit->start > length)
+            return FALSE;
+          length = -1;
+          break;
+        default:
+          return FALSE;
+        }
+    }
+  return TRUE;
+}
+
+static void
+apply_text_edit (AtkEditableText *editable, TextEdit *edit)
+{
+  gint ip;
+
+  switch (edit->type)
+    {
+    case ATSPI_TEXT_EDIT_SET_CONTENTS:
+      atk_editable_text_set_text_contents (editable, edit->text);
+      break;
+    case ATSPI_TEXT_EDIT_INSERT:
+      ip = edit->start;
+      atk_editable_text_insert_text (editable, edit->text, strlen (edit->text), &ip);
+      break;
+    case ATSPI_TEXT_EDIT_DELETE:
+      atk_editable_text_delete_text (editable, edit->start, edit->end);
+      break;
+    case ATSPI_TEXT_EDIT_CUT:
+      atk_editable_text_cut_text (editable, edit->start, edit->end);
+      break;
+    case ATSPI_TEXT_EDIT_COPY:
+      atk_editable_text_copy_text (editable, edit->start, edit->end);
+      break;
+    case ATSPI_TEXT_EDIT_PASTE:
+      atk_editable_text_paste_text (editable, edit->start);
+      break;
+    }
+}
+
+static DBusMessage *
+impl_ApplyEdits (DBusConnection *bus, DBusMessage *message, void *user_data)
+{
+  AtkEditableText *editable = (AtkEditableText *) user_data;
+  DBusMessageIter iter, iter_array, iter_struct;
+  GArray *edits;
+  dbus_bool_t rv;
+  DBusMessage *reply;
+  guint i;
+
+  g_return_val_if_fail (ATK_IS_EDITABLE_TEXT (user_data),
+                        droute_not_yet_handled_error (message));
+  if (strcmp (dbus_message_get_signature (message), "a(iiis)") != 0)
+    return droute_invalid_arguments_error (message);
+
+  edits = g_array_new (FALSE, FALSE, sizeof (TextEdit));
+  dbus_message_iter_init (message, &iter);
+  dbus_message_iter_recurse (&iter, &iter_array);
+  while (dbus_message_iter_get_arg_type (&iter_array) != DBUS_TYPE_INVALID)
+    {
+      TextEdit edit;
+
+      dbus_message_iter_recurse (&iter_array, &iter_struct);
+      dbus_message_iter_get_basic (&iter_struct, &edit.type);
+      dbus_message_iter_next (&iter_struct);
+      dbus_message_iter_get_basic (&iter_struct, &edit.start);
+      dbus_message_iter_next (&iter_struct);
+      dbus_message_iter_get_basic (&iter_struct, &edit.end);
+      dbus_message_iter_next (&iter_struct);
+      dbus_message_iter_get_basic (&iter_struct, &edit.text);
+      g_array_append_val (edits, edit);
+      dbus_message_iter_next (&iter_array);
+    }
+
+  /* Nothing is applied unless the whole batch makes sense */
+  rv = text_edits_are_valid (editable, edits);
+  if (rv)
+    {
+      spi_atk_begin_text_batch (ATK_OBJECT (editable));
+      for (i = 0; i < edits->len; i++)
+        apply_text_edit (editable, &g_array_index (edits, TextEdit, i));
+      spi_atk_end_text_batch (ATK_OBJECT (editable));
+    }
+  g_array_free (edits, TRUE);
+
+  reply = dbus_message_new_method_return (message);
+  if (reply)
+    {
+      dbus_message_append_args (reply, DBUS_TYPE_BOOLEAN, &rv,
+                                DBUS_TYPE_INVALID);
+    }
+  return reply;
+}
+
 static DRouteMethod methods[] = {
   { impl_SetTextContents, "SetTextContents" },
   { impl_InsertText, "InsertText" },
@@ -189,6 +333,7 @@ static DRouteMethod methods[] = {
   { impl_CutText, "CutText" },
   { impl_DeleteText, "DeleteText" },
   { impl_PasteText, "PasteText" },
+  { impl_ApplyEdits, "ApplyEdits" },
   { NULL, NULL }
 };
 
@@ -70,6 +70,55 @@ impl_GetLink (DBusConnection *bus, DBusMessage *message, void *user_data)
   return spi_hyperlink_return_reference (message, link);
 }
 
+static DBusMessage *
+impl_GetLinks (DBusConnection *bus, DBusMessage *message, void *user_data)
+{
+  AtkHypertext *hypertext = (AtkHypertext *) user_data;
+  DBusMessage *reply;
+  DBusMessageIter iter, iter_array, iter_struct;
+  gint n_links, i;
+
+  g_return_val_if_fail (ATK_IS_HYPERTEXT (user_data),
+                        droute_not_yet_handled_error (message));
+  reply = dbus_message_new_method_return (message);
+  if (!reply)
+    return NULL;
+
+  n_links = atk_hypertext_get_n_links (hypertext);
+  dbus_message_iter_init_append (reply, &iter);
+  dbus_message_iter_open_container (&iter, DBUS_TYPE_ARRAY, "((so)iisi)", &iter_array);
+  for (i = 0; i < n_links; i++)
+    {
+      AtkHyperlink *link = atk_hypertext_get_link (hypertext, i);
+      dbus_int32_t start = -1, end = -1, n_anchors = 0;
+      gchar *uri = NULL;
+
+      if (link)
+        {
+          start = atk_hyperlink_get_start_index (link);
+          end = atk_hyperlink_get_end_index (link);
+          n_anchors = atk_hyperlink_get_n_anchors (link);
+          uri = atk_hyperlink_get_uri (link, 0);
+        }
+      if (!uri || !g_utf8_validate (uri, -1, NULL))
+        {
+          g_free (uri);
+          uri = g_strdup ("");
+        }
+
+      dbus_message_iter_open_container (&iter_array, DBUS_TYPE_STRUCT, NULL, &iter_struct);
+      spi_hyperlink_append_reference (&iter_struct, link);
+      dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_INT32, &start);
+      dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_INT32, &end);
+      dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_STRING, &uri);
+      dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_INT32, &n_anchors);
+      dbus_message_iter_close_container (&iter_array, &iter_struct);
+      g_free (uri);
+    }
+  dbus_message_iter_close_container (&iter, &iter_array);
+  return reply;
+}
+
 static DBusMessage *
 impl_GetLinkIndex (DBusConnection *bus, DBusMessage *message, void *user_data)
 {
@@ -97,6 +146,7 @@ impl_GetLinkIndex (DBusConnection *bus, DBusMessage *message, void *user_data)
 static DRouteMethod methods[] = {
   { impl_GetNLinks, "GetNLinks" },
   { impl_GetLink, "GetLink" },
+  { impl_GetLinks, "GetLinks" },
   { impl_GetLinkIndex, "GetLinkIndex" },
   { NULL, NULL }
 };
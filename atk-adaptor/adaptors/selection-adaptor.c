@@ -30,6 +30,7 @@
 
 #include "introspection.h"
 #include "object.h"
+#include "selection-ranges.h"
 
 static dbus_bool_t
 impl_get_NSelectedChildren (DBusMessageIter *iter, void *user_data)
@@ -220,6 +221,60 @@ impl_DeselectChild (DBusConnection *bus, DBusMessage *message, void *user_data)
   return reply;
 }
 
+static GArray *
+get_table_ranges (AtkTable *table, gboolean columns)
+{
+  GArray *ranges;
+  gint *selected = NULL;
+  gint count;
+
+  if (columns)
+    count = atk_table_get_selected_columns (table, &selected);
+  else
+    count = atk_table_get_selected_rows (table, &selected);
+  if (!selected)
+    count = 0;
+  ranges = spi_ranges_from_indices (selected, count);
+  g_free (selected);
+  return ranges;
+}
+
+static DBusMessage *
+impl_GetSelectionSnapshot (DBusConnection *bus, DBusMessage *message, void *user_data)
+{
+  AtkSelection *selection = (AtkSelection *) user_data;
+  DBusMessage *reply;
+  DBusMessageIter iter;
+  GArray *children, *rows = NULL, *columns = NULL;
+
+  g_return_val_if_fail (ATK_IS_SELECTION (user_data),
+                        droute_not_yet_handled_error (message));
+
+  children = spi_selection_ranges_get_children (selection);
+  if (ATK_IS_TABLE (user_data))
+    {
+      rows = get_table_ranges (ATK_TABLE (user_data), FALSE);
+      columns = get_table_ranges (ATK_TABLE (user_data), TRUE);
+    }
+
+  reply = dbus_message_new_method_return (message);
+  if (reply)
+    {
+      dbus_message_iter_init_append (reply, &iter);
+      spi_ranges_append (&iter, children);
+      spi_ranges_append (&iter, rows);
+      spi_ranges_append (&iter, columns);
+    }
+
+  /* Report later selection changes relative to this snapshot */
+  spi_selection_ranges_track (ATK_OBJECT (user_data), children);
+  if (rows)
+    g_array_free (rows, TRUE);
+  if (columns)
+    g_array_free (columns, TRUE);
+  return reply;
+}
+
 static DRouteMethod methods[] = {
   { impl_GetSelectedChild, "GetSelectedChild" },
   { impl_SelectChild, "SelectChild" },
@@ -228,6 +283,7 @@ static DRouteMethod methods[] = {
   { impl_SelectAll, "SelectAll" },
   { impl_ClearSelection, "ClearSelection" },
   { impl_DeselectChild, "DeselectChild" },
+  { impl_GetSelectionSnapshot, "GetSelectionSnapshot" },
   { NULL, NULL }
 };
 
@@ -29,8 +29,10 @@
 
 #include "spi-dbus.h"
 
+#include "accessible-stateset.h"
 #include "introspection.h"
 #include "object.h"
+#include "spi-marshal.h"
 
 static dbus_bool_t
 impl_get_NRows (DBusMessageIter *iter, void *user_data)
@@ -102,8 +104,7 @@ impl_GetAccessibleAt (DBusConnection *bus, DBusMessage *message, void *user_data
 
   g_return_val_if_fail (ATK_IS_TABLE (user_data),
                         droute_not_yet_handled_error (message));
-  if (!dbus_message_get_args (message, NULL, DBUS_TYPE_INT32, &row, DBUS_TYPE_INT32, &column,
-                              DBUS_TYPE_INVALID))
+  if (!spi_demarshal_Table_GetAccessibleAt (message, &row, &column))
     {
       return droute_invalid_arguments_error (message);
     }
@@ -121,23 +122,15 @@ impl_GetIndexAt (DBusConnection *bus, DBusMessage *message, void *user_data)
   AtkTable *table = (AtkTable *) user_data;
   dbus_int32_t row, column;
   dbus_int32_t index;
-  DBusMessage *reply;
 
   g_return_val_if_fail (ATK_IS_TABLE (user_data),
                         droute_not_yet_handled_error (message));
-  if (!dbus_message_get_args (message, NULL, DBUS_TYPE_INT32, &row, DBUS_TYPE_INT32, &column,
-                              DBUS_TYPE_INVALID))
+  if (!spi_demarshal_Table_GetIndexAt (message, &row, &column))
     {
       return droute_invalid_arguments_error (message);
     }
   index = atk_table_get_index_at (table, row, column);
-  reply = dbus_message_new_method_return (message);
-  if (reply)
-    {
-      dbus_message_append_args (reply, DBUS_TYPE_INT32, &index,
-                                DBUS_TYPE_INVALID);
-    }
-  return reply;
+  return spi_marshal_Table_GetIndexAt_reply (message, index);
 }
 
 static DBusMessage *
@@ -146,22 +139,15 @@ impl_GetRowAtIndex (DBusConnection *bus, DBusMessage *message, void *user_data)
   AtkTable *table = (AtkTable *) user_data;
   dbus_int32_t index;
   dbus_int32_t row;
-  DBusMessage *reply;
 
   g_return_val_if_fail (ATK_IS_TABLE (user_data),
                         droute_not_yet_handled_error (message));
-  if (!dbus_message_get_args (message, NULL, DBUS_TYPE_INT32, &index, DBUS_TYPE_INVALID))
+  if (!spi_demarshal_Table_GetRowAtIndex (message, &index))
     {
       return droute_invalid_arguments_error (message);
     }
   row = atk_table_get_row_at_index (table, index);
-  reply = dbus_message_new_method_return (message);
-  if (reply)
-    {
-      dbus_message_append_args (reply, DBUS_TYPE_INT32, &row,
-                                DBUS_TYPE_INVALID);
-    }
-  return reply;
+  return spi_marshal_Table_GetRowAtIndex_reply (message, row);
 }
 
 static DBusMessage *
@@ -170,22 +156,15 @@ impl_GetColumnAtIndex (DBusConnection *bus, DBusMessage *message, void *user_dat
   AtkTable *table = (AtkTable *) user_data;
   dbus_int32_t index;
   dbus_int32_t column;
-  DBusMessage *reply;
 
   g_return_val_if_fail (ATK_IS_TABLE (user_data),
                         droute_not_yet_handled_error (message));
-  if (!dbus_message_get_args (message, NULL, DBUS_TYPE_INT32, &index, DBUS_TYPE_INVALID))
+  if (!spi_demarshal_Table_GetColumnAtIndex (message, &index))
     {
       return droute_invalid_arguments_error (message);
     }
   column = atk_table_get_column_at_index (table, index);
-  reply = dbus_message_new_method_return (message);
-  if (reply)
-    {
-      dbus_message_append_args (reply, DBUS_TYPE_INT32, &column,
-                                DBUS_TYPE_INVALID);
-    }
-  return reply;
+  return spi_marshal_Table_GetColumnAtIndex_reply (message, column);
 }
 
 static const gchar *
@@ -207,23 +186,16 @@ impl_GetRowDescription (DBusConnection *bus, DBusMessage *message, void *user_da
   dbus_int32_t row;
   AtkTable *table = (AtkTable *) user_data;
   const gchar *description;
-  DBusMessage *reply;
 
   g_return_val_if_fail (ATK_IS_TABLE (user_data),
                         droute_not_yet_handled_error (message));
-  if (!dbus_message_get_args (message, NULL, DBUS_TYPE_INT32, &row, DBUS_TYPE_INVALID))
+  if (!spi_demarshal_Table_GetRowDescription (message, &row))
     {
       return droute_invalid_arguments_error (message);
     }
   description = atk_table_get_row_description (table, row);
   description = validate_unallocated_string (description);
-  reply = dbus_message_new_method_return (message);
-  if (reply)
-    {
-      dbus_message_append_args (reply, DBUS_TYPE_STRING, &description,
-                                DBUS_TYPE_INVALID);
-    }
-  return reply;
+  return spi_marshal_Table_GetRowDescription_reply (message, description);
 }
 
 static DBusMessage *
@@ -232,23 +204,16 @@ impl_GetColumnDescription (DBusConnection *bus, DBusMessage *message, void *user
   AtkTable *table = (AtkTable *) user_data;
   dbus_int32_t column;
   const char *description;
-  DBusMessage *reply;
 
   g_return_val_if_fail (ATK_IS_TABLE (user_data),
                         droute_not_yet_handled_error (message));
-  if (!dbus_message_get_args (message, NULL, DBUS_TYPE_INT32, &column, DBUS_TYPE_INVALID))
+  if (!spi_demarshal_Table_GetColumnDescription (message, &column))
     {
       return droute_invalid_arguments_error (message);
     }
   description = atk_table_get_column_description (table, column);
   description = validate_unallocated_string (description);
-  reply = dbus_message_new_method_return (message);
-  if (reply)
-    {
-      dbus_message_append_args (reply, DBUS_TYPE_STRING, &description,
-                                DBUS_TYPE_INVALID);
-    }
-  return reply;
+  return spi_marshal_Table_GetColumnDescription_reply (message, description);
 }
 
 static DBusMessage *
@@ -257,23 +222,15 @@ impl_GetRowExtentAt (DBusConnection *bus, DBusMessage *message, void *user_data)
   AtkTable *table = (AtkTable *) user_data;
   dbus_int32_t row, column;
   dbus_int32_t extent;
-  DBusMessage *reply;
 
   g_return_val_if_fail (ATK_IS_TABLE (user_data),
                         droute_not_yet_handled_error (message));
-  if (!dbus_message_get_args (message, NULL, DBUS_TYPE_INT32, &row, DBUS_TYPE_INT32, &column,
-                              DBUS_TYPE_INVALID))
+  if (!spi_demarshal_Table_GetRowExtentAt (message, &row, &column))
     {
       return droute_invalid_arguments_error (message);
     }
   extent = atk_table_get_row_extent_at (table, row, column);
-  reply = dbus_message_new_method_return (message);
-  if (reply)
-    {
-      dbus_message_append_args (reply, DBUS_TYPE_INT32, &extent,
-                                DBUS_TYPE_INVALID);
-    }
-  return reply;
+  return spi_marshal_Table_GetRowExtentAt_reply (message, extent);
 }
 
 static DBusMessage *
@@ -282,23 +239,15 @@ impl_GetColumnExtentAt (DBusConnection *bus, DBusMessage *message, void *user_da
   AtkTable *table = (AtkTable *) user_data;
   dbus_int32_t row, column;
   dbus_int32_t extent;
-  DBusMessage *reply;
 
   g_return_val_if_fail (ATK_IS_TABLE (user_data),
                         droute_not_yet_handled_error (message));
-  if (!dbus_message_get_args (message, NULL, DBUS_TYPE_INT32, &row, DBUS_TYPE_INT32, &column,
-                              DBUS_TYPE_INVALID))
+  if (!spi_demarshal_Table_GetColumnExtentAt (message, &row, &column))
     {
       return droute_invalid_arguments_error (message);
     }
   extent = atk_table_get_column_extent_at (table, row, column);
-  reply = dbus_message_new_method_return (message);
-  if (reply)
-    {
-      dbus_message_append_args (reply, DBUS_TYPE_INT32, &extent,
-                                DBUS_TYPE_INVALID);
-    }
-  return reply;
+  return spi_marshal_Table_GetColumnExtentAt_reply (message, extent);
 }
 
 static DBusMessage *
@@ -310,7 +259,7 @@ impl_GetRowHeader (DBusConnection *bus, DBusMessage *message, void *user_data)
 
   g_return_val_if_fail (ATK_IS_TABLE (user_data),
                         droute_not_yet_handled_error (message));
-  if (!dbus_message_get_args (message, NULL, DBUS_TYPE_INT32, &row, DBUS_TYPE_INVALID))
+  if (!spi_demarshal_Table_GetRowHeader (message, &row))
     {
       return droute_invalid_arguments_error (message);
     }
@@ -327,7 +276,7 @@ impl_GetColumnHeader (DBusConnection *bus, DBusMessage *message, void *user_data
 
   g_return_val_if_fail (ATK_IS_TABLE (user_data),
                         droute_not_yet_handled_error (message));
-  if (!dbus_message_get_args (message, NULL, DBUS_TYPE_INT32, &column, DBUS_TYPE_INVALID))
+  if (!spi_demarshal_Table_GetColumnHeader (message, &column))
     {
       return droute_invalid_arguments_error (message);
     }
@@ -390,23 +339,16 @@ impl_IsRowSelected (DBusConnection *bus, DBusMessage *message, void *user_data)
 {
   AtkTable *table = (AtkTable *) user_data;
   dbus_int32_t row;
-  DBusMessage *reply;
   dbus_bool_t ret;
 
   g_return_val_if_fail (ATK_IS_TABLE (user_data),
                         droute_not_yet_handled_error (message));
-  if (!dbus_message_get_args (message, NULL, DBUS_TYPE_INT32, &row, DBUS_TYPE_INVALID))
+  if (!spi_demarshal_Table_IsRowSelected (message, &row))
     {
       return droute_invalid_arguments_error (message);
     }
   ret = atk_table_is_row_selected (table, row);
-  reply = dbus_message_new_method_return (message);
-  if (reply)
-    {
-      dbus_message_append_args (reply, DBUS_TYPE_BOOLEAN, &ret,
-                                DBUS_TYPE_INVALID);
-    }
-  return reply;
+  return spi_marshal_Table_IsRowSelected_reply (message, ret);
 }
 
 static DBusMessage *
@@ -414,23 +356,16 @@ impl_IsColumnSelected (DBusConnection *bus, DBusMessage *message, void *user_dat
 {
   AtkTable *table = (AtkTable *) user_data;
   dbus_int32_t column;
-  DBusMessage *reply;
   dbus_bool_t ret;
 
   g_return_val_if_fail (ATK_IS_TABLE (user_data),
                         droute_not_yet_handled_error (message));
-  if (!dbus_message_get_args (message, NULL, DBUS_TYPE_INT32, &column, DBUS_TYPE_INVALID))
+  if (!spi_demarshal_Table_IsColumnSelected (message, &column))
     {
       return droute_invalid_arguments_error (message);
     }
   ret = atk_table_is_column_selected (table, column);
-  reply = dbus_message_new_method_return (message);
-  if (reply)
-    {
-      dbus_message_append_args (reply, DBUS_TYPE_BOOLEAN, &ret,
-                                DBUS_TYPE_INVALID);
-    }
-  return reply;
+  return spi_marshal_Table_IsColumnSelected_reply (message, ret);
 }
 
 static DBusMessage *
@@ -438,24 +373,16 @@ impl_IsSelected (DBusConnection *bus, DBusMessage *message, void *user_data)
 {
   AtkTable *table = (AtkTable *) user_data;
   dbus_int32_t row, column;
-  DBusMessage *reply;
   dbus_bool_t ret;
 
   g_return_val_if_fail (ATK_IS_TABLE (user_data),
                         droute_not_yet_handled_error (message));
-  if (!dbus_message_get_args (message, NULL, DBUS_TYPE_INT32, &row, DBUS_TYPE_INT32, &column,
-                              DBUS_TYPE_INVALID))
+  if (!spi_demarshal_Table_IsSelected (message, &row, &column))
     {
       return droute_invalid_arguments_error (message);
     }
   ret = atk_table_is_selected (table, row, column);
-  reply = dbus_message_new_method_return (message);
-  if (reply)
-    {
-      dbus_message_append_args (reply, DBUS_TYPE_BOOLEAN, &ret,
-                                DBUS_TYPE_INVALID);
-    }
-  return reply;
+  return spi_marshal_Table_IsSelected_reply (message, ret);
 }
 
 static DBusMessage *
@@ -463,23 +390,16 @@ impl_AddRowSelection (DBusConnection *bus, DBusMessage *message, void *user_data
 {
   AtkTable *table = (AtkTable *) user_data;
   dbus_int32_t row;
-  DBusMessage *reply;
   dbus_bool_t ret;
 
   g_return_val_if_fail (ATK_IS_TABLE (user_data),
                         droute_not_yet_handled_error (message));
-  if (!dbus_message_get_args (message, NULL, DBUS_TYPE_INT32, &row, DBUS_TYPE_INVALID))
+  if (!spi_demarshal_Table_AddRowSelection (message, &row))
     {
       return droute_invalid_arguments_error (message);
     }
   ret = atk_table_add_row_selection (table, row);
-  reply = dbus_message_new_method_return (message);
-  if (reply)
-    {
-      dbus_message_append_args (reply, DBUS_TYPE_BOOLEAN, &ret,
-                                DBUS_TYPE_INVALID);
-    }
-  return reply;
+  return spi_marshal_Table_AddRowSelection_reply (message, ret);
 }
 
 static DBusMessage *
@@ -487,23 +407,16 @@ impl_AddColumnSelection (DBusConnection *bus, DBusMessage *message, void *user_d
 {
   AtkTable *table = (AtkTable *) user_data;
   dbus_int32_t column;
-  DBusMessage *reply;
   dbus_bool_t ret;
 
   g_return_val_if_fail (ATK_IS_TABLE (user_data),
                         droute_not_yet_handled_error (message));
-  if (!dbus_message_get_args (message, NULL, DBUS_TYPE_INT32, &column, DBUS_TYPE_INVALID))
+  if (!spi_demarshal_Table_AddColumnSelection (message, &column))
     {
       return droute_invalid_arguments_error (message);
     }
   ret = atk_table_add_column_selection (table, column);
-  reply = dbus_message_new_method_return (message);
-  if (reply)
-    {
-      dbus_message_append_args (reply, DBUS_TYPE_BOOLEAN, &ret,
-                                DBUS_TYPE_INVALID);
-    }
-  return reply;
+  return spi_marshal_Table_AddColumnSelection_reply (message, ret);
 }
 
 static DBusMessage *
@@ -511,23 +424,16 @@ impl_RemoveRowSelection (DBusConnection *bus, DBusMessage *message, void *user_d
 {
   AtkTable *table = (AtkTable *) user_data;
   dbus_int32_t row;
-  DBusMessage *reply;
   dbus_bool_t ret;
 
   g_return_val_if_fail (ATK_IS_TABLE (user_data),
                         droute_not_yet_handled_error (message));
-  if (!dbus_message_get_args (message, NULL, DBUS_TYPE_INT32, &row, DBUS_TYPE_INVALID))
+  if (!spi_demarshal_Table_RemoveRowSelection (message, &row))
     {
       return droute_invalid_arguments_error (message);
     }
   ret = atk_table_remove_row_selection (table, row);
-  reply = dbus_message_new_method_return (message);
-  if (reply)
-    {
-      dbus_message_append_args (reply, DBUS_TYPE_BOOLEAN, &ret,
-                                DBUS_TYPE_INVALID);
-    }
-  return reply;
+  return spi_marshal_Table_RemoveRowSelection_reply (message, ret);
 }
 
 static DBusMessage *
@@ -535,23 +441,16 @@ impl_RemoveColumnSelection (DBusConnection *bus, DBusMessage *message, void *use
 {
   AtkTable *table = (AtkTable *) user_data;
   dbus_int32_t column;
-  DBusMessage *reply;
   dbus_bool_t ret;
 
   g_return_val_if_fail (ATK_IS_TABLE (user_data),
                         droute_not_yet_handled_error (message));
-  if (!dbus_message_get_args (message, NULL, DBUS_TYPE_INT32, &column, DBUS_TYPE_INVALID))
+  if (!spi_demarshal_Table_RemoveColumnSelection (message, &column))
     {
       return droute_invalid_arguments_error (message);
     }
   ret = atk_table_remove_column_selection (table, column);
-  reply = dbus_message_new_method_return (message);
-  if (reply)
-    {
-      dbus_message_append_args (reply, DBUS_TYPE_BOOLEAN, &ret,
-                                DBUS_TYPE_INVALID);
-    }
-  return reply;
+  return spi_marshal_Table_RemoveColumnSelection_reply (message, ret);
 }
 
 static DBusMessage *
@@ -562,13 +461,12 @@ impl_GetRowColumnExtentsAtIndex (DBusConnection *bus, DBusMessage *message, void
   dbus_int32_t row, column, row_extents, col_extents;
   dbus_bool_t is_selected;
   dbus_bool_t ret;
-  DBusMessage *reply;
   AtkObject *cell;
   AtkRole role = ATK_ROLE_INVALID;
 
   g_return_val_if_fail (ATK_IS_TABLE (user_data),
                         droute_not_yet_handled_error (message));
-  if (!dbus_message_get_args (message, NULL, DBUS_TYPE_INT32, &index, DBUS_TYPE_INVALID))
+  if (!spi_demarshal_Table_GetRowColumnExtentsAtIndex (message, &index))
     {
       return droute_invalid_arguments_error (message);
     }
@@ -584,16 +482,161 @@ impl_GetRowColumnExtentsAtIndex (DBusConnection *bus, DBusMessage *message, void
       g_object_unref (cell);
     }
   ret = (role == ATK_ROLE_TABLE_CELL ? TRUE : FALSE);
-  reply = dbus_message_new_method_return (message);
-  if (reply)
+  return spi_marshal_Table_GetRowColumnExtentsAtIndex_reply (message, ret, row, column,
+                                                             row_extents, col_extents, is_selected);
+}
+
+static void
+append_cell_property (DBusMessageIter *iter_dict,
+                      const char *name,
+                      int type,
+                      const void *val)
+{
+  DBusMessageIter iter_dict_entry, iter_variant;
+  char sig[2] = { type, '\0' };
+
+  dbus_message_iter_open_container (iter_dict, DBUS_TYPE_DICT_ENTRY, NULL,
+                                    &iter_dict_entry);
+  dbus_message_iter_append_basic (&iter_dict_entry, DBUS_TYPE_STRING, &name);
+  dbus_message_iter_open_container (&iter_dict_entry, DBUS_TYPE_VARIANT, sig,
+                                    &iter_variant);
+  dbus_message_iter_append_basic (&iter_variant, type, val);
+  dbus_message_iter_close_container (&iter_dict_entry, &iter_variant);
+  dbus_message_iter_close_container (iter_dict, &iter_dict_entry);
+}
+
+static void
+append_cell_string (DBusMessageIter *iter_dict, const char *name, const char *val)
+{
+  if (!val || !g_utf8_validate (val, -1, NULL))
+    val = "";
+  append_cell_property (iter_dict, name, DBUS_TYPE_STRING, &val);
+}
+
+/* Appends the properties of a cell that were asked for, as AtspiCache flags */
+static void
+append_cell_properties (DBusMessageIter *iter, AtkObject *cell, dbus_uint32_t mask)
+{
+  DBusMessageIter iter_dict;
+
+  dbus_message_iter_open_container (iter, DBUS_TYPE_ARRAY, "{sv}", &iter_dict);
+  if (cell && (mask & ATSPI_CACHE_NAME))
+    append_cell_string (&iter_dict, "Name", atk_object_get_name (cell));
+  if (cell && (mask & ATSPI_CACHE_DESCRIPTION))
+    append_cell_string (&iter_dict, "Description", atk_object_get_description (cell));
+  if (cell && (mask & ATSPI_CACHE_ROLE))
+    {
+      dbus_uint32_t role = spi_accessible_role_from_atk_role (atk_object_get_role (cell));
+      append_cell_property (&iter_dict, "Role", DBUS_TYPE_UINT32, &role);
+    }
+  if (cell && (mask & ATSPI_CACHE_STATES))
+    {
+      DBusMessageIter iter_dict_entry, iter_variant, iter_array;
+      dbus_uint32_t states[2];
+      const char *name = "States";
+      gint i;
+
+      spi_atk_state_to_dbus_array (cell, states);
+      dbus_message_iter_open_container (&iter_dict, DBUS_TYPE_DICT_ENTRY, NULL,
+                                        &iter_dict_entry);
+      dbus_message_iter_append_basic (&iter_dict_entry, DBUS_TYPE_STRING, &name);
+      dbus_message_iter_open_container (&iter_dict_entry, DBUS_TYPE_VARIANT, "au",
+                                        &iter_variant);
+      dbus_message_iter_open_container (&iter_variant, DBUS_TYPE_ARRAY, "u",
+                                        &iter_array);
+      for (i = 0; i < 2; i++)
+        dbus_message_iter_append_basic (&iter_array, DBUS_TYPE_UINT32, &states[i]);
+      dbus_message_iter_close_container (&iter_variant, &iter_array);
+      dbus_message_iter_close_container (&iter_dict_entry, &iter_variant);
+      dbus_message_iter_close_container (&iter_dict, &iter_dict_entry);
+    }
+  dbus_message_iter_close_container (iter, &iter_dict);
+}
+
+static DBusMessage *
+impl_GetRegion (DBusConnection *bus, DBusMessage *message, void *user_data)
+{
+  AtkTable *table = (AtkTable *) user_data;
+  dbus_int32_t row0, column0, n_rows, n_columns;
+  dbus_uint32_t mask;
+  gint table_rows, table_columns, row, column;
+  GHashTable *seen;
+  DBusMessage *reply;
+  DBusMessageIter iter, iter_array, iter_struct;
+
+  g_return_val_if_fail (ATK_IS_TABLE (user_data),
+                        droute_not_yet_handled_error (message));
+  if (!spi_demarshal_Table_GetRegion (message, &row0, &column0, &n_rows,
+                                      &n_columns, &mask))
     {
-      dbus_message_append_args (reply, DBUS_TYPE_BOOLEAN, &ret,
-                                DBUS_TYPE_INT32, &row, DBUS_TYPE_INT32,
-                                &column, DBUS_TYPE_INT32, &row_extents,
-                                DBUS_TYPE_INT32, &col_extents,
-                                DBUS_TYPE_BOOLEAN, &is_selected,
-                                DBUS_TYPE_INVALID);
+      return droute_invalid_arguments_error (message);
     }
+
+  /* Clip the region to the table */
+  table_rows = atk_table_get_n_rows (table);
+  table_columns = atk_table_get_n_columns (table);
+  row0 = CLAMP (row0, 0, table_rows);
+  column0 = CLAMP (column0, 0, table_columns);
+  n_rows = CLAMP (n_rows, 0, table_rows - row0);
+  n_columns = CLAMP (n_columns, 0, table_columns - column0);
+
+  reply = dbus_message_new_method_return (message);
+  if (!reply)
+    return NULL;
+
+  dbus_message_iter_init_append (reply, &iter);
+
+  /*
+   * A cell spanning several rows or columns is only listed once, at the
+   * first position of the region it is found at.
+   */
+  seen = g_hash_table_new (NULL, NULL);
+  dbus_message_iter_open_container (&iter, DBUS_TYPE_ARRAY, "((so)iiiiba{sv})", &iter_array);
+  for (row = row0; row < row0 + n_rows; row++)
+    {
+      for (column = column0; column < column0 + n_columns; column++)
+        {
+          AtkObject *cell = atk_table_ref_at (table, row, column);
+          dbus_int32_t d_row = row, d_column = column;
+          dbus_int32_t row_extent, column_extent;
+          dbus_bool_t selected;
+
+          if (cell && !g_hash_table_add (seen, cell))
+            {
+              g_object_unref (cell);
+              continue;
+            }
+
+          row_extent = atk_table_get_row_extent_at (table, row, column);
+          column_extent = atk_table_get_column_extent_at (table, row, column);
+          selected = atk_table_is_selected (table, row, column);
+
+          dbus_message_iter_open_container (&iter_array, DBUS_TYPE_STRUCT, NULL, &iter_struct);
+          spi_object_append_reference (&iter_struct, cell);
+          dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_INT32, &d_row);
+          dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_INT32, &d_column);
+          dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_INT32, &row_extent);
+          dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_INT32, &column_extent);
+          dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_BOOLEAN, &selected);
+          append_cell_properties (&iter_struct, cell, mask);
+          dbus_message_iter_close_container (&iter_array, &iter_struct);
+          if (cell)
+            g_object_unref (cell);
+        }
+    }
+  dbus_message_iter_close_container (&iter, &iter_array);
+  g_hash_table_destroy (seen);
+
+  dbus_message_iter_open_container (&iter, DBUS_TYPE_ARRAY, "(so)", &iter_array);
+  for (row = row0; row < row0 + n_rows; row++)
+    spi_object_append_reference (&iter_array, atk_table_get_row_header (table, row));
+  dbus_message_iter_close_container (&iter, &iter_array);
+
+  dbus_message_iter_open_container (&iter, DBUS_TYPE_ARRAY, "(so)", &iter_array);
+  for (column = column0; column < column0 + n_columns; column++)
+    spi_object_append_reference (&iter_array, atk_table_get_column_header (table, column));
+  dbus_message_iter_close_container (&iter, &iter_array);
+
   return reply;
 }
 
@@ -618,6 +661,7 @@ static DRouteMethod methods[] = {
   { impl_RemoveRowSelection, "RemoveRowSelection" },
   { impl_RemoveColumnSelection, "RemoveColumnSelection" },
   { impl_GetRowColumnExtentsAtIndex, "GetRowColumnExtentsAtIndex" },
+  { impl_GetRegion, "GetRegion" },
   { NULL, NULL }
 };
 
@@ -22,6 +22,16 @@
  * Boston, MA 02110-1301, USA.
  */
 
+#include "config.h"
+
+#ifdef HAVE_MEMFD_CREATE
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #include <string.h>
 
 #define ATK_DISABLE_DEPRECATION_WARNINGS
@@ -91,6 +101,96 @@ impl_GetText (DBusConnection *bus, DBusMessage *message, void *user_data)
   return reply;
 }
 
+#ifdef HAVE_MEMFD_CREATE
+/*
+ * Copies len bytes of txt into an anonymous memory file and seals it, so
+ * that the client can map it without having to worry about us changing or
+ * truncating it afterwards. Returns -1 if this could not be done, in which
+ * case the caller should send the text inline.
+ */
+static int
+text_to_sealed_memfd (const gchar *txt, gsize len)
+{
+  gsize written = 0;
+  int fd;
+
+  fd = memfd_create ("atspi-text", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+  if (fd < 0)
+    return -1;
+
+  while (written < len)
+    {
+      ssize_t res = write (fd, txt + written, len - written);
+      if (res < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          close (fd);
+          return -1;
+        }
+      written += res;
+    }
+
+  if (fcntl (fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) < 0)
+    {
+      close (fd);
+      return -1;
+    }
+
+  return fd;
+}
+#endif
+
+static DBusMessage *
+impl_GetTextWithFd (DBusConnection *bus, DBusMessage *message, void *user_data)
+{
+  AtkText *text = (AtkText *) user_data;
+  dbus_int32_t startOffset, endOffset;
+  dbus_uint32_t threshold, length;
+  gchar *txt;
+  int fd = -1;
+  DBusMessage *reply;
+  DBusMessageIter iter, iter_array;
+
+  g_return_val_if_fail (ATK_IS_TEXT (user_data),
+                        droute_not_yet_handled_error (message));
+  if (!dbus_message_get_args (message, NULL, DBUS_TYPE_INT32, &startOffset, DBUS_TYPE_INT32,
+                              &endOffset, DBUS_TYPE_UINT32, &threshold, DBUS_TYPE_INVALID))
+    {
+      return droute_invalid_arguments_error (message);
+    }
+  txt = atk_text_get_text (text, startOffset, endOffset);
+  txt = validate_allocated_string (txt);
+  length = strlen (txt);
+
+#ifdef HAVE_MEMFD_CREATE
+  if (threshold > 0 && length >= threshold &&
+      dbus_connection_can_send_type (bus, DBUS_TYPE_UNIX_FD))
+    fd = text_to_sealed_memfd (txt, length);
+#endif
+
+  reply = dbus_message_new_method_return (message);
+  if (reply)
+    {
+      const char *inline_txt = (fd >= 0 ? "" : txt);
+
+      dbus_message_iter_init_append (reply, &iter);
+      dbus_message_iter_append_basic (&iter, DBUS_TYPE_STRING, &inline_txt);
+      dbus_message_iter_open_container (&iter, DBUS_TYPE_ARRAY, "h", &iter_array);
+      /* libdbus duplicates the descriptor, so we close ours below */
+      if (fd >= 0)
+        dbus_message_iter_append_basic (&iter_array, DBUS_TYPE_UNIX_FD, &fd);
+      dbus_message_iter_close_container (&iter, &iter_array);
+      dbus_message_iter_append_basic (&iter, DBUS_TYPE_UINT32, &length);
+    }
+#ifdef HAVE_MEMFD_CREATE
+  if (fd >= 0)
+    close (fd);
+#endif
+  g_free (txt);
+  return reply;
+}
+
 static DBusMessage *
 impl_SetCaretOffset (DBusConnection *bus, DBusMessage *message, void *user_data)
 {
@@ -877,6 +977,7 @@ impl_ScrollSubstringToPoint (DBusConnection *bus,
 
 static DRouteMethod methods[] = {
   { impl_GetText, "GetText" },
+  { impl_GetTextWithFd, "GetTextWithFd" },
   { impl_SetCaretOffset, "SetCaretOffset" },
   { impl_GetTextBeforeOffset, "GetTextBeforeOffset" },
   { impl_GetTextAtOffset, "GetTextAtOffset" },
@@ -35,6 +35,7 @@
 #include <unistd.h>
 
 #include <atk-bridge.h>
+#include <atspi/atspi-trace.h>
 #include <atspi/atspi.h>
 #include <droute/droute.h>
 
@@ -79,6 +80,7 @@ add_event (const char *bus_name, const char *event)
   evdata->bus_name = g_strdup (bus_name);
   evdata->data = data;
   spi_global_app_data->events = g_list_append (spi_global_app_data->events, evdata);
+  spi_event_listeners_changed ();
   return evdata;
 }
 
@@ -811,6 +813,7 @@ remove_events (const char *bus_name, const char *event)
     }
 
   g_strfreev (remove_data);
+  spi_event_listeners_changed ();
 }
 
 static void
@@ -1048,6 +1051,12 @@ spi_object_has_dbus_interface (void *obj, const char *interface)
   return TRUE;
 }
 
+static void
+trace_handled (DBusConnection *bus, DBusMessage *message, gint64 start_us, void *user_data)
+{
+  _atspi_trace_handled (bus, message, start_us);
+}
+
 /**
  * atk_bridge_adaptor_init: initializes the atk bridge adaptor
  *
@@ -1070,6 +1079,7 @@ atk_bridge_adaptor_init (gint *argc, gchar **argv[])
   AtkObject *root;
   gboolean load_bridge;
   DRoutePath *accpath;
+  const gchar *histograms;
 
   load_bridge = check_envvar ();
   if (inited && !load_bridge)
@@ -1149,6 +1159,11 @@ atk_bridge_adaptor_init (gint *argc, gchar **argv[])
   /* Register droute for routing AT-SPI messages */
   spi_global_app_data->droute =
       droute_new ();
+  histograms = g_getenv ("ATSPI_LATENCY_HISTOGRAMS");
+  if (histograms && atoi (histograms) > 0)
+    droute_context_set_latency_histograms (spi_global_app_data->droute, TRUE);
+  if (_atspi_trace_enabled ())
+    droute_context_set_trace_func (spi_global_app_data->droute, trace_handled, NULL);
 
   accpath = droute_add_many (spi_global_app_data->droute,
                              "/org/a11y/atspi/accessible",
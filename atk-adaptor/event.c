@@ -24,6 +24,7 @@
  */
 
 #include <ctype.h>
+#include <stdlib.h>
 #include <string.h>
 
 #define ATK_DISABLE_DEPRECATION_WARNINGS
@@ -36,7 +37,10 @@
 
 #include "event.h"
 #include "object.h"
+#include "selection-ranges.h"
+#include "spatial-index.h"
 #include "spi-dbus.h"
+#include "text-changes.h"
 
 static GArray *listener_ids = NULL;
 
@@ -45,6 +49,10 @@ static gint atk_bridge_focus_tracker_id;
 
 GMainContext *spi_context = NULL;
 
+/* Events sent, and events dropped because no one was listening */
+static guint64 n_events_emitted = 0;
+static guint64 n_events_suppressed = 0;
+
 /*---------------------------------------------------------------------------*/
 
 #define ITF_EVENT_OBJECT "org.a11y.atspi.Event.Object"
@@ -325,6 +333,18 @@ append_basic (DBusMessageIter *iter,
   dbus_message_iter_close_container (iter, &sub);
 }
 
+static void
+append_double (DBusMessageIter *iter,
+               const char *type,
+               const void *val)
+{
+  DBusMessageIter sub;
+
+  dbus_message_iter_open_container (iter, DBUS_TYPE_VARIANT, type, &sub);
+  dbus_message_iter_append_basic (&sub, DBUS_TYPE_DOUBLE, val);
+  dbus_message_iter_close_container (iter, &sub);
+}
+
 static void
 append_rect (DBusMessageIter *iter,
              const char *type,
@@ -355,6 +375,36 @@ append_object (DBusMessageIter *iter,
   spi_object_append_v_reference (iter, ATK_OBJECT (val));
 }
 
+static void
+append_selection_changes (DBusMessageIter *iter,
+                          const char *type,
+                          const void *val)
+{
+  DBusMessageIter variant, iter_array, iter_struct;
+  const GArray *changes = (const GArray *) val;
+  guint i;
+
+  dbus_message_iter_open_container (iter, DBUS_TYPE_VARIANT, type, &variant);
+  dbus_message_iter_open_container (&variant, DBUS_TYPE_ARRAY, "(bii)",
+                                    &iter_array);
+  for (i = 0; i < changes->len; i++)
+    {
+      SpiSelectionChange *change = &g_array_index (changes, SpiSelectionChange, i);
+      dbus_bool_t d_selected = change->selected;
+      dbus_int32_t d_start = change->start, d_count = change->count;
+
+      dbus_message_iter_open_container (&iter_array, DBUS_TYPE_STRUCT, NULL,
+                                        &iter_struct);
+      dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_BOOLEAN, &d_selected);
+      dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_INT32, &d_start);
+      dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_INT32, &d_count);
+      dbus_message_iter_close_container (&iter_array, &iter_struct);
+    }
+  dbus_message_iter_close_container (&variant, &iter_array);
+
+  dbus_message_iter_close_container (iter, &variant);
+}
+
 static gchar *
 signal_name_to_dbus (const gchar *s)
 {
@@ -503,6 +553,20 @@ adapt_minor_for_dbus (const char *source)
   return ret;
 }
 
+static gboolean flushing_text_changes = FALSE;
+static GHashTable *pending_text_changes = NULL;
+static AtkObject *text_batch_accessible = NULL;
+
+static void flush_text_changes_for_object (AtkObject *accessible);
+
+static GHashTable *pending_bounds_changes = NULL;
+
+static void flush_bounds_change_for_object (AtkObject *accessible);
+
+static GHashTable *value_change_throttles = NULL;
+
+static void flush_value_change_for_object (AtkObject *accessible);
+
 /*
  * Emits an AT-SPI event.
  * AT-SPI events names are split into three parts:
@@ -525,7 +589,7 @@ emit_event (AtkObject *obj,
             void (*append_variant) (DBusMessageIter *, const char *, const void *))
 {
   DBusConnection *bus = spi_global_app_data->bus;
-  char *path;
+  const char *path;
   char *minor_dbus;
 
   gchar *cname;
@@ -542,10 +606,26 @@ emit_event (AtkObject *obj,
   if (!type)
     type = "u";
 
+  /*
+   * Don't let queued text changes arrive after later events on the object,
+   * unless the object is in the middle of a batch of edits, whose changes
+   * are only reported once the batch is complete.
+   */
+  if (pending_text_changes && !flushing_text_changes &&
+      obj != text_batch_accessible)
+    flush_text_changes_for_object (obj);
+  if (pending_bounds_changes)
+    flush_bounds_change_for_object (obj);
+  if (value_change_throttles)
+    flush_value_change_for_object (obj);
+
   if (!signal_is_needed (obj, klass, major, minor, &properties))
-    return;
+    {
+      n_events_suppressed++;
+      return;
+    }
 
-  path = spi_register_object_to_path (spi_global_register, G_OBJECT (obj));
+  path = spi_register_peek_object_path (spi_global_register, G_OBJECT (obj));
   g_return_if_fail (path != NULL);
 
   /*
@@ -589,12 +669,12 @@ emit_event (AtkObject *obj,
 
   dbus_connection_send (bus, sig, NULL);
   dbus_message_unref (sig);
+  n_events_emitted++;
 
   if (g_strcmp0 (cname, "ChildrenChanged") != 0)
     spi_object_lease_if_needed (G_OBJECT (obj));
 
   g_free (cname);
-  g_free (path);
 }
 
 /*---------------------------------------------------------------------------*/
@@ -614,6 +694,165 @@ focus_tracker (AtkObject *accessible)
 
 #define PCHANGE "PropertyChange"
 
+/*
+ * Value change rate limiting.
+ *
+ * Progress bars can report hundreds of value changes per second. When
+ * ATSPI_VALUE_CHANGE_INTERVAL is set to a number of milliseconds, the first
+ * change of an object's value is emitted right away, but later ones are
+ * emitted at most once per interval, always ending with the final value.
+ * A change of at least ATSPI_VALUE_CHANGE_DELTA percent of the object's
+ * range (10 by default) is significant and is emitted right away. Value
+ * changes are not rate limited by default.
+ *
+ * The new value is sent as the any_data of the
+ * object:property-change:accessible-value event.
+ */
+
+typedef struct _ValueChangeThrottle
+{
+  AtkObject *accessible;
+  gdouble last_value;
+  gdouble value;
+  gboolean pending;
+  guint timeout_id;
+} ValueChangeThrottle;
+
+static guint value_change_interval = 0;
+static gdouble value_change_delta = 0.1;
+
+static void
+value_change_throttle_free (ValueChangeThrottle *throttle)
+{
+  if (throttle->timeout_id)
+    g_source_remove (throttle->timeout_id);
+  g_object_unref (throttle->accessible);
+  g_free (throttle);
+}
+
+static gboolean
+get_current_value (AtkObject *accessible, AtkPropertyValues *values, gdouble *value)
+{
+  GValue src = G_VALUE_INIT;
+  GValue dest = G_VALUE_INIT;
+  gboolean ret;
+
+  if (!ATK_IS_VALUE (accessible))
+    return FALSE;
+
+  if (ATK_VALUE_GET_IFACE (accessible)->get_value_and_text)
+    {
+      gchar *text = NULL;
+      atk_value_get_value_and_text (ATK_VALUE (accessible), value, &text);
+      g_free (text);
+      return TRUE;
+    }
+
+  g_value_init (&dest, G_TYPE_DOUBLE);
+  if (G_IS_VALUE (&values->new_value))
+    ret = g_value_transform (&values->new_value, &dest);
+  else
+    {
+      g_value_init (&src, G_TYPE_DOUBLE);
+      atk_value_get_current_value (ATK_VALUE (accessible), &src);
+      ret = g_value_transform (&src, &dest);
+      g_value_unset (&src);
+    }
+  if (ret)
+    *value = g_value_get_double (&dest);
+  g_value_unset (&dest);
+  return ret;
+}
+
+static gboolean
+value_change_is_significant (AtkObject *accessible, gdouble old_value, gdouble new_value)
+{
+  AtkRange *range;
+  gdouble span;
+
+  if (value_change_delta <= 0 || !ATK_VALUE_GET_IFACE (accessible)->get_range)
+    return FALSE;
+
+  range = atk_value_get_range (ATK_VALUE (accessible));
+  if (!range)
+    return FALSE;
+  span = atk_range_get_upper_limit (range) - atk_range_get_lower_limit (range);
+  atk_range_free (range);
+
+  return (span > 0 && ABS (new_value - old_value) >= value_change_delta * span);
+}
+
+static void
+emit_value_change (ValueChangeThrottle *throttle)
+{
+  throttle->pending = FALSE;
+  throttle->last_value = throttle->value;
+  emit_event (throttle->accessible, ITF_EVENT_OBJECT, PCHANGE, "accessible-value",
+              0, 0, DBUS_TYPE_DOUBLE_AS_STRING, &throttle->value, append_double);
+}
+
+static void
+flush_value_change_for_object (AtkObject *accessible)
+{
+  ValueChangeThrottle *throttle;
+
+  throttle = g_hash_table_lookup (value_change_throttles, accessible);
+  if (throttle && throttle->pending)
+    emit_value_change (throttle);
+}
+
+/*
+ * Emits the latest value if it was held back, and keeps the object
+ * throttled for another interval. Otherwise the object has been quiet for a
+ * whole interval, and its next change can be emitted right away.
+ */
+static gboolean
+value_change_timeout (gpointer data)
+{
+  ValueChangeThrottle *throttle = data;
+
+  if (throttle->pending)
+    {
+      emit_value_change (throttle);
+      return TRUE;
+    }
+
+  throttle->timeout_id = 0;
+  g_hash_table_remove (value_change_throttles, throttle->accessible);
+  return FALSE;
+}
+
+static void
+queue_value_change (AtkObject *accessible, gdouble value)
+{
+  ValueChangeThrottle *throttle;
+
+  if (!value_change_throttles)
+    value_change_throttles = g_hash_table_new_full (NULL, NULL, NULL,
+                                                    (GDestroyNotify) value_change_throttle_free);
+
+  throttle = g_hash_table_lookup (value_change_throttles, accessible);
+  if (!throttle)
+    {
+      throttle = g_new0 (ValueChangeThrottle, 1);
+      throttle->accessible = g_object_ref (accessible);
+      throttle->value = value;
+      throttle->timeout_id = spi_timeout_add_full (G_PRIORITY_DEFAULT,
+                                                   value_change_interval,
+                                                   value_change_timeout,
+                                                   throttle, NULL);
+      g_hash_table_insert (value_change_throttles, accessible, throttle);
+      emit_value_change (throttle);
+      return;
+    }
+
+  throttle->value = value;
+  if (value_change_is_significant (accessible, throttle->last_value, value))
+    emit_value_change (throttle);
+  else
+    throttle->pending = TRUE;
+}
+
 /*
  * This handler handles the following ATK signals and
  * converts them to AT-SPI events:
@@ -636,6 +875,7 @@ property_event_listener (GSignalInvocationHint *signal_hint,
   AtkObject *otemp;
   const gchar *s1;
   gint i;
+  gdouble d;
 
   accessible = g_value_get_object (&param_values[0]);
   values = (AtkPropertyValues *) g_value_get_pointer (&param_values[1]);
@@ -722,6 +962,15 @@ property_event_listener (GSignalInvocationHint *signal_hint,
       emit_event (accessible, ITF_EVENT_OBJECT, PCHANGE, pname, 0, 0,
                   "(so)", otemp, append_object);
     }
+  else if (strcmp (pname, "accessible-value") == 0 &&
+           get_current_value (accessible, values, &d))
+    {
+      if (value_change_interval)
+        queue_value_change (accessible, d);
+      else
+        emit_event (accessible, ITF_EVENT_OBJECT, PCHANGE, pname, 0, 0,
+                    DBUS_TYPE_DOUBLE_AS_STRING, &d, append_double);
+    }
   else
     {
       emit_event (accessible, ITF_EVENT_OBJECT, PCHANGE, pname, 0, 0,
@@ -835,6 +1084,112 @@ document_event_listener (GSignalInvocationHint *signal_hint,
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * Bounds change throttling.
+ *
+ * Window resizes and animated layouts can change the bounds of an object
+ * many times per frame. When ATSPI_BOUNDS_CHANGE_INTERVAL is set to a
+ * number of milliseconds (16 is one frame at 60Hz), bounds changes are
+ * collected per object for up to that long and only the last rect is
+ * emitted. As with text changes, any other event on an object first
+ * flushes its pending bounds change. Bounds changes are not throttled by
+ * default.
+ *
+ * Listeners that need every update can register for
+ * "object:bounds-changed:unthrottled"; while one is registered, bounds
+ * changes are emitted as they happen with "unthrottled" as the detail, which
+ * plain "object:bounds-changed" listeners receive as well. Whether one is
+ * registered is worked out when listeners change, not on every event.
+ */
+
+typedef struct _PendingBoundsChange
+{
+  AtkObject *accessible;
+  gchar *name;
+  AtkRectangle rect;
+} PendingBoundsChange;
+
+static guint bounds_change_interval = 0;
+static gboolean unthrottled_bounds_listener = FALSE;
+static guint bounds_change_flush_id = 0;
+
+static void
+pending_bounds_change_free (PendingBoundsChange *pending)
+{
+  g_object_unref (pending->accessible);
+  g_free (pending->name);
+  g_free (pending);
+}
+
+static void
+emit_pending_bounds_change (PendingBoundsChange *pending)
+{
+  emit_event (pending->accessible, ITF_EVENT_OBJECT, pending->name, "", 0, 0,
+              "(iiii)", &pending->rect, append_rect);
+  pending_bounds_change_free (pending);
+}
+
+static void
+flush_bounds_change_for_object (AtkObject *accessible)
+{
+  PendingBoundsChange *pending;
+
+  pending = g_hash_table_lookup (pending_bounds_changes, accessible);
+  if (!pending)
+    return;
+  g_hash_table_steal (pending_bounds_changes, accessible);
+  emit_pending_bounds_change (pending);
+}
+
+static gboolean
+flush_bounds_changes (gpointer data)
+{
+  GHashTableIter iter;
+  gpointer value;
+
+  bounds_change_flush_id = 0;
+  g_hash_table_iter_init (&iter, pending_bounds_changes);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+      g_hash_table_iter_steal (&iter);
+      emit_pending_bounds_change (value);
+    }
+  return FALSE;
+}
+
+static gboolean
+bounds_changes_unthrottled (void)
+{
+  return (spi_global_app_data->events_initialized && unthrottled_bounds_listener);
+}
+
+static void
+queue_bounds_change (AtkObject *accessible,
+                     const gchar *name,
+                     const AtkRectangle *rect)
+{
+  PendingBoundsChange *pending;
+
+  if (!pending_bounds_changes)
+    pending_bounds_changes = g_hash_table_new_full (NULL, NULL, NULL,
+                                                    (GDestroyNotify) pending_bounds_change_free);
+
+  pending = g_hash_table_lookup (pending_bounds_changes, accessible);
+  if (!pending)
+    {
+      pending = g_new0 (PendingBoundsChange, 1);
+      pending->accessible = g_object_ref (accessible);
+      pending->name = g_strdup (name);
+      g_hash_table_insert (pending_bounds_changes, accessible, pending);
+    }
+  pending->rect = *rect;
+
+  if (!bounds_change_flush_id)
+    bounds_change_flush_id = spi_timeout_add_full (G_PRIORITY_DEFAULT,
+                                                   bounds_change_interval,
+                                                   flush_bounds_changes, NULL, NULL);
+}
+
 /*
  * Signal handler for  "Gtk:AtkComponent:bounds-changed". Converts
  * this to an AT-SPI event - "object:bounds-changed".
@@ -855,12 +1210,24 @@ bounds_event_listener (GSignalInvocationHint *signal_hint,
 
   accessible = ATK_OBJECT (g_value_get_object (&param_values[0]));
 
+  spi_spatial_index_bounds_changed (accessible);
+
   if (G_VALUE_HOLDS_BOXED (param_values + 1))
     {
       atk_rect = g_value_get_boxed (param_values + 1);
 
-      emit_event (accessible, ITF_EVENT_OBJECT, name, "", 0, 0,
-                  "(iiii)", atk_rect, append_rect);
+      if (bounds_changes_unthrottled ())
+        {
+          if (pending_bounds_changes)
+            flush_bounds_change_for_object (accessible);
+          emit_event (accessible, ITF_EVENT_OBJECT, name, "unthrottled", 0, 0,
+                      "(iiii)", atk_rect, append_rect);
+        }
+      else if (bounds_change_interval)
+        queue_bounds_change (accessible, name, atk_rect);
+      else
+        emit_event (accessible, ITF_EVENT_OBJECT, name, "", 0, 0,
+                    "(iiii)", atk_rect, append_rect);
     }
   return TRUE;
 }
@@ -975,6 +1342,177 @@ link_selected_event_listener (GSignalInvocationHint *signal_hint,
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * Text change compaction.
+ *
+ * If ATSPI_TEXT_CHANGE_INTERVAL is set to a number of milliseconds, text
+ * insertions and removals are not emitted as they happen. Instead they are
+ * collected per object for up to that long and then emitted as the
+ * smallest equivalent sequence of text-changed:delete/insert events (see
+ * text-changes.c), so that a programmatic edit touching the same area
+ * thousands of times reaches ATs as a handful of events.
+ *
+ * Any other event on an object first flushes its queued text changes, so
+ * ATs still see events in a consistent order.
+ */
+
+typedef struct _PendingTextChanges
+{
+  AtkObject *accessible;
+  gchar *detail;
+  SpiTextChanges *changes;
+} PendingTextChanges;
+
+static guint text_change_interval = 0;
+static guint text_change_flush_id = 0;
+
+static void
+pending_text_changes_free (PendingTextChanges *pending)
+{
+  g_object_unref (pending->accessible);
+  g_free (pending->detail);
+  spi_text_changes_free (pending->changes);
+  g_free (pending);
+}
+
+static void
+emit_text_change (gboolean insert,
+                  gint offset,
+                  gint length,
+                  const gchar *text,
+                  gpointer user_data)
+{
+  PendingTextChanges *pending = user_data;
+  const gchar *kind = (insert ? "insert" : "delete");
+  gchar *minor;
+
+  if (pending->detail)
+    minor = g_strconcat (kind, ":", pending->detail, NULL);
+  else
+    minor = g_strdup (kind);
+
+  emit_event (pending->accessible, ITF_EVENT_OBJECT, "text-changed", minor,
+              offset, length, DBUS_TYPE_STRING_AS_STRING, text, append_basic);
+  g_free (minor);
+}
+
+static void
+emit_pending_text_changes (PendingTextChanges *pending)
+{
+  flushing_text_changes = TRUE;
+  spi_text_changes_foreach (pending->changes, emit_text_change, pending);
+  flushing_text_changes = FALSE;
+  pending_text_changes_free (pending);
+}
+
+static void
+flush_text_changes_for_object (AtkObject *accessible)
+{
+  PendingTextChanges *pending;
+
+  pending = g_hash_table_lookup (pending_text_changes, accessible);
+  if (!pending)
+    return;
+  g_hash_table_steal (pending_text_changes, accessible);
+  emit_pending_text_changes (pending);
+}
+
+static gboolean
+flush_text_changes (gpointer data)
+{
+  GHashTableIter iter;
+  gpointer value;
+
+  text_change_flush_id = 0;
+  g_hash_table_iter_init (&iter, pending_text_changes);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+      g_hash_table_iter_steal (&iter);
+      emit_pending_text_changes (value);
+    }
+  return FALSE;
+}
+
+/*
+ * Queues a text insertion or removal for compaction. Returns FALSE if the
+ * change could not be queued and should be emitted right away.
+ */
+static gboolean
+queue_text_change (AtkObject *accessible,
+                   gboolean insert,
+                   const gchar *detail,
+                   gint offset,
+                   gint length,
+                   const gchar *text)
+{
+  PendingTextChanges *pending;
+  gboolean queued;
+
+  if (!pending_text_changes)
+    pending_text_changes = g_hash_table_new_full (NULL, NULL, NULL,
+                                                  (GDestroyNotify) pending_text_changes_free);
+
+  pending = g_hash_table_lookup (pending_text_changes, accessible);
+  if (pending && g_strcmp0 (pending->detail, detail) != 0)
+    {
+      flush_text_changes_for_object (accessible);
+      pending = NULL;
+    }
+
+  if (!pending)
+    {
+      pending = g_new0 (PendingTextChanges, 1);
+      pending->accessible = g_object_ref (accessible);
+      pending->detail = g_strdup (detail);
+      pending->changes = spi_text_changes_new ();
+      g_hash_table_insert (pending_text_changes, accessible, pending);
+    }
+
+  if (insert)
+    queued = spi_text_changes_insert (pending->changes, offset, length, text);
+  else
+    queued = spi_text_changes_delete (pending->changes, offset, length, text);
+
+  if (!queued)
+    {
+      flush_text_changes_for_object (accessible);
+      return FALSE;
+    }
+
+  if (text_change_interval && !text_change_flush_id)
+    text_change_flush_id = spi_timeout_add_full (G_PRIORITY_DEFAULT,
+                                                 text_change_interval,
+                                                 flush_text_changes, NULL, NULL);
+  return TRUE;
+}
+
+/*
+ * Starts a batch of edits on accessible: until spi_atk_end_text_batch() is
+ * called, its text changes are queued for compaction even if compaction is
+ * otherwise disabled, and are not flushed by other events on the object.
+ */
+void
+spi_atk_begin_text_batch (AtkObject *accessible)
+{
+  if (pending_text_changes)
+    flush_text_changes_for_object (accessible);
+  text_batch_accessible = accessible;
+}
+
+/*
+ * Ends a batch of edits, emitting the compacted changes it made.
+ */
+void
+spi_atk_end_text_batch (AtkObject *accessible)
+{
+  if (text_batch_accessible == accessible)
+    text_batch_accessible = NULL;
+  if (pending_text_changes)
+    flush_text_changes_for_object (accessible);
+}
+
+/*---------------------------------------------------------------------------*/
+
 /*
  * Handles the ATK signal 'Gtk:AtkText:text-changed' and
  * converts it to the AT-SPI signal - 'object:text-changed'
@@ -1061,6 +1599,13 @@ text_insert_event_listener (GSignalInvocationHint *signal_hint,
   else
     text = "";
 
+  if ((text_change_interval || accessible == text_batch_accessible) &&
+      queue_text_change (accessible, TRUE, minor_raw, detail1, detail2, text))
+    {
+      g_free (minor);
+      return TRUE;
+    }
+
   emit_event (accessible, ITF_EVENT_OBJECT, name, minor, detail1, detail2,
               DBUS_TYPE_STRING_AS_STRING, text, append_basic);
   g_free (minor);
@@ -1113,6 +1658,13 @@ text_remove_event_listener (GSignalInvocationHint *signal_hint,
   else
     text = "";
 
+  if ((text_change_interval || accessible == text_batch_accessible) &&
+      queue_text_change (accessible, FALSE, minor_raw, detail1, detail2, text))
+    {
+      g_free (minor);
+      return TRUE;
+    }
+
   emit_event (accessible, ITF_EVENT_OBJECT, name, minor, detail1, detail2,
               DBUS_TYPE_STRING_AS_STRING, text, append_basic);
   g_free (minor);
@@ -1180,6 +1732,8 @@ children_changed_event_listener (GSignalInvocationHint *signal_hint,
   /* If the accessible is on STATE_MANAGES_DESCENDANTS state,
      children-changed signal are not forwarded. */
   accessible = ATK_OBJECT (g_value_get_object (&param_values[0]));
+  spi_spatial_index_children_changed (accessible);
+
   set = atk_object_ref_state_set (accessible);
   ret = atk_state_set_contains_state (set, ATK_STATE_MANAGES_DESCENDANTS);
   g_object_unref (set);
@@ -1314,6 +1868,64 @@ generic_event_listener (GSignalInvocationHint *signal_hint,
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * Handles the ATK signal 'Gtk:AtkSelection:selection-changed' and
+ * converts it to the AT-SPI signal - 'object:selection-changed'
+ *
+ * Objects whose selection snapshot was taken by a client get the runs of
+ * children that were selected or deselected since the previous event as
+ * any_data, with their total counts in detail1 and detail2.
+ */
+static gboolean
+selection_changed_event_listener (GSignalInvocationHint *signal_hint,
+                                  guint n_param_values,
+                                  const GValue *param_values,
+                                  gpointer data)
+{
+  AtkObject *accessible;
+  GArray *changes, *properties = NULL;
+  gint selected = 0, deselected = 0;
+  guint i;
+
+  accessible = ATK_OBJECT (g_value_get_object (&param_values[0]));
+
+  /*
+   * Working out the changes means walking the selection, so don't do it
+   * if no one is listening. The snapshot is then left as it is, and the
+   * next event reports every change made since it was taken.
+   */
+  if (!signal_is_needed (accessible, ITF_EVENT_OBJECT, "selection-changed", "", &properties))
+    {
+      n_events_suppressed++;
+      return TRUE;
+    }
+  if (properties)
+    g_array_free (properties, TRUE);
+
+  changes = spi_selection_ranges_get_changes (accessible);
+  if (!changes)
+    return generic_event_listener (signal_hint, n_param_values, param_values,
+                                   data);
+
+  for (i = 0; i < changes->len; i++)
+    {
+      SpiSelectionChange *change = &g_array_index (changes, SpiSelectionChange, i);
+
+      if (change->selected)
+        selected += change->count;
+      else
+        deselected += change->count;
+    }
+
+  emit_event (accessible, ITF_EVENT_OBJECT, "selection-changed", "",
+              selected, deselected, "a(bii)", changes,
+              append_selection_changes);
+  g_array_free (changes, TRUE);
+  return TRUE;
+}
+
+/*---------------------------------------------------------------------------*/
+
 /*
  * Registers the provided function as a handler for the given signal name
  * and stores the signal id returned so that the function may be
@@ -1346,6 +1958,7 @@ spi_atk_register_event_listeners (void)
    */
   GObject *ao = g_object_new (ATK_TYPE_OBJECT, NULL);
   AtkObject *bo = atk_no_op_object_new (ao);
+  const gchar *interval, *delta, *spatial_index;
   guint id = 0;
 
   g_object_unref (G_OBJECT (bo));
@@ -1357,6 +1970,26 @@ spi_atk_register_event_listeners (void)
       return;
     }
 
+  interval = g_getenv ("ATSPI_TEXT_CHANGE_INTERVAL");
+  if (interval && atoi (interval) > 0)
+    text_change_interval = atoi (interval);
+
+  interval = g_getenv ("ATSPI_BOUNDS_CHANGE_INTERVAL");
+  if (interval)
+    bounds_change_interval = MAX (atoi (interval), 0);
+
+  interval = g_getenv ("ATSPI_VALUE_CHANGE_INTERVAL");
+  if (interval)
+    value_change_interval = MAX (atoi (interval), 0);
+
+  delta = g_getenv ("ATSPI_VALUE_CHANGE_DELTA");
+  if (delta)
+    value_change_delta = MAX (atoi (delta), 0) / 100.0;
+
+  spatial_index = g_getenv ("ATSPI_SPATIAL_INDEX");
+  if (spatial_index && atoi (spatial_index) > 0)
+    spi_spatial_index_enable ();
+
   /* Register for focus event notifications, and register app with central registry  */
   listener_ids = g_array_sized_new (FALSE, TRUE, sizeof (guint), 16);
 
@@ -1429,7 +2062,7 @@ spi_atk_register_event_listeners (void)
                        "Gtk:AtkHypertext:link-selected");
   add_signal_listener (generic_event_listener,
                        "Gtk:AtkObject:visible-data-changed");
-  add_signal_listener (generic_event_listener,
+  add_signal_listener (selection_changed_event_listener,
                        "Gtk:AtkSelection:selection-changed");
   add_signal_listener (generic_event_listener,
                        "Gtk:AtkText:text-attributes-changed");
@@ -1498,6 +2131,35 @@ spi_atk_deregister_event_listeners (void)
       atk_remove_key_event_listener (atk_bridge_key_event_listener_id);
       atk_bridge_key_event_listener_id = 0;
     }
+
+  if (text_change_flush_id)
+    {
+      g_source_remove (text_change_flush_id);
+      flush_text_changes (NULL);
+    }
+  g_clear_pointer (&pending_text_changes, g_hash_table_destroy);
+
+  if (bounds_change_flush_id)
+    {
+      g_source_remove (bounds_change_flush_id);
+      flush_bounds_changes (NULL);
+    }
+  g_clear_pointer (&pending_bounds_changes, g_hash_table_destroy);
+
+  if (value_change_throttles)
+    {
+      GHashTableIter iter;
+      gpointer value;
+
+      g_hash_table_iter_init (&iter, value_change_throttles);
+      while (g_hash_table_iter_next (&iter, NULL, &value))
+        {
+          ValueChangeThrottle *throttle = value;
+          if (throttle->pending)
+            emit_value_change (throttle);
+        }
+      g_clear_pointer (&value_change_throttles, g_hash_table_destroy);
+    }
 }
 
 /*---------------------------------------------------------------------------*/
@@ -1554,4 +2216,63 @@ spi_event_is_subtype (gchar **needle, gchar **haystack)
   return TRUE;
 }
 
+void
+spi_event_get_counts (guint64 *emitted, guint64 *suppressed)
+{
+  *emitted = n_events_emitted;
+  *suppressed = n_events_suppressed;
+}
+
+/*
+ * Updates what is cached about the event listeners registered by clients.
+ * Called whenever one is added or removed.
+ */
+void
+spi_event_listeners_changed (void)
+{
+  static gchar *selection_changed[] = { "Object", "SelectionChanged", "", NULL };
+  gboolean selection_listener = FALSE;
+  GList *list;
+
+  unthrottled_bounds_listener = FALSE;
+  for (list = spi_global_app_data->events; list; list = list->next)
+    {
+      event_data *evdata = list->data;
+      if (evdata->data[0] && evdata->data[1] && evdata->data[2] &&
+          !g_strcmp0 (evdata->data[1], "BoundsChanged") &&
+          !g_strcmp0 (evdata->data[2], "Unthrottled"))
+        unthrottled_bounds_listener = TRUE;
+      if (spi_event_is_subtype (selection_changed, evdata->data))
+        selection_listener = TRUE;
+    }
+
+  /* Keeping selection snapshots up to date walks the selection on every
+   * change, which is only worth it while someone gets the changes. */
+  if (spi_global_app_data->events_initialized && !selection_listener)
+    spi_selection_ranges_untrack_all ();
+}
+
+/*
+ * Estimates the memory used by the event listeners registered by clients,
+ * in bytes.
+ */
+gsize
+spi_event_get_listeners_memory_size (void)
+{
+  gsize size = 0;
+  GList *l;
+
+  for (l = spi_global_app_data->events; l; l = l->next)
+    {
+      event_data *evdata = l->data;
+      gchar **part;
+
+      size += sizeof (GList) + sizeof (event_data) + strlen (evdata->bus_name) + 1;
+      for (part = evdata->data; *part; part++)
+        size += sizeof (gchar *) + strlen (*part) + 1;
+      size += g_slist_length (evdata->properties) * sizeof (GSList);
+    }
+  return size;
+}
+
 /*END------------------------------------------------------------------------*/
@@ -25,12 +25,21 @@
 #ifndef EVENT_H
 #define EVENT_H
 
+#include <atk/atk.h>
+
 void spi_atk_register_event_listeners (void);
 void spi_atk_deregister_event_listeners (void);
 void spi_atk_tidy_windows (void);
 
+void spi_atk_begin_text_batch (AtkObject *accessible);
+void spi_atk_end_text_batch (AtkObject *accessible);
+
 gboolean spi_event_is_subtype (gchar **needle, gchar **haystack);
 
+void spi_event_listeners_changed (void);
+void spi_event_get_counts (guint64 *emitted, guint64 *suppressed);
+gsize spi_event_get_listeners_memory_size (void);
+
 extern GMainContext *spi_context;
 guint spi_idle_add (GSourceFunc function, gpointer data);
 guint spi_timeout_add_seconds (gint interval, GSourceFunc function, gpointer data);
@@ -38,6 +38,7 @@
 #include "accessible-register.h"
 
 #include "bridge.h"
+#include "object.h"
 
 /*---------------------------------------------------------------------------*/
 
@@ -53,11 +54,14 @@
  * manages-descendants and transient objects.
  *
  * This function will simply look for all the accessibles that the cache object
- * has not found and assume that they need to be leased.
+ * has not found and assume that they need to be leased, except for table cells
+ * with a virtual path, which the register keeps alive itself.
  */
 void
 spi_object_lease_if_needed (GObject *obj)
 {
+  if (spi_register_object_is_virtual (spi_global_register, obj))
+    return;
   if (!spi_cache_in (spi_global_cache, obj))
     {
       spi_leasing_take (spi_global_leasing, obj);
@@ -94,7 +98,7 @@ spi_object_append_reference (DBusMessageIter *iter, AtkObject *obj)
 {
   DBusMessageIter iter_struct;
   const gchar *name;
-  gchar *path;
+  const gchar *path;
 
   if (!obj)
     {
@@ -102,21 +106,20 @@ spi_object_append_reference (DBusMessageIter *iter, AtkObject *obj)
       return;
     }
 
-  spi_object_lease_if_needed (G_OBJECT (obj));
-
+  /* The path is looked up first, as it decides whether a lease is needed */
   name = dbus_bus_get_unique_name (spi_global_app_data->bus);
-  path = spi_register_object_to_path (spi_global_register, G_OBJECT (obj));
+  path = spi_register_peek_object_path (spi_global_register, G_OBJECT (obj));
+
+  spi_object_lease_if_needed (G_OBJECT (obj));
 
   if (!path)
-    path = g_strdup (SPI_DBUS_PATH_NULL);
+    path = SPI_DBUS_PATH_NULL;
 
   dbus_message_iter_open_container (iter, DBUS_TYPE_STRUCT, NULL,
                                     &iter_struct);
   dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_STRING, &name);
   dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_OBJECT_PATH, &path);
   dbus_message_iter_close_container (iter, &iter_struct);
-
-  g_free (path);
 }
 
 /* TODO: Perhaps combine with spi_object_append_reference.  Leaving separate
@@ -126,7 +129,7 @@ spi_hyperlink_append_reference (DBusMessageIter *iter, AtkHyperlink *obj)
 {
   DBusMessageIter iter_struct;
   const gchar *name;
-  gchar *path;
+  const gchar *path;
 
   if (!obj)
     {
@@ -137,18 +140,16 @@ spi_hyperlink_append_reference (DBusMessageIter *iter, AtkHyperlink *obj)
   spi_object_lease_if_needed (G_OBJECT (obj));
 
   name = dbus_bus_get_unique_name (spi_global_app_data->bus);
-  path = spi_register_object_to_path (spi_global_register, G_OBJECT (obj));
+  path = spi_register_peek_object_path (spi_global_register, G_OBJECT (obj));
 
   if (!path)
-    path = g_strdup (SPI_DBUS_PATH_NULL);
+    path = SPI_DBUS_PATH_NULL;
 
   dbus_message_iter_open_container (iter, DBUS_TYPE_STRUCT, NULL,
                                     &iter_struct);
   dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_STRING, &name);
   dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_OBJECT_PATH, &path);
   dbus_message_iter_close_container (iter, &iter_struct);
-
-  g_free (path);
 }
 
 void
@@ -34,7 +34,7 @@ void
 spi_object_append_reference (DBusMessageIter *iter, AtkObject *obj);
 
 void
-spi_hyperlink_append_reference (DBusMessageIter *iter, AtkObject *obj);
+spi_hyperlink_append_reference (DBusMessageIter *iter, AtkHyperlink *obj);
 
 void
 spi_object_append_v_reference (DBusMessageIter *iter, AtkObject *obj);
@@ -0,0 +1,286 @@
+/*
+ * AT-SPI - Assistive Technology Service Provider Interface
+ * (Gnome Accessibility Project; http://developer.gnome.org/projects/gap)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <stdlib.h>
+
+#include "selection-ranges.h"
+
+/*
+ * This module describes selections as sorted lists of runs of consecutive
+ * indices, (start, count), so that selecting a thousand adjacent rows costs
+ * a single run rather than a thousand entries.
+ *
+ * Once a client has asked for a snapshot of the children selected in an
+ * object, the runs are kept on the object, and every selection change is
+ * then described as the runs that became selected or deselected since the
+ * previous one.
+ *
+ * Working out a change walks the whole selection, so an object stops being
+ * tracked once more than SPI_SELECTION_RANGES_MAX_SELECTED children are
+ * selected, and all objects stop being tracked when no client listens to
+ * selection changes any more.
+ */
+
+#define SPI_SELECTION_RANGES "spi-selection-ranges"
+
+#define SPI_SELECTION_RANGES_MAX_SELECTED 10000
+
+typedef struct
+{
+  AtkObject *obj;
+  GArray *ranges;
+} TrackedSelection;
+
+/* The tracked objects, which own their TrackedSelection */
+static GHashTable *tracked_objects = NULL;
+
+/*---------------------------------------------------------------------------*/
+
+static int
+compare_indices (const void *a, const void *b)
+{
+  gint ia = *(const gint *) a, ib = *(const gint *) b;
+
+  return (ia > ib) - (ia < ib);
+}
+
+/*
+ * Sorts the indices in place and returns them as runs. Negative and
+ * duplicate indices are ignored.
+ */
+GArray *
+spi_ranges_from_indices (gint *indices, gint n_indices)
+{
+  GArray *ranges = g_array_new (FALSE, FALSE, sizeof (SpiRange));
+  SpiRange *last = NULL;
+  gint i;
+
+  if (n_indices <= 0)
+    return ranges;
+
+  qsort (indices, n_indices, sizeof (gint), compare_indices);
+  for (i = 0; i < n_indices; i++)
+    {
+      if (indices[i] < 0)
+        continue;
+      if (last && indices[i] < last->start + last->count)
+        continue;
+      if (last && indices[i] == last->start + last->count)
+        {
+          last->count++;
+          continue;
+        }
+      g_array_set_size (ranges, ranges->len + 1);
+      last = &g_array_index (ranges, SpiRange, ranges->len - 1);
+      last->start = indices[i];
+      last->count = 1;
+    }
+
+  return ranges;
+}
+
+/* Returns the indices in parent of the selected children, as runs */
+GArray *
+spi_selection_ranges_get_children (AtkSelection *selection)
+{
+  GArray *ranges;
+  gint *indices;
+  gint i, n, count = 0;
+
+  n = atk_selection_get_selection_count (selection);
+  if (n <= 0)
+    return g_array_new (FALSE, FALSE, sizeof (SpiRange));
+
+  indices = g_new (gint, n);
+  for (i = 0; i < n; i++)
+    {
+      AtkObject *child = atk_selection_ref_selection (selection, i);
+
+      if (!child)
+        continue;
+      indices[count++] = atk_object_get_index_in_parent (child);
+      g_object_unref (child);
+    }
+
+  ranges = spi_ranges_from_indices (indices, count);
+  g_free (indices);
+  return ranges;
+}
+
+/* Appends the runs as an a(ii) array */
+void
+spi_ranges_append (DBusMessageIter *iter, GArray *ranges)
+{
+  DBusMessageIter iter_array, iter_struct;
+  guint i;
+
+  dbus_message_iter_open_container (iter, DBUS_TYPE_ARRAY, "(ii)", &iter_array);
+  for (i = 0; ranges && i < ranges->len; i++)
+    {
+      SpiRange *range = &g_array_index (ranges, SpiRange, i);
+      dbus_int32_t d_start = range->start, d_count = range->count;
+
+      dbus_message_iter_open_container (&iter_array, DBUS_TYPE_STRUCT, NULL,
+                                        &iter_struct);
+      dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_INT32, &d_start);
+      dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_INT32, &d_count);
+      dbus_message_iter_close_container (&iter_array, &iter_struct);
+    }
+  dbus_message_iter_close_container (iter, &iter_array);
+}
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * Appends to changes the parts of the runs in a that are not covered by
+ * those in b, as changes to the given selected state.
+ */
+static void
+append_difference (GArray *changes, GArray *a, GArray *b, gboolean selected)
+{
+  guint i, j = 0;
+
+  for (i = 0; i < a->len; i++)
+    {
+      SpiRange *ra = &g_array_index (a, SpiRange, i);
+      gint pos = ra->start;
+      gint end = ra->start + ra->count;
+
+      while (pos < end)
+        {
+          SpiSelectionChange change;
+          gint stop = end;
+
+          /* Skip the runs of b that end before pos */
+          while (j < b->len &&
+                 g_array_index (b, SpiRange, j).start +
+                         g_array_index (b, SpiRange, j).count <=
+                     pos)
+            j++;
+
+          if (j < b->len)
+            {
+              SpiRange *rb = &g_array_index (b, SpiRange, j);
+
+              if (rb->start <= pos)
+                {
+                  pos = MIN (end, rb->start + rb->count);
+                  continue;
+                }
+              stop = MIN (end, rb->start);
+            }
+
+          change.selected = selected;
+          change.start = pos;
+          change.count = stop - pos;
+          g_array_append_val (changes, change);
+          pos = stop;
+        }
+    }
+}
+
+static void
+tracked_selection_free (gpointer data)
+{
+  TrackedSelection *tracked = data;
+
+  g_hash_table_remove (tracked_objects, tracked->obj);
+  g_array_free (tracked->ranges, TRUE);
+  g_free (tracked);
+}
+
+/*
+ * Starts (or restarts) describing the selection changes of obj relative to
+ * the given runs of selected children. Takes ownership of children.
+ */
+void
+spi_selection_ranges_track (AtkObject *obj, GArray *children)
+{
+  TrackedSelection *tracked;
+  gint n_selected = 0;
+  guint i;
+
+  for (i = 0; i < children->len; i++)
+    n_selected += g_array_index (children, SpiRange, i).count;
+  if (n_selected > SPI_SELECTION_RANGES_MAX_SELECTED)
+    {
+      g_object_set_data (G_OBJECT (obj), SPI_SELECTION_RANGES, NULL);
+      g_array_free (children, TRUE);
+      return;
+    }
+
+  if (!tracked_objects)
+    tracked_objects = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+  tracked = g_new (TrackedSelection, 1);
+  tracked->obj = obj;
+  tracked->ranges = children;
+  /* Replacing the previous one removes it from the table first */
+  g_object_set_data_full (G_OBJECT (obj), SPI_SELECTION_RANGES, tracked,
+                          tracked_selection_free);
+  g_hash_table_add (tracked_objects, obj);
+}
+
+/* Stops tracking the selection changes of every object */
+void
+spi_selection_ranges_untrack_all (void)
+{
+  GList *objects, *l;
+
+  if (!tracked_objects)
+    return;
+
+  objects = g_hash_table_get_keys (tracked_objects);
+  for (l = objects; l; l = l->next)
+    g_object_set_data (G_OBJECT (l->data), SPI_SELECTION_RANGES, NULL);
+  g_list_free (objects);
+}
+
+/*
+ * Returns the selection changes of obj since the previous call, or since
+ * it was first tracked, or NULL if obj is not tracked. An object with too
+ * many selected children to be worth walking is no longer tracked.
+ */
+GArray *
+spi_selection_ranges_get_changes (AtkObject *obj)
+{
+  TrackedSelection *tracked;
+  GArray *new_ranges, *changes;
+
+  tracked = g_object_get_data (G_OBJECT (obj), SPI_SELECTION_RANGES);
+  if (!tracked || !ATK_IS_SELECTION (obj))
+    return NULL;
+
+  if (atk_selection_get_selection_count (ATK_SELECTION (obj)) > SPI_SELECTION_RANGES_MAX_SELECTED)
+    {
+      g_object_set_data (G_OBJECT (obj), SPI_SELECTION_RANGES, NULL);
+      return NULL;
+    }
+
+  new_ranges = spi_selection_ranges_get_children (ATK_SELECTION (obj));
+  changes = g_array_new (FALSE, FALSE, sizeof (SpiSelectionChange));
+  append_difference (changes, new_ranges, tracked->ranges, TRUE);
+  append_difference (changes, tracked->ranges, new_ranges, FALSE);
+
+  spi_selection_ranges_track (obj, new_ranges);
+  return changes;
+}
+
+/*END------------------------------------------------------------------------*/
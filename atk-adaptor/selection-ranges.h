@@ -0,0 +1,58 @@
+/*
+ * AT-SPI - Assistive Technology Service Provider Interface
+ * (Gnome Accessibility Project; http://developer.gnome.org/projects/gap)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef SELECTION_RANGES_H
+#define SELECTION_RANGES_H
+
+#include <atk/atk.h>
+#include <dbus/dbus.h>
+
+G_BEGIN_DECLS
+
+typedef struct _SpiRange SpiRange;
+struct _SpiRange
+{
+  gint start;
+  gint count;
+};
+
+typedef struct _SpiSelectionChange SpiSelectionChange;
+struct _SpiSelectionChange
+{
+  gboolean selected;
+  gint start;
+  gint count;
+};
+
+GArray *spi_ranges_from_indices (gint *indices, gint n_indices);
+
+GArray *spi_selection_ranges_get_children (AtkSelection *selection);
+
+void spi_ranges_append (DBusMessageIter *iter, GArray *ranges);
+
+void spi_selection_ranges_track (AtkObject *obj, GArray *children);
+
+void spi_selection_ranges_untrack_all (void);
+
+GArray *spi_selection_ranges_get_changes (AtkObject *obj);
+
+G_END_DECLS
+
+#endif /* SELECTION_RANGES_H */
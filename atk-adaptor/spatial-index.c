@@ -0,0 +1,695 @@
+/*
+ * AT-SPI - Assistive Technology Service Provider Interface
+ * (Gnome Accessibility Project; http://developer.gnome.org/projects/gap)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <string.h>
+
+#include "spatial-index.h"
+
+/*
+ * Toolkits usually answer atk_component_ref_accessible_at_point by asking
+ * each child in turn whether it contains the point, which is slow for
+ * containers with many children, and ATs reviewing the screen with the
+ * mouse ask on every pointer motion.
+ *
+ * When enabled, the bridge keeps an R-tree of the extents of the children
+ * of such containers, so that only the few children whose extents contain
+ * the point need to be asked. The extents are stored relative to the
+ * container, so that moving the container does not affect them. An index
+ * is built the first time a container is hit tested, is updated when one
+ * of its children reports new bounds, and is dropped when its children
+ * change. The index only holds weak references on the children, so that
+ * a toolkit that drops a child without telling does not leave it alive.
+ *
+ * The index is only a hint: the child it finds is checked with
+ * atk_component_contains, and the toolkit is asked whenever the index
+ * finds nothing, or is found to be stale.
+ */
+
+#define SPI_SPATIAL_INDEX "spi-spatial-index"
+
+/* Containers with fewer children are hit tested by the toolkit */
+#define MIN_INDEXED_CHILDREN 64
+
+#define RTREE_MAX_ENTRIES 8
+#define RTREE_MIN_ENTRIES 3
+
+typedef struct _Box
+{
+  gint x1, y1, x2, y2; /* x2 and y2 are excluded */
+} Box;
+
+typedef struct _RNode RNode;
+typedef struct _IndexItem IndexItem;
+
+typedef struct _REntry
+{
+  Box box;
+  RNode *child;    /* In inner nodes */
+  IndexItem *item; /* In leaves */
+} REntry;
+
+struct _RNode
+{
+  RNode *parent;
+  gboolean leaf;
+  gint n_entries;
+  REntry entries[RTREE_MAX_ENTRIES + 1]; /* One more, until it is split */
+};
+
+struct _IndexItem
+{
+  AtkObject *accessible;
+  gint index_in_parent;
+  Box box;
+  RNode *leaf;
+};
+
+typedef struct _SpatialIndex
+{
+  RNode *root;
+  GHashTable *items; /* AtkObject * -> IndexItem * */
+} SpatialIndex;
+
+static gboolean spatial_index_enabled = FALSE;
+
+/*---------------------------------------------------------------------------*/
+
+static void
+box_union (Box *dest, const Box *src)
+{
+  dest->x1 = MIN (dest->x1, src->x1);
+  dest->y1 = MIN (dest->y1, src->y1);
+  dest->x2 = MAX (dest->x2, src->x2);
+  dest->y2 = MAX (dest->y2, src->y2);
+}
+
+static gint64
+box_area (const Box *box)
+{
+  return (gint64) (box->x2 - box->x1) * (box->y2 - box->y1);
+}
+
+static gint64
+box_enlargement (const Box *box, const Box *added)
+{
+  Box u = *box;
+
+  box_union (&u, added);
+  return box_area (&u) - box_area (box);
+}
+
+static gboolean
+box_contains (const Box *box, gint x, gint y)
+{
+  return (x >= box->x1 && x < box->x2 && y >= box->y1 && y < box->y2);
+}
+
+static Box
+node_box (RNode *node)
+{
+  Box box = node->entries[0].box;
+  gint i;
+
+  for (i = 1; i < node->n_entries; i++)
+    box_union (&box, &node->entries[i].box);
+  return box;
+}
+
+static void
+node_add_entry (RNode *node, const REntry *entry)
+{
+  node->entries[node->n_entries] = *entry;
+  if (entry->child)
+    entry->child->parent = node;
+  else
+    entry->item->leaf = node;
+  node->n_entries++;
+}
+
+static gint
+node_entry_index (RNode *node, RNode *child)
+{
+  gint i;
+
+  for (i = 0; i < node->n_entries; i++)
+    if (node->entries[i].child == child)
+      return i;
+  g_assert_not_reached ();
+  return -1;
+}
+
+static void
+node_remove_entry (RNode *node, gint i)
+{
+  node->n_entries--;
+  if (i < node->n_entries)
+    node->entries[i] = node->entries[node->n_entries];
+}
+
+static RNode *
+node_new (gboolean leaf)
+{
+  RNode *node = g_new0 (RNode, 1);
+
+  node->leaf = leaf;
+  return node;
+}
+
+static void
+node_free (RNode *node)
+{
+  gint i;
+
+  if (!node->leaf)
+    for (i = 0; i < node->n_entries; i++)
+      node_free (node->entries[i].child);
+  g_free (node);
+}
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * Picks the two entries to start a split with: those furthest apart along
+ * the axis on which they are the most separated, relative to the width of
+ * the node along that axis (Guttman's linear split).
+ */
+static void
+pick_seeds (REntry *entries, gint n, gint *seed1, gint *seed2)
+{
+  gdouble best = -G_MAXDOUBLE;
+  gint axis;
+
+  *seed1 = 0;
+  *seed2 = 1;
+  for (axis = 0; axis < 2; axis++)
+    {
+      gint highest_low = 0, lowest_high = 0;
+      gint lo = G_MAXINT, hi = G_MININT;
+      gdouble separation;
+      gint i;
+
+      for (i = 0; i < n; i++)
+        {
+          const Box *b = &entries[i].box;
+          gint b1 = (axis ? b->y1 : b->x1), b2 = (axis ? b->y2 : b->x2);
+          const Box *h = &entries[highest_low].box;
+          const Box *l = &entries[lowest_high].box;
+
+          if (b1 > (axis ? h->y1 : h->x1))
+            highest_low = i;
+          if (b2 < (axis ? l->y2 : l->x2))
+            lowest_high = i;
+          lo = MIN (lo, b1);
+          hi = MAX (hi, b2);
+        }
+      if (highest_low == lowest_high)
+        continue;
+
+      separation = (axis ? entries[highest_low].box.y1 - entries[lowest_high].box.y2
+                         : entries[highest_low].box.x1 - entries[lowest_high].box.x2);
+      separation /= MAX (hi - lo, 1);
+      if (separation > best)
+        {
+          best = separation;
+          *seed1 = lowest_high;
+          *seed2 = highest_low;
+        }
+    }
+}
+
+/* Moves about half of the entries of an overflowing node to a new one */
+static RNode *
+split_node (RNode *node)
+{
+  REntry entries[RTREE_MAX_ENTRIES + 1];
+  RNode *sibling;
+  Box box1, box2;
+  gint n = node->n_entries;
+  gint remaining = n - 2;
+  gint seed1, seed2;
+  gint i;
+
+  memcpy (entries, node->entries, n * sizeof (REntry));
+  pick_seeds (entries, n, &seed1, &seed2);
+
+  sibling = node_new (node->leaf);
+  node->n_entries = 0;
+  node_add_entry (node, &entries[seed1]);
+  node_add_entry (sibling, &entries[seed2]);
+  box1 = entries[seed1].box;
+  box2 = entries[seed2].box;
+
+  for (i = 0; i < n; i++)
+    {
+      gint64 grow1, grow2;
+      gboolean first;
+
+      if (i == seed1 || i == seed2)
+        continue;
+
+      /* Make sure that both nodes end up with enough entries */
+      if (node->n_entries + remaining == RTREE_MIN_ENTRIES)
+        first = TRUE;
+      else if (sibling->n_entries + remaining == RTREE_MIN_ENTRIES)
+        first = FALSE;
+      else
+        {
+          grow1 = box_enlargement (&box1, &entries[i].box);
+          grow2 = box_enlargement (&box2, &entries[i].box);
+          if (grow1 != grow2)
+            first = (grow1 < grow2);
+          else if (box_area (&box1) != box_area (&box2))
+            first = (box_area (&box1) < box_area (&box2));
+          else
+            first = (node->n_entries <= sibling->n_entries);
+        }
+
+      if (first)
+        {
+          node_add_entry (node, &entries[i]);
+          box_union (&box1, &entries[i].box);
+        }
+      else
+        {
+          node_add_entry (sibling, &entries[i]);
+          box_union (&box2, &entries[i].box);
+        }
+      remaining--;
+    }
+
+  return sibling;
+}
+
+/*
+ * Walks up from a node that was just added to, splitting the nodes that
+ * overflow and updating the boxes of their ancestors.
+ */
+static void
+adjust_tree (SpatialIndex *index, RNode *node)
+{
+  while (node)
+    {
+      RNode *parent = node->parent;
+      RNode *sibling = NULL;
+      REntry entry = { 0 };
+
+      if (node->n_entries > RTREE_MAX_ENTRIES)
+        sibling = split_node (node);
+
+      if (!parent)
+        {
+          if (sibling)
+            {
+              index->root = node_new (FALSE);
+              entry.box = node_box (node);
+              entry.child = node;
+              node_add_entry (index->root, &entry);
+              entry.box = node_box (sibling);
+              entry.child = sibling;
+              node_add_entry (index->root, &entry);
+            }
+          return;
+        }
+
+      parent->entries[node_entry_index (parent, node)].box = node_box (node);
+      if (sibling)
+        {
+          entry.box = node_box (sibling);
+          entry.child = sibling;
+          node_add_entry (parent, &entry);
+        }
+      node = parent;
+    }
+}
+
+static void
+insert_item (SpatialIndex *index, IndexItem *item)
+{
+  RNode *node = index->root;
+  REntry entry = { 0 };
+
+  /* Descend to the leaf whose box needs to grow the least */
+  while (!node->leaf)
+    {
+      gint i, best = 0;
+      gint64 best_grow = G_MAXINT64;
+
+      for (i = 0; i < node->n_entries; i++)
+        {
+          gint64 grow = box_enlargement (&node->entries[i].box, &item->box);
+
+          if (grow < best_grow ||
+              (grow == best_grow &&
+               box_area (&node->entries[i].box) < box_area (&node->entries[best].box)))
+            {
+              best = i;
+              best_grow = grow;
+            }
+        }
+      node = node->entries[best].child;
+    }
+
+  entry.box = item->box;
+  entry.item = item;
+  node_add_entry (node, &entry);
+  adjust_tree (index, node);
+}
+
+static void
+collect_items (RNode *node, GPtrArray *items)
+{
+  gint i;
+
+  for (i = 0; i < node->n_entries; i++)
+    {
+      if (node->leaf)
+        g_ptr_array_add (items, node->entries[i].item);
+      else
+        collect_items (node->entries[i].child, items);
+    }
+}
+
+/*
+ * Removes an item from its leaf. Nodes left with too few entries are
+ * removed from the tree, and their items inserted again.
+ */
+static void
+remove_item (SpatialIndex *index, IndexItem *item)
+{
+  GPtrArray *orphans;
+  RNode *node = item->leaf;
+  gint j;
+  guint i;
+
+  for (j = 0; j < node->n_entries; j++)
+    if (node->entries[j].item == item)
+      break;
+  g_return_if_fail (j < node->n_entries);
+  node_remove_entry (node, j);
+  item->leaf = NULL;
+
+  orphans = g_ptr_array_new ();
+
+  while (node->parent)
+    {
+      RNode *parent = node->parent;
+      gint entry_index = node_entry_index (parent, node);
+
+      if (node->n_entries < RTREE_MIN_ENTRIES)
+        {
+          node_remove_entry (parent, entry_index);
+          collect_items (node, orphans);
+          node_free (node);
+        }
+      else
+        parent->entries[entry_index].box = node_box (node);
+      node = parent;
+    }
+
+  while (!index->root->leaf && index->root->n_entries <= 1)
+    {
+      RNode *root = index->root;
+
+      if (root->n_entries == 0)
+        {
+          index->root = node_new (TRUE);
+        }
+      else
+        {
+          index->root = root->entries[0].child;
+          index->root->parent = NULL;
+          root->n_entries = 0;
+        }
+      node_free (root);
+    }
+
+  for (i = 0; i < orphans->len; i++)
+    insert_item (index, g_ptr_array_index (orphans, i));
+  g_ptr_array_free (orphans, TRUE);
+}
+
+static void
+search_point (RNode *node, gint x, gint y, GPtrArray *items)
+{
+  gint i;
+
+  for (i = 0; i < node->n_entries; i++)
+    {
+      if (!box_contains (&node->entries[i].box, x, y))
+        continue;
+      if (node->leaf)
+        g_ptr_array_add (items, node->entries[i].item);
+      else
+        search_point (node->entries[i].child, x, y, items);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+
+static void
+index_item_free (IndexItem *item)
+{
+  g_free (item);
+}
+
+static void
+child_finalized (gpointer data, GObject *where_the_object_was)
+{
+  SpatialIndex *index = data;
+  IndexItem *item;
+
+  item = g_hash_table_lookup (index->items, where_the_object_was);
+  if (!item)
+    return;
+  remove_item (index, item);
+  g_hash_table_remove (index->items, where_the_object_was);
+}
+
+static void
+add_item (SpatialIndex *index,
+          AtkObject *child,
+          gint index_in_parent,
+          const Box *box)
+{
+  IndexItem *item = g_new0 (IndexItem, 1);
+
+  item->accessible = child;
+  item->index_in_parent = index_in_parent;
+  item->box = *box;
+  g_hash_table_insert (index->items, child, item);
+  g_object_weak_ref (G_OBJECT (child), child_finalized, index);
+  insert_item (index, item);
+}
+
+static void
+spatial_index_free (SpatialIndex *index)
+{
+  GHashTableIter iter;
+  gpointer child;
+
+  g_hash_table_iter_init (&iter, index->items);
+  while (g_hash_table_iter_next (&iter, &child, NULL))
+    g_object_weak_unref (G_OBJECT (child), child_finalized, index);
+  node_free (index->root);
+  g_hash_table_destroy (index->items);
+  g_free (index);
+}
+
+/* Gets the box of a child, relative to the container */
+static gboolean
+get_child_box (AtkObject *container, AtkObject *child, Box *box)
+{
+  gint cx, cy, x, y, width, height;
+
+  if (!ATK_IS_COMPONENT (child))
+    return FALSE;
+
+  atk_component_get_extents (ATK_COMPONENT (container), &cx, &cy, NULL, NULL,
+                             ATK_XY_WINDOW);
+  atk_component_get_extents (ATK_COMPONENT (child), &x, &y, &width, &height,
+                             ATK_XY_WINDOW);
+  if (width <= 0 || height <= 0)
+    return FALSE;
+
+  box->x1 = x - cx;
+  box->y1 = y - cy;
+  box->x2 = box->x1 + width;
+  box->y2 = box->y1 + height;
+  return TRUE;
+}
+
+static SpatialIndex *
+build_index (AtkObject *container)
+{
+  SpatialIndex *index;
+  AtkStateSet *set;
+  gboolean manages_descendants;
+  gint i, n_children;
+
+  n_children = atk_object_get_n_accessible_children (container);
+  if (n_children < MIN_INDEXED_CHILDREN)
+    return NULL;
+
+  /* Such containers create their children on demand; don't walk them */
+  set = atk_object_ref_state_set (container);
+  manages_descendants = (set && atk_state_set_contains_state (set, ATK_STATE_MANAGES_DESCENDANTS));
+  g_clear_object (&set);
+  if (manages_descendants)
+    return NULL;
+
+  index = g_new0 (SpatialIndex, 1);
+  index->root = node_new (TRUE);
+  index->items = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+                                        (GDestroyNotify) index_item_free);
+
+  for (i = 0; i < n_children; i++)
+    {
+      AtkObject *child = atk_object_ref_accessible_child (container, i);
+      Box box;
+
+      if (!child)
+        continue;
+      if (get_child_box (container, child, &box) &&
+          !g_hash_table_contains (index->items, child))
+        add_item (index, child, i, &box);
+      g_object_unref (child);
+    }
+
+  g_object_set_data_full (G_OBJECT (container), SPI_SPATIAL_INDEX, index,
+                          (GDestroyNotify) spatial_index_free);
+  return index;
+}
+
+static gint
+compare_items (gconstpointer a, gconstpointer b)
+{
+  const IndexItem *item_a = *(IndexItem **) a, *item_b = *(IndexItem **) b;
+
+  return item_a->index_in_parent - item_b->index_in_parent;
+}
+
+/*---------------------------------------------------------------------------*/
+
+void
+spi_spatial_index_enable (void)
+{
+  spatial_index_enabled = TRUE;
+}
+
+/*
+ * Looks up the child of component at the given point in its index,
+ * building the index if needed. Returns FALSE if the toolkit should be
+ * asked instead; otherwise *child is set to a new reference to the child.
+ */
+gboolean
+spi_spatial_index_ref_accessible_at_point (AtkComponent *component,
+                                           gint x,
+                                           gint y,
+                                           AtkCoordType coord_type,
+                                           AtkObject **child)
+{
+  AtkObject *container = ATK_OBJECT (component);
+  SpatialIndex *index;
+  GPtrArray *candidates;
+  gint cx, cy;
+  guint i;
+
+  *child = NULL;
+  if (!spatial_index_enabled || coord_type == ATK_XY_PARENT)
+    return FALSE;
+
+  index = g_object_get_data (G_OBJECT (container), SPI_SPATIAL_INDEX);
+  if (!index)
+    index = build_index (container);
+  if (!index)
+    return FALSE;
+
+  atk_component_get_extents (component, &cx, &cy, NULL, NULL, coord_type);
+
+  candidates = g_ptr_array_new ();
+  search_point (index->root, x - cx, y - cy, candidates);
+  g_ptr_array_sort (candidates, compare_items);
+
+  /* Answer as the toolkit would: the first child containing the point */
+  for (i = 0; i < candidates->len; i++)
+    {
+      IndexItem *item = g_ptr_array_index (candidates, i);
+
+      if (atk_component_contains (ATK_COMPONENT (item->accessible), x, y,
+                                  coord_type))
+        {
+          *child = g_object_ref (item->accessible);
+          break;
+        }
+    }
+
+  /* A candidate that does not contain the point means that the index is stale */
+  if (!*child && candidates->len)
+    g_object_set_data (G_OBJECT (container), SPI_SPATIAL_INDEX, NULL);
+
+  g_ptr_array_free (candidates, TRUE);
+  return (*child != NULL);
+}
+
+void
+spi_spatial_index_bounds_changed (AtkObject *accessible)
+{
+  AtkObject *container;
+  SpatialIndex *index;
+  IndexItem *item;
+  Box box;
+
+  if (!spatial_index_enabled)
+    return;
+
+  container = atk_object_get_parent (accessible);
+  if (!container)
+    return;
+  index = g_object_get_data (G_OBJECT (container), SPI_SPATIAL_INDEX);
+  if (!index)
+    return;
+  item = g_hash_table_lookup (index->items, accessible);
+  if (!item)
+    {
+      /* A child that had no extents when the index was built */
+      if (get_child_box (container, accessible, &box))
+        add_item (index, accessible,
+                  atk_object_get_index_in_parent (accessible), &box);
+      return;
+    }
+
+  remove_item (index, item);
+  if (get_child_box (container, accessible, &item->box))
+    insert_item (index, item);
+  else
+    {
+      g_object_weak_unref (G_OBJECT (accessible), child_finalized, index);
+      g_hash_table_remove (index->items, accessible);
+    }
+}
+
+void
+spi_spatial_index_children_changed (AtkObject *accessible)
+{
+  if (spatial_index_enabled)
+    g_object_set_data (G_OBJECT (accessible), SPI_SPATIAL_INDEX, NULL);
+}
+
+/*END------------------------------------------------------------------------*/
@@ -0,0 +1,42 @@
+/*
+ * AT-SPI - Assistive Technology Service Provider Interface
+ * (Gnome Accessibility Project; http://developer.gnome.org/projects/gap)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include <atk/atk.h>
+
+G_BEGIN_DECLS
+
+void spi_spatial_index_enable (void);
+
+gboolean spi_spatial_index_ref_accessible_at_point (AtkComponent *component,
+                                                    gint x,
+                                                    gint y,
+                                                    AtkCoordType coord_type,
+                                                    AtkObject **child);
+
+void spi_spatial_index_bounds_changed (AtkObject *accessible);
+
+void spi_spatial_index_children_changed (AtkObject *accessible);
+
+G_END_DECLS
+
+#endif /* SPATIAL_INDEX_H */
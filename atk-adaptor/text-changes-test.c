@@ -0,0 +1,170 @@
+/*
+ * AT-SPI - Assistive Technology Service Provider Interface
+ * (Gnome Accessibility Project; http://developer.gnome.org/projects/gap)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <glib.h>
+#include <string.h>
+
+#include "text-changes.h"
+
+#define MAX_STEPS 4
+
+typedef struct
+{
+  gboolean insert;
+  gint offset;
+  const gchar *text;
+} TextStep;
+
+/*
+ * Each case applies steps to text and checks the changes reported for
+ * them, written as "+offset:text" for an insertion and "-offset:text"
+ * for a removal.
+ */
+typedef struct
+{
+  const gchar *name;
+  const gchar *text;
+  TextStep steps[MAX_STEPS + 1];
+  const gchar *expected;
+} TextChangesCase;
+
+static const TextChangesCase cases[] = {
+  { "insert", "abcdefghij", { { TRUE, 3, "XY" } }, "+3:XY" },
+  { "typing", "abcdefghij", { { TRUE, 3, "X" }, { TRUE, 4, "Y" }, { TRUE, 5, "Z" } }, "+3:XYZ" },
+  { "insert-before-insert", "abcdefghij", { { TRUE, 3, "X" }, { TRUE, 3, "Y" } }, "+3:YX" },
+  { "insert-inside-insert", "abcdefghij", { { TRUE, 3, "XY" }, { TRUE, 4, "Z" } }, "+3:XZY" },
+  { "separate-inserts", "abcdefghij", { { TRUE, 6, "Y" }, { TRUE, 1, "X" } }, "+1:X +7:Y" },
+  { "backspace", "abcdefghij", { { FALSE, 5, "f" }, { FALSE, 4, "e" }, { FALSE, 3, "d" } }, "-3:def" },
+  { "forward-delete", "abcdefghij", { { FALSE, 3, "d" }, { FALSE, 3, "e" } }, "-3:de" },
+  { "separate-deletes", "abcdefghij", { { FALSE, 1, "b" }, { FALSE, 5, "g" } }, "-1:b -5:g" },
+  { "replace", "abcdefghij", { { FALSE, 2, "cd" }, { TRUE, 2, "XY" } }, "-2:cd +2:XY" },
+  { "insert-then-delete", "abcdefghij", { { TRUE, 2, "XYZ" }, { FALSE, 2, "XYZ" } }, "" },
+  { "delete-then-insert", "abcdefghij", { { FALSE, 3, "de" }, { TRUE, 3, "d" }, { TRUE, 4, "e" } }, "" },
+  { "delete-inside-insert", "abcdefghij", { { TRUE, 2, "XYZ" }, { FALSE, 3, "Y" } }, "+2:XZ" },
+  { "delete-overlapping-insert", "abcdefghij", { { TRUE, 2, "XY" }, { FALSE, 1, "bXY" } }, "-1:b" },
+  { "delete-across-inserts", "abcdefghij", { { TRUE, 1, "X" }, { TRUE, 5, "Y" }, { FALSE, 1, "XbcdY" } }, "-1:bcd" },
+  { "delete-keeping-insert-ends", "abcdefghij", { { TRUE, 2, "XYZ" }, { FALSE, 3, "YZcd" } }, "-2:cd +2:X" },
+  { "join-adjacent-edits", "abcdefghij", { { FALSE, 2, "c" }, { FALSE, 3, "e" }, { FALSE, 2, "d" } }, "-2:cde" },
+  { "multibyte", "a\xc3\xb1" "b", { { TRUE, 1, "\xc3\xa9" }, { FALSE, 2, "\xc3\xb1" } }, "-1:\xc3\xb1 +1:\xc3\xa9" },
+};
+
+static gchar *
+apply_change (const gchar *text, gboolean insert, gint offset, gint length, const gchar *change)
+{
+  const gchar *p = g_utf8_offset_to_pointer (text, offset);
+  GString *result = g_string_new_len (text, p - text);
+
+  if (insert)
+    g_string_append (result, change);
+  else
+    {
+      const gchar *q = g_utf8_offset_to_pointer (p, length);
+      g_assert_true (strncmp (p, change, q - p) == 0);
+      p = q;
+    }
+  g_string_append (result, p);
+  return g_string_free (result, FALSE);
+}
+
+typedef struct
+{
+  GString *reported;
+  gchar *text;
+} Replay;
+
+static void
+replay_change (gboolean insert, gint offset, gint length, const gchar *text, gpointer user_data)
+{
+  Replay *replay = user_data;
+  gchar *new_text;
+
+  if (replay->reported->len)
+    g_string_append_c (replay->reported, ' ');
+  g_string_append_printf (replay->reported, "%c%d:%s", insert ? '+' : '-', offset, text);
+
+  new_text = apply_change (replay->text, insert, offset, length, text);
+  g_free (replay->text);
+  replay->text = new_text;
+}
+
+static void
+test_text_changes (gconstpointer data)
+{
+  const TextChangesCase *test = data;
+  SpiTextChanges *changes = spi_text_changes_new ();
+  gchar *text = g_strdup (test->text);
+  Replay replay;
+  const TextStep *step;
+
+  for (step = test->steps; step->text; step++)
+    {
+      gint length = g_utf8_strlen (step->text, -1);
+      gchar *new_text = apply_change (text, step->insert, step->offset, length, step->text);
+
+      if (step->insert)
+        g_assert_true (spi_text_changes_insert (changes, step->offset, length, step->text));
+      else
+        g_assert_true (spi_text_changes_delete (changes, step->offset, length, step->text));
+      g_free (text);
+      text = new_text;
+    }
+
+  /* The reported changes must turn the original text into the current one */
+  replay.reported = g_string_new (NULL);
+  replay.text = g_strdup (test->text);
+  spi_text_changes_foreach (changes, replay_change, &replay);
+  g_assert_cmpstr (replay.reported->str, ==, test->expected);
+  g_assert_cmpstr (replay.text, ==, text);
+
+  g_string_free (replay.reported, TRUE);
+  g_free (replay.text);
+  g_free (text);
+  spi_text_changes_free (changes);
+}
+
+static void
+test_text_changes_invalid (void)
+{
+  SpiTextChanges *changes = spi_text_changes_new ();
+
+  g_assert_false (spi_text_changes_insert (changes, 0, 2, "X"));
+  g_assert_false (spi_text_changes_delete (changes, 0, 1, NULL));
+  g_assert_false (spi_text_changes_delete (changes, -1, 1, "X"));
+  g_assert_true (spi_text_changes_insert (changes, 0, 0, NULL));
+  spi_text_changes_free (changes);
+}
+
+int
+main (int argc, char **argv)
+{
+  guint i;
+
+  g_test_init (&argc, &argv, NULL);
+
+  for (i = 0; i < G_N_ELEMENTS (cases); i++)
+    {
+      gchar *path = g_strdup_printf ("/text-changes/%s", cases[i].name);
+      g_test_add_data_func (path, &cases[i], test_text_changes);
+      g_free (path);
+    }
+  g_test_add_func ("/text-changes/invalid", test_text_changes_invalid);
+
+  return g_test_run ();
+}
@@ -0,0 +1,305 @@
+/*
+ * AT-SPI - Assistive Technology Service Provider Interface
+ * (Gnome Accessibility Project; http://developer.gnome.org/projects/gap)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <string.h>
+
+#include "text-changes.h"
+
+/*
+ * This module folds a stream of text insertions and removals on a single
+ * object into the smallest equivalent list of replacements.
+ *
+ * Each replacement is stored relative to the text as it was before the
+ * first recorded change: it replaces deleted_len characters at start with
+ * the inserted text. Replacements are kept sorted and are never adjacent
+ * (there is always at least one untouched character between two of them),
+ * so an incoming change touches at most a contiguous run of them, which is
+ * then merged into one.
+ *
+ * Offsets of incoming changes are relative to the current text, and are
+ * mapped back by subtracting the size change of the replacements preceding
+ * them. When the replacements are played back in order, each one is
+ * rebased in the same way, so the emitted offsets are valid for the text as
+ * it is after the previous ones have been applied.
+ *
+ * All offsets and lengths are in characters, as in ATK.
+ */
+
+typedef struct _TextEdit
+{
+  gint start;
+  gint deleted_len;
+  GString *deleted;
+  gint inserted_len;
+  GString *inserted;
+} TextEdit;
+
+struct _SpiTextChanges
+{
+  GArray *edits;
+};
+
+/*---------------------------------------------------------------------------*/
+
+static void
+text_edit_clear (TextEdit *edit)
+{
+  g_string_free (edit->deleted, TRUE);
+  g_string_free (edit->inserted, TRUE);
+}
+
+SpiTextChanges *
+spi_text_changes_new (void)
+{
+  SpiTextChanges *changes;
+
+  changes = g_new0 (SpiTextChanges, 1);
+  changes->edits = g_array_new (FALSE, FALSE, sizeof (TextEdit));
+  g_array_set_clear_func (changes->edits, (GDestroyNotify) text_edit_clear);
+
+  return changes;
+}
+
+void
+spi_text_changes_free (SpiTextChanges *changes)
+{
+  g_array_free (changes->edits, TRUE);
+  g_free (changes);
+}
+
+/*---------------------------------------------------------------------------*/
+
+/* Appends n_chars characters of src, starting at character start */
+static void
+append_chars (GString *dest, const gchar *src, gint start, gint n_chars)
+{
+  const gchar *p, *q;
+
+  if (n_chars <= 0)
+    return;
+  p = g_utf8_offset_to_pointer (src, start);
+  q = g_utf8_offset_to_pointer (p, n_chars);
+  g_string_append_len (dest, p, q - p);
+}
+
+static gboolean
+change_is_valid (gint offset, gint length, const gchar *text)
+{
+  return (offset >= 0 && text != NULL &&
+          g_utf8_validate (text, -1, NULL) &&
+          g_utf8_strlen (text, -1) == length);
+}
+
+/*
+ * Records an insertion of length characters at offset. Returns FALSE if
+ * the change could not be recorded (because the text does not match the
+ * length, for instance), in which case the caller should emit the changes
+ * recorded so far and then this one on its own.
+ */
+gboolean
+spi_text_changes_insert (SpiTextChanges *changes,
+                         gint offset,
+                         gint length,
+                         const gchar *text)
+{
+  TextEdit edit;
+  gint delta = 0;
+  guint i;
+
+  if (length == 0)
+    return TRUE;
+  if (!change_is_valid (offset, length, text))
+    return FALSE;
+
+  for (i = 0; i < changes->edits->len; i++)
+    {
+      TextEdit *e = &g_array_index (changes->edits, TextEdit, i);
+      gint cs = e->start + delta;
+      gint ce = cs + e->inserted_len;
+
+      if (offset < cs)
+        break;
+      if (offset <= ce)
+        {
+          /* Inside or at either end of text we already inserted */
+          const gchar *p = g_utf8_offset_to_pointer (e->inserted->str, offset - cs);
+          g_string_insert (e->inserted, p - e->inserted->str, text);
+          e->inserted_len += length;
+          /* Removing text and then typing it back leaves nothing to report */
+          if (e->deleted_len == e->inserted_len &&
+              !strcmp (e->deleted->str, e->inserted->str))
+            g_array_remove_index (changes->edits, i);
+          return TRUE;
+        }
+      delta += e->inserted_len - e->deleted_len;
+    }
+
+  edit.start = offset - delta;
+  edit.deleted_len = 0;
+  edit.deleted = g_string_new (NULL);
+  edit.inserted_len = length;
+  edit.inserted = g_string_new (text);
+  g_array_insert_val (changes->edits, i, edit);
+  return TRUE;
+}
+
+/*
+ * Records the removal of length characters at offset; text is the text
+ * that was removed. Returns FALSE if the change could not be recorded.
+ */
+gboolean
+spi_text_changes_delete (SpiTextChanges *changes,
+                         gint offset,
+                         gint length,
+                         const gchar *text)
+{
+  TextEdit merged;
+  gint end = offset + length;
+  gint delta = 0, first_delta = 0;
+  gint first = -1, last = -1;
+  gint pos;
+  guint i;
+
+  if (length == 0)
+    return TRUE;
+  if (!change_is_valid (offset, length, text))
+    return FALSE;
+
+  /* Find the replacements the removed range overlaps or touches */
+  for (i = 0; i < changes->edits->len; i++)
+    {
+      TextEdit *e = &g_array_index (changes->edits, TextEdit, i);
+      gint cs = e->start + delta;
+      gint ce = cs + e->inserted_len;
+
+      if (cs > end)
+        break;
+      if (ce >= offset)
+        {
+          if (first < 0)
+            {
+              first = i;
+              first_delta = delta;
+            }
+          last = i;
+        }
+      delta += e->inserted_len - e->deleted_len;
+    }
+
+  if (first < 0)
+    {
+      /* Only untouched text was removed */
+      merged.start = offset - delta;
+      merged.deleted_len = length;
+      merged.deleted = g_string_new (text);
+      merged.inserted_len = 0;
+      merged.inserted = g_string_new (NULL);
+      g_array_insert_val (changes->edits, i, merged);
+      return TRUE;
+    }
+
+  /*
+   * Walk the removed range, collecting the original text it covers into
+   * the merged replacement's deleted text, and keeping whatever inserted
+   * text falls outside of it.
+   */
+  merged.deleted_len = 0;
+  merged.deleted = g_string_new (NULL);
+  merged.inserted_len = 0;
+  merged.inserted = g_string_new (NULL);
+
+  delta = first_delta;
+  pos = offset;
+  for (i = first; i <= last; i++)
+    {
+      TextEdit *e = &g_array_index (changes->edits, TextEdit, i);
+      gint cs = e->start + delta;
+      gint ce = cs + e->inserted_len;
+
+      if (i == first)
+        merged.start = (offset < cs ? offset - delta : e->start);
+
+      if (pos < cs)
+        {
+          append_chars (merged.deleted, text, pos - offset, cs - pos);
+          merged.deleted_len += cs - pos;
+          pos = cs;
+        }
+      if (cs < offset)
+        {
+          append_chars (merged.inserted, e->inserted->str, 0, offset - cs);
+          merged.inserted_len += offset - cs;
+        }
+      g_string_append_len (merged.deleted, e->deleted->str, e->deleted->len);
+      merged.deleted_len += e->deleted_len;
+      if (ce > end)
+        {
+          append_chars (merged.inserted, e->inserted->str, end - cs, ce - end);
+          merged.inserted_len += ce - end;
+        }
+      pos = MAX (pos, MIN (ce, end));
+      delta += e->inserted_len - e->deleted_len;
+    }
+  if (pos < end)
+    {
+      append_chars (merged.deleted, text, pos - offset, end - pos);
+      merged.deleted_len += end - pos;
+    }
+
+  g_array_remove_range (changes->edits, first, last - first + 1);
+
+  /* Inserting text and then removing it again leaves nothing to report */
+  if (merged.deleted_len == merged.inserted_len &&
+      !strcmp (merged.deleted->str, merged.inserted->str))
+    text_edit_clear (&merged);
+  else
+    g_array_insert_val (changes->edits, first, merged);
+
+  return TRUE;
+}
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * Calls func for each change needed to turn the original text into the
+ * current one, in order: a removal and/or an insertion per replacement.
+ */
+void
+spi_text_changes_foreach (SpiTextChanges *changes,
+                          SpiTextChangeFunc func,
+                          gpointer user_data)
+{
+  gint delta = 0;
+  guint i;
+
+  for (i = 0; i < changes->edits->len; i++)
+    {
+      TextEdit *e = &g_array_index (changes->edits, TextEdit, i);
+      gint offset = e->start + delta;
+
+      if (e->deleted_len > 0)
+        func (FALSE, offset, e->deleted_len, e->deleted->str, user_data);
+      if (e->inserted_len > 0)
+        func (TRUE, offset, e->inserted_len, e->inserted->str, user_data);
+      delta += e->inserted_len - e->deleted_len;
+    }
+}
+
+/*END------------------------------------------------------------------------*/
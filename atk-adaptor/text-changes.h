@@ -0,0 +1,56 @@
+/*
+ * AT-SPI - Assistive Technology Service Provider Interface
+ * (Gnome Accessibility Project; http://developer.gnome.org/projects/gap)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef TEXT_CHANGES_H
+#define TEXT_CHANGES_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _SpiTextChanges SpiTextChanges;
+
+typedef void (*SpiTextChangeFunc) (gboolean insert,
+                                   gint offset,
+                                   gint length,
+                                   const gchar *text,
+                                   gpointer user_data);
+
+SpiTextChanges *spi_text_changes_new (void);
+
+void spi_text_changes_free (SpiTextChanges *changes);
+
+gboolean spi_text_changes_insert (SpiTextChanges *changes,
+                                  gint offset,
+                                  gint length,
+                                  const gchar *text);
+
+gboolean spi_text_changes_delete (SpiTextChanges *changes,
+                                  gint offset,
+                                  gint length,
+                                  const gchar *text);
+
+void spi_text_changes_foreach (SpiTextChanges *changes,
+                               SpiTextChangeFunc func,
+                               gpointer user_data);
+
+G_END_DECLS
+
+#endif /* TEXT_CHANGES_H */
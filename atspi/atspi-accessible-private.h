@@ -29,6 +29,7 @@
 #include <glib.h>
 
 #include "atspi-accessible.h"
+#include "atspi-component.h"
 #include "atspimarshal.h"
 
 G_BEGIN_DECLS
@@ -38,6 +39,12 @@ struct _AtspiAccessiblePrivate
   GHashTable *cache;
   guint cache_ref_count;
   guint iteration_stamp;
+  AtspiRect extents[ATSPI_COORD_TYPE_COUNT];
+  guint extents_valid;
+  guint extents_generation;
+  guint extents_listener_stamp;
+  gdouble current_value;
+  guint value_listener_stamp;
 };
 
 GHashTable *
@@ -45,6 +52,27 @@ _atspi_accessible_ref_cache (AtspiAccessible *accessible);
 
 void
 _atspi_accessible_unref_cache (AtspiAccessible *accessible);
+
+gboolean
+_atspi_accessible_get_cached_extents (AtspiAccessible *accessible,
+                                      AtspiCoordType ctype,
+                                      AtspiRect *extents);
+
+void
+_atspi_accessible_set_cached_extents (AtspiAccessible *accessible,
+                                      AtspiCoordType ctype,
+                                      const AtspiRect *extents);
+
+void
+_atspi_accessible_invalidate_extents (AtspiAccessible *accessible);
+
+gboolean
+_atspi_accessible_get_cached_value (AtspiAccessible *accessible,
+                                    gdouble *value);
+
+void
+_atspi_accessible_set_cached_value (AtspiAccessible *accessible,
+                                    gdouble value);
 G_END_DECLS
 
 #endif /* _ATSPI_ACCESSIBLE_H_ */
@@ -2005,3 +2005,134 @@ _atspi_accessible_unref_cache (AtspiAccessible *accessible)
         priv->cache = NULL;
     }
 }
+
+/*
+ * Extents caching.
+ *
+ * Extents are cached per coordinate type when ATSPI_CACHE_EXTENTS is in the
+ * cache mask. Since moving or resizing an object usually moves its
+ * descendants too, any bounds change or window event in an application
+ * invalidates the cached extents of all of its objects at once, by bumping a
+ * generation counter attached to the application.
+ *
+ * Cached extents are only trusted while something is listening for
+ * object:bounds-changed, and has been since they were cached, since
+ * otherwise the events that would invalidate them may have been missed.
+ *
+ * Screen extents are not cached: they change whenever a window moves, and
+ * toolkits do not send bounds changes for the objects in a window that
+ * moves, nor does the bridge send window move events.
+ */
+
+static GQuark
+extents_generation_quark (void)
+{
+  static GQuark quark = 0;
+
+  if (!quark)
+    quark = g_quark_from_static_string ("atspi-extents-generation");
+  return quark;
+}
+
+static guint
+get_extents_generation (AtspiAccessible *accessible)
+{
+  return GPOINTER_TO_UINT (g_object_get_qdata (G_OBJECT (accessible->parent.app),
+                                               extents_generation_quark ()));
+}
+
+gboolean
+_atspi_accessible_get_cached_extents (AtspiAccessible *accessible,
+                                      AtspiCoordType ctype,
+                                      AtspiRect *extents)
+{
+  AtspiAccessiblePrivate *priv = accessible->priv;
+
+  if (ctype >= ATSPI_COORD_TYPE_COUNT || !accessible->parent.app ||
+      !_atspi_accessible_test_cache (accessible, ATSPI_CACHE_EXTENTS) ||
+      !(priv->extents_valid & (1 << ctype)) ||
+      priv->extents_generation != get_extents_generation (accessible) ||
+      priv->extents_listener_stamp != _atspi_event_listener_stamp ())
+    return FALSE;
+
+  *extents = priv->extents[ctype];
+  return TRUE;
+}
+
+void
+_atspi_accessible_set_cached_extents (AtspiAccessible *accessible,
+                                      AtspiCoordType ctype,
+                                      const AtspiRect *extents)
+{
+  AtspiAccessiblePrivate *priv = accessible->priv;
+  guint generation;
+
+  if (ctype >= ATSPI_COORD_TYPE_COUNT || ctype == ATSPI_COORD_TYPE_SCREEN ||
+      !accessible->parent.app ||
+      !_atspi_event_is_listened (accessible, "BoundsChanged", NULL))
+    return;
+
+  generation = get_extents_generation (accessible);
+  if (priv->extents_generation != generation ||
+      priv->extents_listener_stamp != _atspi_event_listener_stamp ())
+    {
+      priv->extents_generation = generation;
+      priv->extents_listener_stamp = _atspi_event_listener_stamp ();
+      priv->extents_valid = 0;
+    }
+  priv->extents[ctype] = *extents;
+  priv->extents_valid |= (1 << ctype);
+  _atspi_accessible_add_cache (accessible, ATSPI_CACHE_EXTENTS);
+}
+
+/*
+ * Invalidates the cached extents of every object in the application of
+ * accessible.
+ */
+void
+_atspi_accessible_invalidate_extents (AtspiAccessible *accessible)
+{
+  if (!accessible->parent.app)
+    return;
+
+  g_object_set_qdata (G_OBJECT (accessible->parent.app),
+                      extents_generation_quark (),
+                      GUINT_TO_POINTER (get_extents_generation (accessible) + 1));
+}
+
+/*
+ * Value caching.
+ *
+ * The current value of an object is cached when ATSPI_CACHE_VALUE is in the
+ * cache mask and object:property-change:accessible-value events, which
+ * carry the new value, are being received.
+ */
+
+gboolean
+_atspi_accessible_get_cached_value (AtspiAccessible *accessible,
+                                    gdouble *value)
+{
+  AtspiAccessiblePrivate *priv = accessible->priv;
+
+  if (!_atspi_accessible_test_cache (accessible, ATSPI_CACHE_VALUE) ||
+      priv->value_listener_stamp != _atspi_event_listener_stamp ())
+    return FALSE;
+
+  *value = priv->current_value;
+  return TRUE;
+}
+
+void
+_atspi_accessible_set_cached_value (AtspiAccessible *accessible,
+                                    gdouble value)
+{
+  AtspiAccessiblePrivate *priv = accessible->priv;
+
+  if (!accessible->parent.app ||
+      !_atspi_event_is_listened (accessible, "PropertyChange", "accessible-value"))
+    return;
+
+  priv->current_value = value;
+  priv->value_listener_stamp = _atspi_event_listener_stamp ();
+  _atspi_accessible_add_cache (accessible, ATSPI_CACHE_VALUE);
+}
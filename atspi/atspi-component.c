@@ -174,10 +174,211 @@ atspi_component_get_extents (AtspiComponent *obj,
         }
     }
 
-  _atspi_dbus_call (obj, atspi_interface_component, "GetExtents", error, "u=>(iiii)", d_ctype, &bbox);
+  if (_atspi_accessible_get_cached_extents (accessible, ctype, &bbox))
+    return atspi_rect_copy (&bbox);
+
+  if (_atspi_dbus_call (obj, atspi_interface_component, "GetExtents", error, "u=>(iiii)", d_ctype, &bbox))
+    _atspi_accessible_set_cached_extents (accessible, ctype, &bbox);
   return atspi_rect_copy (&bbox);
 }
 
+#define EXTENTS_BATCH_UNSUPPORTED "atspi-extents-batch-unsupported"
+
+/* Fetches the extents of the components at the given indices one at a time,
+ * for applications whose bridge has no GetExtentsBatch.
+ */
+static void
+get_extents_one_by_one (GPtrArray *components,
+                        GArray *indices,
+                        AtspiCoordType ctype,
+                        GArray *extents)
+{
+  dbus_uint32_t d_ctype = ctype;
+  guint i;
+
+  for (i = 0; i < indices->len; i++)
+    {
+      guint index = g_array_index (indices, guint, i);
+      AtspiAccessible *accessible = g_ptr_array_index (components, index);
+      AtspiRect *rect = &g_array_index (extents, AtspiRect, index);
+
+      if (_atspi_dbus_call (accessible, atspi_interface_component, "GetExtents", NULL, "u=>(iiii)", d_ctype, rect))
+        _atspi_accessible_set_cached_extents (accessible, ctype, rect);
+    }
+}
+
+/* Fetches the extents of the components at the given indices, all from app.
+ * If the application can't be asked, their extents are left at -1s.
+ */
+static void
+get_app_extents (AtspiApplication *app,
+                 GPtrArray *components,
+                 GArray *indices,
+                 AtspiCoordType ctype,
+                 GArray *extents)
+{
+  AtspiAccessible *first = g_ptr_array_index (components, g_array_index (indices, guint, 0));
+  DBusMessage *message, *reply;
+  DBusMessageIter iter, iter_array, iter_struct;
+  DBusError err;
+  dbus_uint32_t d_ctype = ctype;
+  guint i;
+
+  if (g_object_get_data (G_OBJECT (app), EXTENTS_BATCH_UNSUPPORTED))
+    {
+      get_extents_one_by_one (components, indices, ctype, extents);
+      return;
+    }
+
+  message = _atspi_dbus_method_call_new (first, atspi_interface_application,
+                                         "GetExtentsBatch", NULL);
+  if (!message)
+    return;
+  dbus_message_set_path (message, ATSPI_DBUS_PATH_ROOT);
+  dbus_message_iter_init_append (message, &iter);
+  dbus_message_iter_open_container (&iter, DBUS_TYPE_ARRAY, "o", &iter_array);
+  for (i = 0; i < indices->len; i++)
+    {
+      AtspiAccessible *accessible = g_ptr_array_index (components, g_array_index (indices, guint, i));
+      const char *path = accessible->parent.path;
+      dbus_message_iter_append_basic (&iter_array, DBUS_TYPE_OBJECT_PATH, &path);
+    }
+  dbus_message_iter_close_container (&iter, &iter_array);
+  dbus_message_iter_append_basic (&iter, DBUS_TYPE_UINT32, &d_ctype);
+
+  dbus_error_init (&err);
+  reply = _atspi_dbus_send_with_reply_dbus_error (first, message, &err);
+  dbus_message_unref (message);
+  if (!reply)
+    {
+      /* An older bridge, or another toolkit's; don't try again for this
+       * app. Other errors leave this app's components at -1s.
+       */
+      if (dbus_error_has_name (&err, DBUS_ERROR_UNKNOWN_METHOD))
+        {
+          g_object_set_data (G_OBJECT (app), EXTENTS_BATCH_UNSUPPORTED, GINT_TO_POINTER (TRUE));
+          get_extents_one_by_one (components, indices, ctype, extents);
+        }
+      dbus_error_free (&err);
+      return;
+    }
+
+  if (strcmp (dbus_message_get_signature (reply), "a(iiii)") != 0)
+    {
+      g_warning ("AT-SPI: Expected message signature a(iiii) but got %s at %s line %d", dbus_message_get_signature (reply), __FILE__, __LINE__);
+      dbus_message_unref (reply);
+      return;
+    }
+
+  dbus_message_iter_init (reply, &iter);
+  dbus_message_iter_recurse (&iter, &iter_array);
+  for (i = 0; i < indices->len &&
+              dbus_message_iter_get_arg_type (&iter_array) != DBUS_TYPE_INVALID;
+       i++)
+    {
+      guint index = g_array_index (indices, guint, i);
+      AtspiAccessible *accessible = g_ptr_array_index (components, index);
+      AtspiRect *rect = &g_array_index (extents, AtspiRect, index);
+      dbus_int32_t d_int;
+
+      dbus_message_iter_recurse (&iter_array, &iter_struct);
+      dbus_message_iter_get_basic (&iter_struct, &d_int);
+      rect->x = d_int;
+      dbus_message_iter_next (&iter_struct);
+      dbus_message_iter_get_basic (&iter_struct, &d_int);
+      rect->y = d_int;
+      dbus_message_iter_next (&iter_struct);
+      dbus_message_iter_get_basic (&iter_struct, &d_int);
+      rect->width = d_int;
+      dbus_message_iter_next (&iter_struct);
+      dbus_message_iter_get_basic (&iter_struct, &d_int);
+      rect->height = d_int;
+      if (rect->width >= 0)
+        _atspi_accessible_set_cached_extents (accessible, ctype, rect);
+      dbus_message_iter_next (&iter_array);
+    }
+
+  dbus_message_unref (reply);
+}
+
+/**
+ * atspi_component_get_extents_batch:
+ * @components: (element-type AtspiAccessible): the components to query.
+ * @ctype: the desired coordinate system into which to return the results,
+ *         (e.g. ATSPI_COORD_TYPE_WINDOW, ATSPI_COORD_TYPE_SCREEN).
+ *
+ * Gets the bounding boxes of many components at once, with a single call
+ * per application rather than one per component, e.g. to highlight all
+ * the visible items of a list.
+ *
+ * Components whose extents could not be found, including those of
+ * applications that could not be reached, get an #AtspiRect of -1s; the
+ * others are still returned. Applications whose bridge does not support
+ * fetching extents in a batch are asked for each component in turn.
+ *
+ * Returns: (transfer full) (element-type AtspiRect): a #GArray of
+ *          #AtspiRect, in the same order as @components.
+ *
+ * Since: 2.54
+ **/
+GArray *
+atspi_component_get_extents_batch (GPtrArray *components,
+                                   AtspiCoordType ctype,
+                                   GError **error)
+{
+  GArray *extents;
+  GHashTable *apps;
+  GHashTableIter iter;
+  gpointer key, value;
+  guint i;
+
+  g_return_val_if_fail (components != NULL, NULL);
+
+  extents = g_array_sized_new (FALSE, FALSE, sizeof (AtspiRect), components->len);
+  g_array_set_size (extents, components->len);
+
+  /* Group the components that are not in the cache by application */
+  apps = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
+                                (GDestroyNotify) g_array_unref);
+  for (i = 0; i < components->len; i++)
+    {
+      AtspiAccessible *accessible = g_ptr_array_index (components, i);
+      AtspiRect *rect = &g_array_index (extents, AtspiRect, i);
+      GArray *indices;
+
+      rect->x = rect->y = rect->width = rect->height = -1;
+      if (!accessible || !accessible->parent.app)
+        continue;
+
+      if (accessible->priv->cache && ctype == ATSPI_COORD_TYPE_SCREEN)
+        {
+          GValue *val = g_hash_table_lookup (accessible->priv->cache, "Component.ScreenExtents");
+          if (val)
+            {
+              *rect = *(AtspiRect *) g_value_get_boxed (val);
+              continue;
+            }
+        }
+      if (_atspi_accessible_get_cached_extents (accessible, ctype, rect))
+        continue;
+
+      indices = g_hash_table_lookup (apps, accessible->parent.app);
+      if (!indices)
+        {
+          indices = g_array_new (FALSE, FALSE, sizeof (guint));
+          g_hash_table_insert (apps, accessible->parent.app, indices);
+        }
+      g_array_append_val (indices, i);
+    }
+
+  g_hash_table_iter_init (&iter, apps);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    get_app_extents (key, components, value, ctype, extents);
+
+  g_hash_table_destroy (apps);
+  return extents;
+}
+
 /**
  * atspi_component_get_position:
  * @obj: a pointer to the #AtspiComponent to query.
@@ -377,6 +578,8 @@ atspi_component_set_extents (AtspiComponent *obj,
   dbus_message_get_args (reply, NULL, DBUS_TYPE_BOOLEAN, &retval,
                          DBUS_TYPE_INVALID);
   dbus_message_unref (reply);
+  if (retval)
+    _atspi_accessible_invalidate_extents (aobj);
   return retval;
 }
 
@@ -407,6 +610,8 @@ atspi_component_set_position (AtspiComponent *obj,
 
   _atspi_dbus_call (obj, atspi_interface_component, "SetPosition", error,
                     "iiu=>b", d_x, d_y, d_ctype, &ret);
+  if (ret)
+    _atspi_accessible_invalidate_extents (ATSPI_ACCESSIBLE (obj));
 
   return ret;
 }
@@ -434,6 +639,8 @@ atspi_component_set_size (AtspiComponent *obj,
 
   _atspi_dbus_call (obj, atspi_interface_component, "SetSize", error, "ii=>b",
                     d_width, d_height, &ret);
+  if (ret)
+    _atspi_accessible_invalidate_extents (ATSPI_ACCESSIBLE (obj));
 
   return ret;
 }
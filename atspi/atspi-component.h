@@ -89,6 +89,8 @@ AtspiAccessible *atspi_component_get_accessible_at_point (AtspiComponent *obj, g
 
 AtspiRect *atspi_component_get_extents (AtspiComponent *obj, AtspiCoordType ctype, GError **error);
 
+GArray *atspi_component_get_extents_batch (GPtrArray *components, AtspiCoordType ctype, GError **error);
+
 AtspiPoint *atspi_component_get_position (AtspiComponent *obj, AtspiCoordType ctype, GError **error);
 
 AtspiPoint *atspi_component_get_size (AtspiComponent *obj, GError **error);
@@ -1437,6 +1437,8 @@ extern "C"
     ATSPI_CACHE_ROLE = 1 << 5,
     ATSPI_CACHE_INTERFACES = 1 << 6,
     ATSPI_CACHE_ATTRIBUTES = 1 << 7,
+    ATSPI_CACHE_EXTENTS = 1 << 8,
+    ATSPI_CACHE_VALUE = 1 << 9,
     ATSPI_CACHE_ALL = 0x3fffffff,
     ATSPI_CACHE_DEFAULT = ATSPI_CACHE_PARENT | ATSPI_CACHE_CHILDREN | ATSPI_CACHE_NAME | ATSPI_CACHE_DESCRIPTION | ATSPI_CACHE_STATES | ATSPI_CACHE_ROLE | ATSPI_CACHE_INTERFACES,
     ATSPI_CACHE_UNDEFINED = 0x40000000,
@@ -1498,6 +1500,41 @@ extern "C"
     ATSPI_LIVE_ASSERTIVE
   } AtspiLive;
 
+  /**
+   * AtspiTextEditType:
+   * @ATSPI_TEXT_EDIT_SET_CONTENTS: Replaces the whole text with the edit's
+   * text.
+   * @ATSPI_TEXT_EDIT_INSERT: Inserts the edit's text at its start offset.
+   * @ATSPI_TEXT_EDIT_DELETE: Deletes the text between the edit's start and
+   * end offsets.
+   * @ATSPI_TEXT_EDIT_CUT: Cuts the text between the edit's start and end
+   * offsets to the clipboard.
+   * @ATSPI_TEXT_EDIT_COPY: Copies the text between the edit's start and end
+   * offsets to the clipboard.
+   * @ATSPI_TEXT_EDIT_PASTE: Pastes the clipboard at the edit's start offset.
+   *
+   * Enumeration used by atspi_editable_text_apply_edits() to specify the
+   * kind of each edit in a batch.
+   *
+   * Since: 2.54
+   **/
+  typedef enum
+  {
+    ATSPI_TEXT_EDIT_SET_CONTENTS,
+    ATSPI_TEXT_EDIT_INSERT,
+    ATSPI_TEXT_EDIT_DELETE,
+    ATSPI_TEXT_EDIT_CUT,
+    ATSPI_TEXT_EDIT_COPY,
+    ATSPI_TEXT_EDIT_PASTE,
+  } AtspiTextEditType;
+
+/**
+ * ATSPI_TEXT_EDIT_TYPE_COUNT:
+ *
+ * One higher than the highest valid value of #AtspiTextEditType.
+ **/
+#define ATSPI_TEXT_EDIT_TYPE_COUNT (5 + 1)
+
 #define ATSPI_DBUS_NAME_REGISTRY "org.a11y.atspi.Registry"
 #define ATSPI_DBUS_PATH_REGISTRY "/org/a11y/atspi/registry"
 #define ATSPI_DBUS_INTERFACE_REGISTRY "org.a11y.atspi.Registry"
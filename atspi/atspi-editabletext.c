@@ -245,6 +245,73 @@ atspi_editable_text_paste_text (AtspiEditableText *obj,
   return retval;
 }
 
+/**
+ * atspi_editable_text_apply_edits:
+ * @obj: a pointer to the #AtspiEditableText object to modify.
+ * @edits: (element-type AtspiTextEdit): a #GArray of #AtspiTextEdit
+ *         structs, to be applied in order.
+ * @error: (allow-none): a pointer to a %NULL #GError pointer, or %NULL
+ *
+ * Applies a batch of edits to an #AtspiEditableText object in a single
+ * call, rather than one call per edit. The batch is checked against the
+ * text before any of it is applied, and is rejected as a whole if an edit's
+ * offsets are out of range, or if an edit with offsets follows a paste,
+ * whose length can't be known in advance. Toolkits can't report edits they
+ * refuse to make, so a batch that passes the check may still be applied
+ * only in part. The resulting text changes are reported together once the
+ * batch is complete, merged where possible, so listeners are not flooded
+ * with intermediate events.
+ *
+ * Returns: #TRUE if the edits were applied, otherwise #FALSE.
+ *
+ * Since: 2.54
+ **/
+gboolean
+atspi_editable_text_apply_edits (AtspiEditableText *obj,
+                                 GArray *edits,
+                                 GError **error)
+{
+  DBusMessage *message, *reply;
+  DBusMessageIter iter, iter_struct, iter_array;
+  gint i, count;
+  dbus_bool_t retval = FALSE;
+
+  g_return_val_if_fail (obj != NULL, FALSE);
+
+  message = _atspi_dbus_method_call_new (obj, atspi_interface_editable_text,
+                                         "ApplyEdits", error);
+  if (!message)
+    return FALSE;
+  count = (edits ? edits->len : 0);
+
+  dbus_message_iter_init_append (message, &iter);
+  dbus_message_iter_open_container (&iter, DBUS_TYPE_ARRAY, "(iiis)", &iter_array);
+  for (i = 0; i < count; i++)
+    {
+      AtspiTextEdit *item = &g_array_index (edits, AtspiTextEdit, i);
+      dbus_int32_t d_type = item->type;
+      dbus_int32_t d_start_pos = item->start_pos, d_end_pos = item->end_pos;
+      const char *text = (item->text ? item->text : "");
+
+      dbus_message_iter_open_container (&iter_array, DBUS_TYPE_STRUCT, NULL, &iter_struct);
+      dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_INT32, &d_type);
+      dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_INT32, &d_start_pos);
+      dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_INT32, &d_end_pos);
+      dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_STRING, &text);
+      dbus_message_iter_close_container (&iter_array, &iter_struct);
+    }
+  dbus_message_iter_close_container (&iter, &iter_array);
+
+  reply = _atspi_dbus_send_with_reply (obj, message, error);
+  dbus_message_unref (message);
+  if (reply)
+    {
+      dbus_message_get_args (reply, NULL, DBUS_TYPE_BOOLEAN, &retval, DBUS_TYPE_INVALID);
+      dbus_message_unref (reply);
+    }
+  return retval;
+}
+
 static void
 atspi_editable_text_base_init (AtspiEditableText *klass)
 {
@@ -40,6 +40,28 @@ G_BEGIN_DECLS
 
 GType atspi_editable_text_get_type ();
 
+/**
+ * AtspiTextEdit:
+ * @type: the kind of edit to make.
+ * @start_pos: the offset at which to insert or paste, or the start of the
+ *             range to delete, cut or copy.
+ * @end_pos: the end of the range to delete, cut or copy.
+ * @text: the text to insert, or the new contents of the text. May be %NULL
+ *        for edits that do not use it.
+ *
+ * A single edit in a batch passed to atspi_editable_text_apply_edits().
+ *
+ * Since: 2.54
+ */
+typedef struct _AtspiTextEdit AtspiTextEdit;
+struct _AtspiTextEdit
+{
+  AtspiTextEditType type;
+  gint start_pos;
+  gint end_pos;
+  const gchar *text;
+};
+
 struct _AtspiEditableText
 {
   GTypeInterface parent;
@@ -61,6 +83,8 @@ gboolean atspi_editable_text_delete_text (AtspiEditableText *obj, gint start_pos
 
 gboolean atspi_editable_text_paste_text (AtspiEditableText *obj, gint position, GError **error);
 
+gboolean atspi_editable_text_apply_edits (AtspiEditableText *obj, GArray *edits, GError **error);
+
 G_END_DECLS
 
 #endif /* _ATSPI_EDITABLE_TEXT_H_ */
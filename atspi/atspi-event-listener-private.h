@@ -37,6 +37,10 @@ void _atspi_send_event (AtspiEvent *e);
 void _atspi_dbus_handle_event (DBusMessage *message);
 void _atspi_reregister_event_listeners ();
 
+gboolean _atspi_event_is_listened (AtspiAccessible *accessible, const char *name, const char *detail);
+
+guint _atspi_event_listener_stamp (void);
+
 G_END_DECLS
 
 #endif /* _ATSPI_EVENT_LISTENER_H_ */
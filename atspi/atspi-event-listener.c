@@ -182,6 +182,43 @@ static GList *event_listeners = NULL;
 static GList *pending_removals = NULL;
 static int in_send = 0;
 
+static guint listener_stamp = 0;
+
+/*
+ * Returns TRUE if object events of the given name and detail (e.g.
+ * "BoundsChanged" or "PropertyChange" and "accessible-value") from the
+ * application of accessible are being received, so that data cached from
+ * them is kept up to date.
+ */
+gboolean
+_atspi_event_is_listened (AtspiAccessible *accessible, const char *name, const char *detail)
+{
+  GList *l;
+
+  for (l = event_listeners; l; l = l->next)
+    {
+      EventListenerEntry *entry = l->data;
+
+      if (g_strcmp0 (entry->category, "Object") != 0 ||
+          (entry->name && entry->name[0] && strcmp (entry->name, name) != 0) ||
+          (detail && entry->detail && entry->detail[0] && strcmp (entry->detail, detail) != 0))
+        continue;
+      if (!entry->app || entry->app->parent.app == accessible->parent.app)
+        return TRUE;
+    }
+  return FALSE;
+}
+
+/*
+ * Returns a stamp that changes whenever an event listener is removed, after
+ * which events that data was cached from may have been missed.
+ */
+guint
+_atspi_event_listener_stamp (void)
+{
+  return listener_stamp;
+}
+
 static gchar *
 convert_name_from_dbus (const char *name, gboolean path_hack)
 {
@@ -300,6 +337,14 @@ cache_process_property_change (AtspiEvent *event)
           event->source->cached_properties &= ~ATSPI_CACHE_DESCRIPTION;
         }
     }
+  else if (!strcmp (event->type, "object:property-change:accessible-value"))
+    {
+      if (G_VALUE_HOLDS_DOUBLE (&event->any_data))
+        _atspi_accessible_set_cached_value (event->source,
+                                            g_value_get_double (&event->any_data));
+      else
+        event->source->cached_properties &= ~ATSPI_CACHE_VALUE;
+    }
   else if (!strcmp (event->type, "object:property-change:accessible-role"))
     {
       if (G_VALUE_HOLDS_INT (&event->any_data))
@@ -314,6 +359,12 @@ cache_process_property_change (AtspiEvent *event)
     }
 }
 
+static void
+cache_process_bounds_changed (AtspiEvent *event)
+{
+  _atspi_accessible_invalidate_extents (event->source);
+}
+
 static void
 cache_process_state_changed (AtspiEvent *event)
 {
@@ -375,6 +426,34 @@ demarshal_rect (DBusMessageIter *iter, AtspiRect *rect)
   return TRUE;
 }
 
+static GArray *
+demarshal_selection_changes (DBusMessageIter *iter)
+{
+  DBusMessageIter iter_array, iter_struct;
+  GArray *changes = g_array_new (FALSE, FALSE, sizeof (AtspiSelectionChange));
+
+  dbus_message_iter_recurse (iter, &iter_array);
+  while (dbus_message_iter_get_arg_type (&iter_array) != DBUS_TYPE_INVALID)
+    {
+      AtspiSelectionChange change;
+      dbus_bool_t d_bool;
+      dbus_int32_t d_int;
+
+      dbus_message_iter_recurse (&iter_array, &iter_struct);
+      dbus_message_iter_get_basic (&iter_struct, &d_bool);
+      change.selected = d_bool;
+      dbus_message_iter_next (&iter_struct);
+      dbus_message_iter_get_basic (&iter_struct, &d_int);
+      change.start = d_int;
+      dbus_message_iter_next (&iter_struct);
+      dbus_message_iter_get_basic (&iter_struct, &d_int);
+      change.count = d_int;
+      g_array_append_val (changes, change);
+      dbus_message_iter_next (&iter_array);
+    }
+  return changes;
+}
+
 static gboolean
 convert_event_type_to_dbus (const char *eventType, char **categoryp, char **namep, char **detailp, AtspiAccessible *app, GPtrArray **matchrule_array)
 {
@@ -445,6 +524,7 @@ static void
 listener_entry_free (EventListenerEntry *e)
 {
   gpointer callback = (e->callback == remove_datum ? (gpointer) e->user_data : (gpointer) e->callback);
+  listener_stamp++;
   g_free (e->event_type);
   g_free (e->category);
   g_free (e->name);
@@ -1207,6 +1287,25 @@ _atspi_dbus_handle_event (DBusMessage *message)
         g_value_set_string (&e.any_data, p);
         break;
       }
+    case DBUS_TYPE_DOUBLE:
+      {
+        double d;
+        dbus_message_iter_get_basic (&iter_variant, &d);
+        g_value_init (&e.any_data, G_TYPE_DOUBLE);
+        g_value_set_double (&e.any_data, d);
+        break;
+      }
+    case DBUS_TYPE_ARRAY:
+      {
+        char *sig = dbus_message_iter_get_signature (&iter_variant);
+        if (!strcmp (sig, "a(bii)"))
+          {
+            g_value_init (&e.any_data, G_TYPE_ARRAY);
+            g_value_take_boxed (&e.any_data, demarshal_selection_changes (&iter_variant));
+          }
+        dbus_free (sig);
+        break;
+      }
     default:
       break;
     }
@@ -1238,6 +1337,14 @@ _atspi_dbus_handle_event (DBusMessage *message)
     {
       cache_process_attributes_changed (&e);
     }
+  else if (!strncmp (e.type, "object:bounds-changed", 21))
+    {
+      cache_process_bounds_changed (&e);
+    }
+  else if (!strncmp (e.type, "window:", 7))
+    {
+      _atspi_accessible_invalidate_extents (e.source);
+    }
   else if (!strncmp (e.type, "focus", 5))
     {
       /* BGO#663992 - TODO: figure out the real problem */
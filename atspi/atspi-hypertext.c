@@ -37,6 +37,35 @@
  * offsets within the hypertext's content.
  */
 
+static AtspiHyperlinkInfo *
+atspi_hyperlink_info_copy (AtspiHyperlinkInfo *src)
+{
+  AtspiHyperlinkInfo *dst = g_new (AtspiHyperlinkInfo, 1);
+
+  dst->link = (src->link ? g_object_ref (src->link) : NULL);
+  dst->start_offset = src->start_offset;
+  dst->end_offset = src->end_offset;
+  dst->uri = g_strdup (src->uri);
+  dst->n_anchors = src->n_anchors;
+  return dst;
+}
+
+static void
+atspi_hyperlink_info_clear (AtspiHyperlinkInfo *info)
+{
+  g_clear_object (&info->link);
+  g_clear_pointer (&info->uri, g_free);
+}
+
+static void
+atspi_hyperlink_info_free (AtspiHyperlinkInfo *info)
+{
+  atspi_hyperlink_info_clear (info);
+  g_free (info);
+}
+
+G_DEFINE_BOXED_TYPE (AtspiHyperlinkInfo, atspi_hyperlink_info, atspi_hyperlink_info_copy, atspi_hyperlink_info_free)
+
 /**
  * atspi_hypertext_get_n_links:
  * @obj: a pointer to the #AtspiHypertext implementor on which to operate.
@@ -85,6 +114,67 @@ atspi_hypertext_get_link (AtspiHypertext *obj, gint link_index, GError **error)
   return _atspi_dbus_return_hyperlink_from_message (reply);
 }
 
+/**
+ * atspi_hypertext_get_links:
+ * @obj: a pointer to the #AtspiHypertext implementor on which to operate.
+ *
+ * Gets all of the hyperlinks of an #AtspiHypertext implementor, along with
+ * their offsets, the URI of their first anchor and their number of anchors,
+ * in a single call. This is much faster than calling
+ * atspi_hypertext_get_link() and then querying each link when there are
+ * many links.
+ *
+ * The array is indexed by link index. Its elements are freed along with it.
+ *
+ * Returns: (transfer full) (element-type AtspiHyperlinkInfo): a #GArray of
+ *          #AtspiHyperlinkInfo structs, or %NULL on error.
+ *
+ * Since: 2.54
+ **/
+GArray *
+atspi_hypertext_get_links (AtspiHypertext *obj, GError **error)
+{
+  DBusMessage *reply;
+  DBusMessageIter iter, iter_array, iter_struct;
+  GArray *ret;
+
+  g_return_val_if_fail (obj != NULL, NULL);
+
+  reply = _atspi_dbus_call_partial (obj, atspi_interface_hypertext, "GetLinks", error, "");
+  _ATSPI_DBUS_CHECK_SIG (reply, "a((so)iisi)", error, NULL);
+
+  ret = g_array_new (FALSE, TRUE, sizeof (AtspiHyperlinkInfo));
+  g_array_set_clear_func (ret, (GDestroyNotify) atspi_hyperlink_info_clear);
+
+  dbus_message_iter_init (reply, &iter);
+  dbus_message_iter_recurse (&iter, &iter_array);
+  while (dbus_message_iter_get_arg_type (&iter_array) != DBUS_TYPE_INVALID)
+    {
+      AtspiHyperlinkInfo info;
+      dbus_int32_t d_int;
+      const char *uri;
+
+      dbus_message_iter_recurse (&iter_array, &iter_struct);
+      info.link = _atspi_dbus_return_hyperlink_from_iter (&iter_struct);
+      dbus_message_iter_get_basic (&iter_struct, &d_int);
+      info.start_offset = d_int;
+      dbus_message_iter_next (&iter_struct);
+      dbus_message_iter_get_basic (&iter_struct, &d_int);
+      info.end_offset = d_int;
+      dbus_message_iter_next (&iter_struct);
+      dbus_message_iter_get_basic (&iter_struct, &uri);
+      info.uri = g_strdup (uri);
+      dbus_message_iter_next (&iter_struct);
+      dbus_message_iter_get_basic (&iter_struct, &d_int);
+      info.n_anchors = d_int;
+      g_array_append_val (ret, info);
+      dbus_message_iter_next (&iter_array);
+    }
+
+  dbus_message_unref (reply);
+  return ret;
+}
+
 /**
  * atspi_hypertext_get_link_index:
  * @obj: a pointer to the #AtspiHypertext implementor on which to operate.
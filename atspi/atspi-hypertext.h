@@ -41,6 +41,25 @@ G_BEGIN_DECLS
 
 GType atspi_hypertext_get_type ();
 
+typedef struct _AtspiHyperlinkInfo AtspiHyperlinkInfo;
+struct _AtspiHyperlinkInfo
+{
+  AtspiHyperlink *link;
+  gint start_offset;
+  gint end_offset;
+  gchar *uri;
+  gint n_anchors;
+};
+
+/**
+ * ATSPI_TYPE_HYPERLINK_INFO:
+ *
+ * The #GType for a boxed type holding the details of a hyperlink.
+ */
+#define ATSPI_TYPE_HYPERLINK_INFO atspi_hyperlink_info_get_type ()
+
+GType atspi_hyperlink_info_get_type ();
+
 struct _AtspiHypertext
 {
   GTypeInterface parent;
@@ -50,6 +69,8 @@ gint atspi_hypertext_get_n_links (AtspiHypertext *obj, GError **error);
 
 AtspiHyperlink *atspi_hypertext_get_link (AtspiHypertext *obj, gint link_index, GError **error);
 
+GArray *atspi_hypertext_get_links (AtspiHypertext *obj, GError **error);
+
 gint atspi_hypertext_get_link_index (AtspiHypertext *obj, gint character_offset, GError **error);
 
 G_END_DECLS
@@ -95,6 +95,14 @@ DBusMessage *_atspi_dbus_call_partial (gpointer obj, const char *interface, cons
 
 dbus_bool_t _atspi_dbus_get_property (gpointer obj, const char *interface, const char *name, GError **error, const char *type, void *data);
 
+DBusMessage *_atspi_dbus_method_call_new (gpointer obj, const char *interface, const char *method, GError **error);
+
+DBusMessage *_atspi_dbus_send_with_reply (gpointer obj, DBusMessage *message, GError **error);
+
+DBusMessage *_atspi_dbus_send_with_reply_dbus_error (gpointer obj, DBusMessage *message, DBusError *err);
+
+dbus_bool_t _atspi_dbus_set_signature_error (DBusMessage *reply, const char *method, const char *expected, GError **error);
+
 DBusMessage *_atspi_dbus_send_with_reply_and_block (DBusMessage *message, GError **error);
 
 GHashTable *_atspi_dbus_return_hash_from_message (DBusMessage *message);
@@ -33,6 +33,7 @@
 #include "X11/Xlib.h"
 #endif
 #include "atspi-gmain.h"
+#include "atspi-trace.h"
 #include <ctype.h>
 #include <locale.h>
 #include <stdio.h>
@@ -1092,6 +1093,9 @@ atspi_init (void)
   if (no_cache && g_strcmp0 (no_cache, "0") != 0)
     atspi_no_cache = TRUE;
 
+  if (_atspi_trace_enabled ())
+    dbind_set_trace_func (_atspi_trace_call);
+
   deferred_messages = g_queue_new ();
 
   return 0;
@@ -1336,8 +1340,8 @@ out:
     {
       const char *err_str = NULL;
       dbus_message_get_args (reply, NULL, DBUS_TYPE_STRING, &err_str, DBUS_TYPE_INVALID);
-      if (err_str)
-        g_set_error_literal (error, ATSPI_ERROR, ATSPI_ERROR_IPC, err_str);
+      g_set_error_literal (error, ATSPI_ERROR, ATSPI_ERROR_IPC,
+                           err_str ? err_str : dbus_message_get_error_name (reply));
       dbus_message_unref (reply);
       return NULL;
     }
@@ -1367,6 +1371,102 @@ _atspi_dbus_call_partial (gpointer obj,
   return ret;
 }
 
+/* Creates a method call on @obj, or returns NULL with @error set if its
+ * application is gone.  Used with the typed marshalling functions generated
+ * in spi-marshal.h, which avoid parsing a type signature on every call.
+ */
+DBusMessage *
+_atspi_dbus_method_call_new (gpointer obj,
+                             const char *interface,
+                             const char *method,
+                             GError **error)
+{
+  AtspiObject *aobj = ATSPI_OBJECT (obj);
+
+  if (!check_app (aobj->app, error))
+    return NULL;
+
+  return dbus_message_new_method_call (aobj->app->bus_name, aobj->path, interface, method);
+}
+
+static DBusMessage *
+send_with_reply (AtspiObject *aobj, DBusMessage *message, DBusError *err)
+{
+  DBusMessage *reply;
+
+  set_timeout (aobj->app);
+  reply = dbind_send_and_allow_reentry (aobj->app->bus, message, err);
+  check_for_hang (reply, err, aobj->app->bus, aobj->app->bus_name);
+  process_deferred_messages ();
+  return reply;
+}
+
+/* Sends a method call created by _atspi_dbus_method_call_new() and waits for
+ * the reply, which must be unreffed.  Returns NULL with @error set if the
+ * call failed.
+ */
+DBusMessage *
+_atspi_dbus_send_with_reply (gpointer obj, DBusMessage *message, GError **error)
+{
+  DBusMessage *reply;
+  DBusError err;
+
+  dbus_error_init (&err);
+  reply = send_with_reply (ATSPI_OBJECT (obj), message, &err);
+  if (dbus_error_is_set (&err))
+    {
+      g_set_error (error, ATSPI_ERROR, ATSPI_ERROR_IPC, "%s", err.message);
+      dbus_error_free (&err);
+    }
+
+  if (reply && dbus_message_get_type (reply) == DBUS_MESSAGE_TYPE_ERROR)
+    {
+      const char *err_str = NULL;
+      dbus_message_get_args (reply, NULL, DBUS_TYPE_STRING, &err_str, DBUS_TYPE_INVALID);
+      g_set_error_literal (error, ATSPI_ERROR, ATSPI_ERROR_IPC,
+                           err_str ? err_str : dbus_message_get_error_name (reply));
+      dbus_message_unref (reply);
+      return NULL;
+    }
+
+  return reply;
+}
+
+/* Like _atspi_dbus_send_with_reply(), but reports failures, including error
+ * replies, in @err, whose name tells the caller what went wrong.  @err must
+ * have been initialized.
+ */
+DBusMessage *
+_atspi_dbus_send_with_reply_dbus_error (gpointer obj, DBusMessage *message, DBusError *err)
+{
+  DBusMessage *reply;
+
+  reply = send_with_reply (ATSPI_OBJECT (obj), message, err);
+  if (reply && dbus_message_get_type (reply) == DBUS_MESSAGE_TYPE_ERROR)
+    {
+      dbus_set_error_from_message (err, reply);
+      dbus_message_unref (reply);
+      return NULL;
+    }
+
+  return reply;
+}
+
+/* Reports a reply of the wrong type, and returns FALSE */
+dbus_bool_t
+_atspi_dbus_set_signature_error (DBusMessage *reply,
+                                 const char *method,
+                                 const char *expected,
+                                 GError **error)
+{
+  g_warning ("atspi: Call to \"%s\" returned signature %s; expected %s",
+             method, dbus_message_get_signature (reply), expected);
+  g_set_error (error, ATSPI_ERROR, ATSPI_ERROR_IPC,
+               "Call to \"%s\" returned signature %s; expected %s",
+               method, dbus_message_get_signature (reply), expected);
+  return FALSE;
+}
+
 dbus_bool_t
 _atspi_dbus_get_property (gpointer obj, const char *interface, const char *name, GError **error, const char *type, void *data)
 {
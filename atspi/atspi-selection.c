@@ -253,6 +253,95 @@ atspi_selection_clear_selection (AtspiSelection *obj, GError **error)
   return retval;
 }
 
+static GArray *
+read_ranges (DBusMessageIter *iter)
+{
+  DBusMessageIter iter_array, iter_struct;
+  GArray *ranges = g_array_new (FALSE, FALSE, sizeof (AtspiSelectionRange));
+
+  dbus_message_iter_recurse (iter, &iter_array);
+  while (dbus_message_iter_get_arg_type (&iter_array) != DBUS_TYPE_INVALID)
+    {
+      AtspiSelectionRange range;
+      dbus_int32_t d_int;
+
+      dbus_message_iter_recurse (&iter_array, &iter_struct);
+      dbus_message_iter_get_basic (&iter_struct, &d_int);
+      range.start = d_int;
+      dbus_message_iter_next (&iter_struct);
+      dbus_message_iter_get_basic (&iter_struct, &d_int);
+      range.count = d_int;
+      g_array_append_val (ranges, range);
+      dbus_message_iter_next (&iter_array);
+    }
+  return ranges;
+}
+
+/**
+ * atspi_selection_get_selection_snapshot:
+ * @obj: a pointer to the #AtspiSelection implementor on which to operate.
+ * @rows: (out) (optional) (transfer full) (element-type AtspiSelectionRange):
+ *        if not %NULL, back-filled with the selected rows, if @obj is also
+ *        a table.
+ * @columns: (out) (optional) (transfer full) (element-type AtspiSelectionRange):
+ *        if not %NULL, back-filled with the selected columns, if @obj is
+ *        also a table.
+ *
+ * Gets the whole selection of an object in a single call, as runs of
+ * consecutive indices, instead of one call per selected child.
+ *
+ * After this call, the object:selection-changed events of @obj carry the
+ * changes since the previous event, as a #GArray of #AtspiSelectionChange
+ * in their any_data, with the number of children that became selected
+ * and deselected in detail1 and detail2.
+ *
+ * The application keeps one snapshot per object for all clients, so a
+ * snapshot taken by another client also resets the changes reported to
+ * this one. It drops the snapshots when no client listens to
+ * object:selection-changed any more, and the snapshot of an object with
+ * more than 10000 selected children; events then carry no changes until
+ * this is called again.
+ *
+ * Returns: (transfer full) (element-type AtspiSelectionRange): a #GArray
+ *          of the runs of indices in parent of the selected children, in
+ *          increasing order, or %NULL on error.
+ *
+ * Since: 2.54
+ **/
+GArray *
+atspi_selection_get_selection_snapshot (AtspiSelection *obj,
+                                        GArray **rows,
+                                        GArray **columns,
+                                        GError **error)
+{
+  DBusMessage *reply;
+  DBusMessageIter iter;
+  GArray *ret;
+
+  if (rows)
+    *rows = NULL;
+  if (columns)
+    *columns = NULL;
+
+  g_return_val_if_fail (obj != NULL, NULL);
+
+  reply = _atspi_dbus_call_partial (obj, atspi_interface_selection,
+                                    "GetSelectionSnapshot", error, "");
+  _ATSPI_DBUS_CHECK_SIG (reply, "a(ii)a(ii)a(ii)", error, NULL);
+
+  dbus_message_iter_init (reply, &iter);
+  ret = read_ranges (&iter);
+  dbus_message_iter_next (&iter);
+  if (rows)
+    *rows = read_ranges (&iter);
+  dbus_message_iter_next (&iter);
+  if (columns)
+    *columns = read_ranges (&iter);
+
+  dbus_message_unref (reply);
+  return ret;
+}
+
 static void
 atspi_selection_base_init (AtspiSelection *klass)
 {
@@ -46,6 +46,44 @@ struct _AtspiSelection
   GTypeInterface parent;
 };
 
+/**
+ * AtspiSelectionRange:
+ * @start: the first index of the run.
+ * @count: the number of consecutive indices in the run.
+ *
+ * A run of consecutive selected indices, as returned by
+ * atspi_selection_get_selection_snapshot().
+ *
+ * Since: 2.54
+ */
+typedef struct _AtspiSelectionRange AtspiSelectionRange;
+struct _AtspiSelectionRange
+{
+  gint start;
+  gint count;
+};
+
+/**
+ * AtspiSelectionChange:
+ * @selected: whether the children of the run became selected or deselected.
+ * @start: the index in parent of the first child of the run.
+ * @count: the number of consecutive children in the run.
+ *
+ * A run of children whose selection state changed. Once
+ * atspi_selection_get_selection_snapshot() has been called on an object,
+ * the any_data of its object:selection-changed events holds a #GArray of
+ * these, describing the changes since the previous event.
+ *
+ * Since: 2.54
+ */
+typedef struct _AtspiSelectionChange AtspiSelectionChange;
+struct _AtspiSelectionChange
+{
+  gboolean selected;
+  gint start;
+  gint count;
+};
+
 gint atspi_selection_get_n_selected_children (AtspiSelection *obj, GError **error);
 
 AtspiAccessible *atspi_selection_get_selected_child (AtspiSelection *obj, gint selected_child_index, GError **error);
@@ -65,6 +103,8 @@ gboolean atspi_selection_select_all (AtspiSelection *obj, GError **error);
 
 gboolean atspi_selection_clear_selection (AtspiSelection *obj, GError **error);
 
+GArray *atspi_selection_get_selection_snapshot (AtspiSelection *obj, GArray **rows, GArray **columns, GError **error);
+
 G_END_DECLS
 
 #endif /* _ATSPI_SELECTION_H_ */
@@ -25,6 +25,9 @@
 #include "atspi-private.h"
 #include <stdlib.h> /* for malloc */
 
+#define SPI_MARSHAL_CLIENT
+#include "spi-marshal.h"
+
 /**
  * AtspiTable:
  *
@@ -182,7 +185,7 @@ atspi_table_get_index_at (AtspiTable *obj,
 
   g_return_val_if_fail (obj != NULL, -1);
 
-  _atspi_dbus_call (obj, atspi_interface_table, "GetIndexAt", error, "ii=>i", d_row, d_column, &retval);
+  _atspi_dbus_call_Table_GetIndexAt (obj, error, d_row, d_column, &retval);
 
   return retval;
 }
@@ -210,7 +213,7 @@ atspi_table_get_row_at_index (AtspiTable *obj,
 
   g_return_val_if_fail (obj != NULL, -1);
 
-  _atspi_dbus_call (obj, atspi_interface_table, "GetRowAtIndex", error, "i=>i", d_index, &retval);
+  _atspi_dbus_call_Table_GetRowAtIndex (obj, error, d_index, &retval);
 
   return retval;
 }
@@ -238,7 +241,7 @@ atspi_table_get_column_at_index (AtspiTable *obj,
 
   g_return_val_if_fail (obj != NULL, -1);
 
-  _atspi_dbus_call (obj, atspi_interface_table, "GetColumnAtIndex", error, "i=>i", d_index, &retval);
+  _atspi_dbus_call_Table_GetColumnAtIndex (obj, error, d_index, &retval);
 
   return retval;
 }
@@ -263,7 +266,7 @@ atspi_table_get_row_description (AtspiTable *obj,
 
   g_return_val_if_fail (obj != NULL, NULL);
 
-  _atspi_dbus_call (obj, atspi_interface_table, "GetRowDescription", error, "i=>s", d_row, &retval);
+  _atspi_dbus_call_Table_GetRowDescription (obj, error, d_row, &retval);
 
   return retval;
 }
@@ -288,7 +291,7 @@ atspi_table_get_column_description (AtspiTable *obj,
 
   g_return_val_if_fail (obj != NULL, NULL);
 
-  _atspi_dbus_call (obj, atspi_interface_table, "GetColumnDescription", error, "i=>s", d_column, &retval);
+  _atspi_dbus_call_Table_GetColumnDescription (obj, error, d_column, &retval);
 
   return retval;
 }
@@ -318,7 +321,7 @@ atspi_table_get_row_extent_at (AtspiTable *obj,
 
   g_return_val_if_fail (obj != NULL, -1);
 
-  _atspi_dbus_call (obj, atspi_interface_table, "GetRowExtentAt", error, "ii=>i", d_row, d_column, &retval);
+  _atspi_dbus_call_Table_GetRowExtentAt (obj, error, d_row, d_column, &retval);
 
   return retval;
 }
@@ -348,7 +351,7 @@ atspi_table_get_column_extent_at (AtspiTable *obj,
 
   g_return_val_if_fail (obj != NULL, -1);
 
-  _atspi_dbus_call (obj, atspi_interface_table, "GetColumnExtentAt", error, "ii=>i", d_row, d_column, &retval);
+  _atspi_dbus_call_Table_GetColumnExtentAt (obj, error, d_row, d_column, &retval);
 
   return retval;
 }
@@ -513,7 +516,7 @@ atspi_table_is_row_selected (AtspiTable *obj,
 
   g_return_val_if_fail (obj != NULL, FALSE);
 
-  _atspi_dbus_call (obj, atspi_interface_table, "IsRowSelected", error, "i=>b", d_row, &retval);
+  _atspi_dbus_call_Table_IsRowSelected (obj, error, d_row, &retval);
 
   return retval;
 }
@@ -538,7 +541,7 @@ atspi_table_is_column_selected (AtspiTable *obj,
 
   g_return_val_if_fail (obj != NULL, FALSE);
 
-  _atspi_dbus_call (obj, atspi_interface_table, "IsColumnSelected", error, "i=>b", d_column, &retval);
+  _atspi_dbus_call_Table_IsColumnSelected (obj, error, d_column, &retval);
 
   return retval;
 }
@@ -563,7 +566,7 @@ atspi_table_add_row_selection (AtspiTable *obj,
 
   g_return_val_if_fail (obj != NULL, FALSE);
 
-  _atspi_dbus_call (obj, atspi_interface_table, "AddRowSelection", error, "i=>b", d_row, &retval);
+  _atspi_dbus_call_Table_AddRowSelection (obj, error, d_row, &retval);
 
   return retval;
 }
@@ -588,7 +591,7 @@ atspi_table_add_column_selection (AtspiTable *obj,
 
   g_return_val_if_fail (obj != NULL, FALSE);
 
-  _atspi_dbus_call (obj, atspi_interface_table, "AddColumnSelection", error, "i=>b", d_column, &retval);
+  _atspi_dbus_call_Table_AddColumnSelection (obj, error, d_column, &retval);
 
   return retval;
 }
@@ -614,7 +617,7 @@ atspi_table_remove_row_selection (AtspiTable *obj,
 
   g_return_val_if_fail (obj != NULL, FALSE);
 
-  _atspi_dbus_call (obj, atspi_interface_table, "RemoveRowSelection", error, "i=>b", d_row, &retval);
+  _atspi_dbus_call_Table_RemoveRowSelection (obj, error, d_row, &retval);
 
   return retval;
 }
@@ -641,7 +644,7 @@ atspi_table_remove_column_selection (AtspiTable *obj,
 
   g_return_val_if_fail (obj != NULL, FALSE);
 
-  _atspi_dbus_call (obj, atspi_interface_table, "RemoveColumnSelection", error, "i=>b", d_column, &retval);
+  _atspi_dbus_call_Table_RemoveColumnSelection (obj, error, d_column, &retval);
 
   return retval;
 }
@@ -707,9 +710,9 @@ atspi_table_get_row_column_extents_at_index (AtspiTable *obj,
 
   g_return_val_if_fail (obj != NULL, FALSE);
 
-  _atspi_dbus_call (obj, atspi_interface_table, "GetRowColumnExtentsAtIndex",
-                    error, "i=>biiiib", d_index, &retval, &d_row, &d_col,
-                    &d_row_extents, &d_col_extents, &d_is_selected);
+  _atspi_dbus_call_Table_GetRowColumnExtentsAtIndex (obj, error, d_index, &retval,
+                                                     &d_row, &d_col, &d_row_extents,
+                                                     &d_col_extents, &d_is_selected);
 
   *row = d_row;
   *col = d_col;
@@ -743,11 +746,186 @@ atspi_table_is_selected (AtspiTable *obj,
 
   g_return_val_if_fail (obj != NULL, FALSE);
 
-  _atspi_dbus_call (obj, atspi_interface_table, "IsSelected", error, "ii=>b", d_row, d_column, &retval);
+  _atspi_dbus_call_Table_IsSelected (obj, error, d_row, d_column, &retval);
 
   return retval;
 }
 
+static void
+table_region_cell_clear (AtspiTableRegionCell *cell)
+{
+  g_clear_object (&cell->cell);
+}
+
+/* Fills in the client-side cache of a cell from the properties sent with it */
+static void
+read_cell_properties (AtspiAccessible *cell, DBusMessageIter *iter)
+{
+  DBusMessageIter iter_dict, iter_dict_entry, iter_variant;
+
+  dbus_message_iter_recurse (iter, &iter_dict);
+  while (dbus_message_iter_get_arg_type (&iter_dict) != DBUS_TYPE_INVALID)
+    {
+      const char *key, *str;
+      dbus_uint32_t role;
+      char type;
+
+      dbus_message_iter_recurse (&iter_dict, &iter_dict_entry);
+      dbus_message_iter_get_basic (&iter_dict_entry, &key);
+      dbus_message_iter_next (&iter_dict_entry);
+      dbus_message_iter_recurse (&iter_dict_entry, &iter_variant);
+      type = dbus_message_iter_get_arg_type (&iter_variant);
+
+      if (!cell)
+        ;
+      else if (!strcmp (key, "Name") && type == DBUS_TYPE_STRING)
+        {
+          dbus_message_iter_get_basic (&iter_variant, &str);
+          g_free (cell->name);
+          cell->name = g_strdup (str);
+          _atspi_accessible_add_cache (cell, ATSPI_CACHE_NAME);
+        }
+      else if (!strcmp (key, "Description") && type == DBUS_TYPE_STRING)
+        {
+          dbus_message_iter_get_basic (&iter_variant, &str);
+          g_free (cell->description);
+          cell->description = g_strdup (str);
+          _atspi_accessible_add_cache (cell, ATSPI_CACHE_DESCRIPTION);
+        }
+      else if (!strcmp (key, "Role") && type == DBUS_TYPE_UINT32)
+        {
+          dbus_message_iter_get_basic (&iter_variant, &role);
+          cell->role = role;
+          _atspi_accessible_add_cache (cell, ATSPI_CACHE_ROLE);
+        }
+      else if (!strcmp (key, "States") && type == DBUS_TYPE_ARRAY)
+        _atspi_dbus_set_state (cell, &iter_variant);
+
+      dbus_message_iter_next (&iter_dict);
+    }
+}
+
+static GPtrArray *
+read_header_array (DBusMessageIter *iter)
+{
+  DBusMessageIter iter_array;
+  GPtrArray *headers = g_ptr_array_new_with_free_func (g_object_unref);
+
+  dbus_message_iter_recurse (iter, &iter_array);
+  while (dbus_message_iter_get_arg_type (&iter_array) != DBUS_TYPE_INVALID)
+    {
+      AtspiAccessible *header = _atspi_dbus_consume_accessible (&iter_array);
+      g_ptr_array_add (headers, header);
+    }
+  return headers;
+}
+
+/**
+ * atspi_table_get_region:
+ * @obj: a pointer to the #AtspiTable implementor on which to operate.
+ * @row: the first row of the region.
+ * @column: the first column of the region.
+ * @n_rows: the number of rows in the region.
+ * @n_columns: the number of columns in the region.
+ * @mask: an #AtspiCache mask of the properties of each cell to fetch along
+ *        with it. Only #ATSPI_CACHE_NAME, #ATSPI_CACHE_DESCRIPTION,
+ *        #ATSPI_CACHE_ROLE and #ATSPI_CACHE_STATES are supported.
+ * @row_headers: (out) (optional) (transfer full) (element-type AtspiAccessible):
+ *        if not %NULL, back-filled with the header of each row of the
+ *        region, or %NULL for rows without a header.
+ * @column_headers: (out) (optional) (transfer full) (element-type AtspiAccessible):
+ *        if not %NULL, back-filled with the header of each column of the
+ *        region, or %NULL for columns without a header.
+ *
+ * Gets the cells of a rectangular region of a table in a single call,
+ * along with their positions, spans and selection state, instead of one
+ * call per cell and property. The properties in @mask are stored in the
+ * client-side cache of each cell, so that reading them afterwards does not
+ * take a round trip either.
+ *
+ * The region is clipped to the table. A cell spanning several positions of
+ * the region is only returned once, at the first one.
+ *
+ * Returns: (transfer full) (element-type AtspiTableRegionCell): a #GArray
+ *          of #AtspiTableRegionCell structs, in row order, or %NULL on
+ *          error.
+ *
+ * Since: 2.54
+ **/
+GArray *
+atspi_table_get_region (AtspiTable *obj,
+                        gint row,
+                        gint column,
+                        gint n_rows,
+                        gint n_columns,
+                        AtspiCache mask,
+                        GPtrArray **row_headers,
+                        GPtrArray **column_headers,
+                        GError **error)
+{
+  dbus_int32_t d_row = row, d_column = column;
+  dbus_int32_t d_n_rows = n_rows, d_n_columns = n_columns;
+  dbus_uint32_t d_mask = mask;
+  DBusMessage *reply;
+  DBusMessageIter iter, iter_array, iter_struct;
+  GArray *ret;
+
+  if (row_headers)
+    *row_headers = NULL;
+  if (column_headers)
+    *column_headers = NULL;
+
+  g_return_val_if_fail (obj != NULL, NULL);
+
+  reply = _atspi_dbus_call_partial (obj, atspi_interface_table, "GetRegion",
+                                    error, "iiiiu", d_row, d_column, d_n_rows,
+                                    d_n_columns, d_mask);
+  _ATSPI_DBUS_CHECK_SIG (reply, "a((so)iiiiba{sv})a(so)a(so)", error, NULL);
+
+  ret = g_array_new (FALSE, TRUE, sizeof (AtspiTableRegionCell));
+  g_array_set_clear_func (ret, (GDestroyNotify) table_region_cell_clear);
+
+  dbus_message_iter_init (reply, &iter);
+  dbus_message_iter_recurse (&iter, &iter_array);
+  while (dbus_message_iter_get_arg_type (&iter_array) != DBUS_TYPE_INVALID)
+    {
+      AtspiTableRegionCell cell;
+      dbus_int32_t d_int;
+      dbus_bool_t d_bool;
+
+      dbus_message_iter_recurse (&iter_array, &iter_struct);
+      cell.cell = _atspi_dbus_consume_accessible (&iter_struct);
+      dbus_message_iter_get_basic (&iter_struct, &d_int);
+      cell.row = d_int;
+      dbus_message_iter_next (&iter_struct);
+      dbus_message_iter_get_basic (&iter_struct, &d_int);
+      cell.column = d_int;
+      dbus_message_iter_next (&iter_struct);
+      dbus_message_iter_get_basic (&iter_struct, &d_int);
+      cell.row_extent = d_int;
+      dbus_message_iter_next (&iter_struct);
+      dbus_message_iter_get_basic (&iter_struct, &d_int);
+      cell.column_extent = d_int;
+      dbus_message_iter_next (&iter_struct);
+      dbus_message_iter_get_basic (&iter_struct, &d_bool);
+      cell.is_selected = d_bool;
+      dbus_message_iter_next (&iter_struct);
+      read_cell_properties (cell.cell, &iter_struct);
+      g_array_append_val (ret, cell);
+      dbus_message_iter_next (&iter_array);
+    }
+
+  dbus_message_iter_next (&iter);
+  if (row_headers)
+    *row_headers = read_header_array (&iter);
+  dbus_message_iter_next (&iter);
+  if (column_headers)
+    *column_headers = read_header_array (&iter);
+
+  dbus_message_unref (reply);
+  return ret;
+}
+
 static void
 atspi_table_base_init (AtspiTable *klass)
 {
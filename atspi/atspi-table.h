@@ -41,6 +41,30 @@ G_BEGIN_DECLS
 
 GType atspi_table_get_type ();
 
+/**
+ * AtspiTableRegionCell:
+ * @cell: the cell, or %NULL if there is no cell at that position.
+ * @row: the row at which the cell was found.
+ * @column: the column at which the cell was found.
+ * @row_extent: the number of rows the cell spans.
+ * @column_extent: the number of columns the cell spans.
+ * @is_selected: whether the cell is selected.
+ *
+ * A cell returned by atspi_table_get_region().
+ *
+ * Since: 2.54
+ */
+typedef struct _AtspiTableRegionCell AtspiTableRegionCell;
+struct _AtspiTableRegionCell
+{
+  AtspiAccessible *cell;
+  gint row;
+  gint column;
+  gint row_extent;
+  gint column_extent;
+  gboolean is_selected;
+};
+
 struct _AtspiTable
 {
   GTypeInterface parent;
@@ -100,6 +124,8 @@ gboolean atspi_table_get_row_column_extents_at_index (AtspiTable *obj, gint inde
 
 gboolean atspi_table_is_selected (AtspiTable *obj, gint row, gint column, GError **error);
 
+GArray *atspi_table_get_region (AtspiTable *obj, gint row, gint column, gint n_rows, gint n_columns, AtspiCache mask, GPtrArray **row_headers, GPtrArray **column_headers, GError **error);
+
 G_END_DECLS
 
 #endif /* _ATSPI_TABLE_H_ */
@@ -22,8 +22,18 @@
  * Boston, MA 02110-1301, USA.
  */
 
+/* For F_GET_SEALS and F_SEAL_SHRINK */
+#define _GNU_SOURCE
+
 #include "atspi-private.h"
 
+#ifdef G_OS_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 /**
  * AtspiText:
  *
@@ -99,6 +109,131 @@ atspi_text_get_character_count (AtspiText *obj, GError **error)
   return retval;
 }
 
+#ifdef G_OS_UNIX
+/* Ranges at least this many characters long are requested with
+ * GetTextWithFd, and the bridge is asked to pass the text in a memfd if
+ * it is at least TEXT_FD_MIN_BYTES long once encoded.
+ */
+#define TEXT_FD_MIN_CHARS 16384
+#define TEXT_FD_MIN_BYTES 65536
+
+#define TEXT_FD_UNSUPPORTED "atspi-text-fd-unsupported"
+
+/* Checks that the sender can no longer truncate the file. Otherwise it
+ * could do so while we have it mapped, which would get us a SIGBUS.
+ */
+static gboolean
+fd_cannot_shrink (int fd)
+{
+#ifdef F_GET_SEALS
+  int seals = fcntl (fd, F_GET_SEALS);
+
+  return seals >= 0 && (seals & F_SEAL_SHRINK);
+#else
+  return FALSE;
+#endif
+}
+
+static gchar *
+read_text_from_fd (int fd, guint32 length)
+{
+  struct stat st;
+  gchar *map;
+  gchar *ret = NULL;
+
+  if (!fd_cannot_shrink (fd))
+    return NULL;
+  if (fstat (fd, &st) < 0 || st.st_size < length)
+    return NULL;
+  if (length == 0)
+    return g_strdup ("");
+
+  map = mmap (NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (map == MAP_FAILED)
+    return NULL;
+  if (g_utf8_validate_len (map, length, NULL))
+    ret = g_strndup (map, length);
+  munmap (map, length);
+  return ret;
+}
+
+/* Fetches a range of text with GetTextWithFd, mapping the text if it was
+ * passed as a file descriptor. Returns NULL if the application does not
+ * support GetTextWithFd or the call failed for any other reason, in which
+ * case the caller should fall back to GetText, unless @error was set
+ * because the application did not answer.
+ */
+static gchar *
+get_text_with_fd (AtspiText *obj, dbus_int32_t start_offset, dbus_int32_t end_offset, GError **error)
+{
+  AtspiApplication *app = ATSPI_OBJECT (obj)->app;
+  dbus_uint32_t threshold = TEXT_FD_MIN_BYTES;
+  dbus_uint32_t length;
+  DBusMessage *message, *reply;
+  DBusMessageIter iter, iter_array;
+  DBusError err;
+  const char *inline_txt;
+  gchar *ret = NULL;
+
+  if (!app || !app->bus || g_object_get_data (G_OBJECT (app), TEXT_FD_UNSUPPORTED))
+    return NULL;
+  if (!dbus_connection_can_send_type (app->bus, DBUS_TYPE_UNIX_FD))
+    return NULL;
+
+  message = _atspi_dbus_method_call_new (obj, atspi_interface_text, "GetTextWithFd", NULL);
+  if (!message)
+    return NULL;
+  dbus_message_append_args (message, DBUS_TYPE_INT32, &start_offset,
+                            DBUS_TYPE_INT32, &end_offset,
+                            DBUS_TYPE_UINT32, &threshold, DBUS_TYPE_INVALID);
+  dbus_error_init (&err);
+  reply = _atspi_dbus_send_with_reply_dbus_error (obj, message, &err);
+  dbus_message_unref (message);
+  if (!reply)
+    {
+      /* An older bridge; don't try again for this app. Other errors, such
+       * as a defunct object, only fail this call.
+       */
+      if (dbus_error_has_name (&err, DBUS_ERROR_UNKNOWN_METHOD))
+        g_object_set_data (G_OBJECT (app), TEXT_FD_UNSUPPORTED, GINT_TO_POINTER (TRUE));
+      /* GetText would only time out again */
+      else if (dbus_error_has_name (&err, DBUS_ERROR_NO_REPLY))
+        g_set_error_literal (error, ATSPI_ERROR, ATSPI_ERROR_IPC, err.message);
+      dbus_error_free (&err);
+      return NULL;
+    }
+
+  if (strcmp (dbus_message_get_signature (reply), "sahu") != 0)
+    {
+      g_warning ("AT-SPI: Expected message signature sahu but got %s at %s line %d", dbus_message_get_signature (reply), __FILE__, __LINE__);
+      dbus_message_unref (reply);
+      return NULL;
+    }
+
+  dbus_message_iter_init (reply, &iter);
+  dbus_message_iter_get_basic (&iter, &inline_txt);
+  dbus_message_iter_next (&iter);
+  dbus_message_iter_recurse (&iter, &iter_array);
+  dbus_message_iter_next (&iter);
+  dbus_message_iter_get_basic (&iter, &length);
+
+  if (dbus_message_iter_get_arg_type (&iter_array) == DBUS_TYPE_UNIX_FD)
+    {
+      int fd;
+
+      /* libdbus gives us our own duplicate of the descriptor */
+      dbus_message_iter_get_basic (&iter_array, &fd);
+      ret = read_text_from_fd (fd, length);
+      close (fd);
+    }
+  else
+    ret = g_strdup (inline_txt);
+
+  dbus_message_unref (reply);
+  return ret;
+}
+#endif
+
 /**
  * atspi_text_get_text:
  * @obj: a pointer to the #AtspiText object to query.
@@ -120,10 +255,18 @@ atspi_text_get_text (AtspiText *obj,
 {
   gchar *retval = NULL;
   dbus_int32_t d_start_offset = start_offset, d_end_offset = end_offset;
+  GError *fd_error = NULL;
 
   g_return_val_if_fail (obj != NULL, g_strdup (""));
 
-  _atspi_dbus_call (obj, atspi_interface_text, "GetText", error, "ii=>s", d_start_offset, d_end_offset, &retval);
+#ifdef G_OS_UNIX
+  if (end_offset < 0 || end_offset - start_offset >= TEXT_FD_MIN_CHARS)
+    retval = get_text_with_fd (obj, d_start_offset, d_end_offset, &fd_error);
+#endif
+  if (fd_error)
+    g_propagate_error (error, fd_error);
+  else if (!retval)
+    _atspi_dbus_call (obj, atspi_interface_text, "GetText", error, "ii=>s", d_start_offset, d_end_offset, &retval);
 
   if (!retval)
     retval = g_strdup ("");
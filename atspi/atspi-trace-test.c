@@ -0,0 +1,197 @@
+/*
+ * AT-SPI - Assistive Technology Service Provider Interface
+ * (Gnome Accessibility Project; https://wiki.gnome.org/Accessibility)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Checks that calls made by two clients on peer-to-peer connections, which
+ * have no sender and share serials, get trace ids apart, and that each
+ * side of a call finds the same id.
+ */
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "atspi/atspi-gmain.h"
+#include "atspi/atspi-trace.h"
+
+#define TEST_PATH "/org/a11y/atspi/accessible/root"
+#define TEST_INTERFACE "test.interface.Trace"
+#define N_CLIENTS 2
+
+typedef struct
+{
+  gchar *server_id;
+  gchar *client_id;
+} Call;
+
+static Call calls[N_CLIENTS];
+static gint n_connections;
+static gint n_done;
+static GMainLoop *main_loop;
+
+/*
+ * Each client makes a call, then sends the id it traced the call with.
+ */
+static DBusHandlerResult
+message_filter (DBusConnection *bus, DBusMessage *message, void *user_data)
+{
+  Call *call = user_data;
+  const char *member = dbus_message_get_member (message);
+  const char *id;
+
+  if (dbus_message_get_type (message) != DBUS_MESSAGE_TYPE_METHOD_CALL || !member)
+    return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+
+  if (!strcmp (member, "Call"))
+    call->server_id = _atspi_trace_id (bus, message, FALSE);
+  else if (!strcmp (member, "Id") &&
+           dbus_message_get_args (message, NULL, DBUS_TYPE_STRING, &id, DBUS_TYPE_INVALID))
+    {
+      call->client_id = g_strdup (id);
+      if (++n_done == N_CLIENTS)
+        g_main_loop_quit (main_loop);
+    }
+  return DBUS_HANDLER_RESULT_HANDLED;
+}
+
+static void
+new_connection_cb (DBusServer *server, DBusConnection *con, void *data)
+{
+  if (n_connections == N_CLIENTS)
+    return;
+
+  dbus_connection_ref (con);
+  atspi_dbus_connection_setup_with_g_main (con, NULL);
+  dbus_connection_add_filter (con, message_filter, &calls[n_connections++], NULL);
+}
+
+static void
+run_client (const char *address)
+{
+  DBusConnection *bus;
+  DBusMessage *message;
+  gchar *id;
+
+  bus = dbus_connection_open_private (address, NULL);
+  if (!bus)
+    _exit (1);
+
+  message = dbus_message_new_method_call (NULL, TEST_PATH, TEST_INTERFACE, "Call");
+  dbus_connection_send (bus, message, NULL);
+  id = _atspi_trace_id (bus, message, TRUE);
+  dbus_message_unref (message);
+
+  message = dbus_message_new_method_call (NULL, TEST_PATH, TEST_INTERFACE, "Id");
+  dbus_message_append_args (message, DBUS_TYPE_STRING, &id, DBUS_TYPE_INVALID);
+  dbus_connection_send (bus, message, NULL);
+  dbus_message_unref (message);
+  g_free (id);
+
+  dbus_connection_flush (bus);
+  dbus_connection_close (bus);
+  dbus_connection_unref (bus);
+  _exit (0);
+}
+
+static gboolean
+timeout_cb (gpointer data)
+{
+  g_print ("Failed: timed out waiting for the clients\n");
+  exit (1);
+  return G_SOURCE_REMOVE;
+}
+
+int
+main (int argc, char **argv)
+{
+  DBusServer *server;
+  DBusError error;
+  gchar *tmp_dir, *socket_path, *escaped, *address;
+  gboolean success = TRUE;
+  gint i;
+
+  tmp_dir = g_dir_make_tmp ("atspi-trace-test-XXXXXX", NULL);
+  if (!tmp_dir)
+    {
+      g_print ("Failed: unable to create a temporary directory\n");
+      return 1;
+    }
+  socket_path = g_build_filename (tmp_dir, "socket", NULL);
+  escaped = dbus_address_escape_value (socket_path);
+  address = g_strconcat ("unix:path=", escaped, NULL);
+  dbus_free (escaped);
+
+  dbus_error_init (&error);
+  server = dbus_server_listen (address, &error);
+  if (!server)
+    {
+      g_print ("Failed: unable to listen on %s: %s\n", address, error.message);
+      return 1;
+    }
+  atspi_dbus_server_setup_with_g_main (server, NULL);
+  dbus_server_set_new_connection_function (server, new_connection_cb, NULL, NULL);
+
+  for (i = 0; i < N_CLIENTS; i++)
+    if (fork () == 0)
+      run_client (address);
+
+  main_loop = g_main_loop_new (NULL, FALSE);
+  g_timeout_add_seconds (10, timeout_cb, NULL);
+  g_main_loop_run (main_loop);
+
+  for (i = 0; i < N_CLIENTS; i++)
+    {
+      if (!calls[i].server_id || g_strcmp0 (calls[i].server_id, calls[i].client_id) != 0)
+        {
+          g_print ("Failed: call traced as %s by the server and %s by the client\n",
+                   calls[i].server_id, calls[i].client_id);
+          success = FALSE;
+        }
+    }
+  if (!g_strcmp0 (calls[0].server_id, calls[1].server_id))
+    {
+      g_print ("Failed: calls from two connections both traced as %s\n", calls[0].server_id);
+      success = FALSE;
+    }
+
+  for (i = 0; i < N_CLIENTS; i++)
+    {
+      int status;
+      wait (&status);
+      g_free (calls[i].server_id);
+      g_free (calls[i].client_id);
+    }
+  dbus_server_disconnect (server);
+  dbus_server_unref (server);
+  g_unlink (socket_path);
+  g_rmdir (tmp_dir);
+  g_free (address);
+  g_free (socket_path);
+  g_free (tmp_dir);
+
+  if (success)
+    return 0;
+  else
+    return 1;
+}
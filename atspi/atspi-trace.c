@@ -0,0 +1,224 @@
+/*
+ * AT-SPI - Assistive Technology Service Provider Interface
+ * (Gnome Accessibility Project; https://wiki.gnome.org/Accessibility)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Tracing of method calls across processes.
+ *
+ * When ATSPI_TRACE is set to the name of a file, clients, the registry and
+ * applications append a span to it for every method call they make or
+ * serve, in the Chrome trace event format, which chrome://tracing and the
+ * Perfetto UI can open. The two spans of a call are linked by a flow event
+ * whose id is made of the caller's process id and the path and serial of
+ * the call, so that the time of a call can be split between the client, the
+ * bus and the application, and the toolkit work it triggered found within
+ * the application's span. Serials only count the messages of a connection,
+ * and calls made on a peer-to-peer connection have no sender, so the
+ * process id is what tells calls from different clients apart.
+ *
+ * Times are read from the monotonic clock, which all the processes of a
+ * machine share. Each process opens the file for appending and writes each
+ * event with a single write, so processes can share one file. The event
+ * array is never closed, as the format allows.
+ */
+
+#include "atspi-trace.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+static int trace_fd = -1;
+
+static void
+trace_write (const gchar *str)
+{
+  if (write (trace_fd, str, strlen (str)) < 0)
+    {
+      /* Not worth disturbing the application for */
+    }
+}
+
+static void
+trace_open (void)
+{
+  const gchar *filename = g_getenv ("ATSPI_TRACE");
+  gboolean created = TRUE;
+  gchar *name, *event;
+
+  if (!filename || !*filename)
+    return;
+
+  /* Only the process that creates the file starts the event array */
+  trace_fd = open (filename, O_WRONLY | O_APPEND | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+  if (trace_fd < 0 && errno == EEXIST)
+    {
+      created = FALSE;
+      trace_fd = open (filename, O_WRONLY | O_APPEND | O_CLOEXEC);
+    }
+  if (trace_fd < 0)
+    {
+      g_warning ("AT-SPI: Unable to open trace file %s: %s", filename, g_strerror (errno));
+      return;
+    }
+
+  if (created)
+    trace_write ("[\n");
+
+  name = g_strcanon (g_strdup (g_get_prgname () ? g_get_prgname () : "unknown"),
+                     G_CSET_a_2_z G_CSET_A_2_Z G_CSET_DIGITS "-_.:/ ", '_');
+  event = g_strdup_printf ("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+                           "\"args\":{\"name\":\"%s\"}},\n",
+                           (int) getpid (), name);
+  trace_write (event);
+  g_free (event);
+  g_free (name);
+}
+
+gboolean
+_atspi_trace_enabled (void)
+{
+  static gsize initialized = 0;
+
+  if (g_once_init_enter (&initialized))
+    {
+      trace_open ();
+      g_once_init_leave (&initialized, 1);
+    }
+  return trace_fd >= 0;
+}
+
+/*
+ * Returns the id of the process that owns the unique name sender on bus.
+ * Unique names are never reused, so the answers are kept.
+ */
+static int
+sender_pid (DBusConnection *bus, const char *sender)
+{
+  static GHashTable *pids = NULL;
+  DBusMessage *message, *reply;
+  dbus_uint32_t pid = 0;
+  gpointer cached;
+
+  if (!pids)
+    pids = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  if (g_hash_table_lookup_extended (pids, sender, NULL, &cached))
+    return GPOINTER_TO_INT (cached);
+
+  message = dbus_message_new_method_call (DBUS_SERVICE_DBUS, DBUS_PATH_DBUS,
+                                          DBUS_INTERFACE_DBUS,
+                                          "GetConnectionUnixProcessID");
+  dbus_message_append_args (message, DBUS_TYPE_STRING, &sender, DBUS_TYPE_INVALID);
+  reply = dbus_connection_send_with_reply_and_block (bus, message, -1, NULL);
+  dbus_message_unref (message);
+  if (reply)
+    {
+      if (!dbus_message_get_args (reply, NULL, DBUS_TYPE_UINT32, &pid, DBUS_TYPE_INVALID))
+        pid = 0;
+      dbus_message_unref (reply);
+    }
+
+  g_hash_table_insert (pids, g_strdup (sender), GINT_TO_POINTER ((int) pid));
+  return pid;
+}
+
+/*
+ * Returns the id linking the two spans of a method call made or received
+ * on bus, made of the id of the calling process and the path and serial of
+ * the call.
+ */
+gchar *
+_atspi_trace_id (DBusConnection *bus, DBusMessage *message, gboolean client)
+{
+  const char *path = dbus_message_get_path (message);
+  const char *sender;
+  unsigned long peer_pid;
+  int pid = 0;
+
+  if (client)
+    pid = getpid ();
+  else if ((sender = dbus_message_get_sender (message)) != NULL)
+    pid = sender_pid (bus, sender);
+  else if (dbus_connection_get_unix_process_id (bus, &peer_pid))
+    pid = peer_pid;
+
+  return g_strdup_printf ("%d:%s#%u", pid, path ? path : "",
+                          dbus_message_get_serial (message));
+}
+
+/*
+ * Writes the span of a method call made or received on bus, from start_us
+ * until now, and its end of the flow linking it to the span on the other
+ * side.
+ */
+static void
+trace_span (DBusConnection *bus, DBusMessage *message, gint64 start_us, gboolean client)
+{
+  gint64 end_us = g_get_monotonic_time ();
+  const char *iface = dbus_message_get_interface (message);
+  const char *member = dbus_message_get_member (message);
+  const char *path = dbus_message_get_path (message);
+  const char *short_iface;
+  gchar *id, *events;
+  int pid = getpid ();
+
+  if (!iface || !member)
+    return;
+
+  short_iface = strrchr (iface, '.');
+  short_iface = short_iface ? short_iface + 1 : iface;
+  id = _atspi_trace_id (bus, message, client);
+
+  events = g_strdup_printf (
+      "{\"name\":\"%s.%s\",\"cat\":\"atspi\",\"ph\":\"X\",\"ts\":%" G_GINT64_FORMAT
+      ",\"dur\":%" G_GINT64_FORMAT ",\"pid\":%d,\"tid\":%d,"
+      "\"args\":{\"id\":\"%s\",\"path\":\"%s\",\"side\":\"%s\"}},\n"
+      "{\"name\":\"call\",\"cat\":\"atspi\",\"ph\":\"%s\",%s\"id\":\"%s\","
+      "\"ts\":%" G_GINT64_FORMAT ",\"pid\":%d,\"tid\":%d},\n",
+      short_iface, member, start_us, end_us - start_us, pid, pid,
+      id, path ? path : "", client ? "client" : "server",
+      client ? "s" : "f", client ? "" : "\"bp\":\"e\",", id, start_us, pid, pid);
+  trace_write (events);
+
+  g_free (events);
+  g_free (id);
+}
+
+/*
+ * Traces a method call made on bus, which started at start_us and has just
+ * been answered.
+ */
+void
+_atspi_trace_call (DBusConnection *bus, DBusMessage *message, gint64 start_us)
+{
+  if (_atspi_trace_enabled ())
+    trace_span (bus, message, start_us, TRUE);
+}
+
+/*
+ * Traces a method call that arrived on bus at start_us and has just been
+ * handled.
+ */
+void
+_atspi_trace_handled (DBusConnection *bus, DBusMessage *message, gint64 start_us)
+{
+  if (_atspi_trace_enabled ())
+    trace_span (bus, message, start_us, FALSE);
+}
@@ -0,0 +1,41 @@
+/*
+ * AT-SPI - Assistive Technology Service Provider Interface
+ * (Gnome Accessibility Project; https://wiki.gnome.org/Accessibility)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _ATSPI_TRACE_H_
+#define _ATSPI_TRACE_H_
+
+/* Private, shared by the library, the registry and the ATK bridge. */
+
+#include <dbus/dbus.h>
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+gboolean _atspi_trace_enabled (void);
+
+void _atspi_trace_call (DBusConnection *bus, DBusMessage *message, gint64 start_us);
+
+void _atspi_trace_handled (DBusConnection *bus, DBusMessage *message, gint64 start_us);
+
+gchar *_atspi_trace_id (DBusConnection *bus, DBusMessage *message, gboolean client);
+
+G_END_DECLS
+
+#endif /* _ATSPI_TRACE_H_ */
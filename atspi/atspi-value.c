@@ -71,7 +71,11 @@ atspi_value_get_current_value (AtspiValue *obj, GError **error)
 
   g_return_val_if_fail (obj != NULL, 0.0);
 
-  _atspi_dbus_get_property (obj, atspi_interface_value, "CurrentValue", error, "d", &retval);
+  if (_atspi_accessible_get_cached_value (ATSPI_ACCESSIBLE (obj), &retval))
+    return retval;
+
+  if (_atspi_dbus_get_property (obj, atspi_interface_value, "CurrentValue", error, "d", &retval))
+    _atspi_accessible_set_cached_value (ATSPI_ACCESSIBLE (obj), retval);
 
   return retval;
 }
@@ -138,6 +142,7 @@ atspi_value_set_current_value (AtspiValue *obj, gdouble new_value, GError **erro
   dbus_message_iter_close_container (&iter, &iter_variant);
   reply = _atspi_dbus_send_with_reply_and_block (message, error);
   dbus_message_unref (reply);
+  accessible->cached_properties &= ~ATSPI_CACHE_VALUE;
 
   return TRUE;
 }
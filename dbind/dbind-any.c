@@ -64,423 +64,339 @@ warn_braces ()
 
 /*---------------------------------------------------------------------------*/
 
-static unsigned int
-dbind_find_c_alignment_r (const char **type)
-{
-  unsigned int retval = 1;
-
-  char t = **type;
-  (*type)++;
-
-#ifdef DEBUG
-  fprintf (stderr, "\tfind align for %c (0x%x)\n", t, t);
-#endif
+/*
+ * Signatures are compiled once into programs: a flat array of ops holding,
+ * for each complete type in preorder, its C size and alignment and its
+ * offset within an enclosing struct, so that marshalling, demarshalling and
+ * freeing never have to re-parse the signature for every value and every
+ * array element.
+ */
 
-  switch (t)
+typedef struct _DBindOp DBindOp;
+struct _DBindOp
+{
+  char type;             /* the type code, or '(' / '{' */
+  guint align;           /* C alignment of a value */
+  gsize size;            /* C size of a value */
+  gsize offset;          /* offset of a value within its enclosing struct */
+  guint n_ops;           /* number of ops for this type, including itself */
+  guint sig_len;         /* length of this type's signature */
+  const char *signature; /* element signature, for arrays */
+};
+
+typedef struct _DBindProgram DBindProgram;
+struct _DBindProgram
+{
+  DBindOp *ops;
+  guint n_ops;
+  guint n_in_ops; /* number of ops before any "=>" */
+  guint in_len;   /* length of the signature before any "=>" */
+};
+
+/* Whether arrays of a type are laid out in memory as on the wire */
+static gboolean
+dbind_op_is_fixed (const DBindOp *op)
+{
+  switch (op->type)
     {
-    case DBUS_TYPE_BYTE:
-      return ALIGNOF_CHAR;
-    case DBUS_TYPE_BOOLEAN:
-      return ALIGNOF_DBUS_BOOL_T;
-    case DBUS_TYPE_INT16:
-    case DBUS_TYPE_UINT16:
-      return ALIGNOF_DBUS_INT16_T;
-    case DBUS_TYPE_INT32:
-    case DBUS_TYPE_UINT32:
-      return ALIGNOF_DBUS_INT32_T;
-    case DBUS_TYPE_INT64:
-    case DBUS_TYPE_UINT64:
-      return ALIGNOF_DBUS_INT64_T;
-    case DBUS_TYPE_DOUBLE:
-      return ALIGNOF_DOUBLE;
-    /* ptr types */
-    case DBUS_TYPE_STRING:
-    case DBUS_TYPE_OBJECT_PATH:
-    case DBUS_TYPE_SIGNATURE:
-    case DBUS_TYPE_ARRAY:
-      return ALIGNOF_DBIND_POINTER;
-    case DBUS_STRUCT_BEGIN_CHAR:
-      /* TODO: I think this would break with a nested struct */
-#if ALIGNOF_DBIND_STRUCT > 1
-      retval = MAX (retval, ALIGNOF_DBIND_STRUCT);
-#endif
-      while (**type != DBUS_STRUCT_END_CHAR)
-        {
-          int elem_align = dbind_find_c_alignment_r (type);
-          retval = MAX (retval, elem_align);
-        }
-      (*type)++;
-      return retval;
-    case DBUS_DICT_ENTRY_BEGIN_CHAR:
-#if ALIGNOF_DBIND_STRUCT > 1
-      retval = MAX (retval, ALIGNOF_DBIND_STRUCT);
-#endif
-      while (**type != DBUS_DICT_ENTRY_END_CHAR)
-        {
-          int elem_align = dbind_find_c_alignment_r (type);
-          retval = MAX (retval, elem_align);
-        }
-      (*type)++;
-      return retval;
-    case DBUS_TYPE_STRUCT:
-    case DBUS_TYPE_DICT_ENTRY:
-      warn_braces ();
-      return ALIGNOF_DBIND_POINTER;
-    case '\0':
-      g_assert_not_reached ();
-      break;
+    case DBIND_POD_CASES:
+      return TRUE;
     default:
-      return 1;
+      return FALSE;
     }
 }
 
-/*---------------------------------------------------------------------------*/
-
-/* gather immediate allocation information for this type */
-static size_t
-dbind_gather_alloc_info_r (const char **type)
+static guint
+dbind_compile_type (GArray *ops, const char **type)
 {
-  char t = **type;
-  (*type)++;
-  if (t == DBUS_TYPE_ARRAY)
-    {
-      switch (**type)
-        {
-        case DBUS_STRUCT_BEGIN_CHAR:
-          while (**type != DBUS_STRUCT_END_CHAR && **type != '\0')
-            (*type)++;
-          if (**type != '\0')
-            (*type)++;
-          break;
-        case DBUS_DICT_ENTRY_BEGIN_CHAR:
-          while (**type != DBUS_DICT_ENTRY_END_CHAR && **type != '\0')
-            (*type)++;
-          if (**type != '\0')
-            (*type)++;
-          break;
-        case '\0':
-          break;
-        default:
-          (*type)++;
-          break;
-        }
-    }
+  const char *start = *type;
+  guint index = ops->len;
+  DBindOp op = { 0 };
+
+  op.type = **type;
+  op.align = 1;
+  g_array_append_val (ops, op);
 
-  switch (t)
+  if (op.type != '\0')
+    (*type)++;
+
+  switch (op.type)
     {
     case DBUS_TYPE_BYTE:
-      return sizeof (char);
+      op.size = sizeof (char);
+      op.align = ALIGNOF_CHAR;
+      break;
     case DBUS_TYPE_BOOLEAN:
-      return sizeof (dbus_bool_t);
+      op.size = sizeof (dbus_bool_t);
+      op.align = ALIGNOF_DBUS_BOOL_T;
+      break;
     case DBUS_TYPE_INT16:
     case DBUS_TYPE_UINT16:
-      return sizeof (dbus_int16_t);
+      op.size = sizeof (dbus_int16_t);
+      op.align = ALIGNOF_DBUS_INT16_T;
+      break;
     case DBUS_TYPE_INT32:
     case DBUS_TYPE_UINT32:
-      return sizeof (dbus_int32_t);
+      op.size = sizeof (dbus_int32_t);
+      op.align = ALIGNOF_DBUS_INT32_T;
+      break;
     case DBUS_TYPE_INT64:
     case DBUS_TYPE_UINT64:
-      return sizeof (dbus_int64_t);
+      op.size = sizeof (dbus_int64_t);
+      op.align = ALIGNOF_DBUS_INT64_T;
+      break;
     case DBUS_TYPE_DOUBLE:
-      return sizeof (double);
+      op.size = sizeof (double);
+      op.align = ALIGNOF_DOUBLE;
+      break;
     /* ptr types */
     case DBUS_TYPE_STRING:
     case DBUS_TYPE_OBJECT_PATH:
     case DBUS_TYPE_SIGNATURE:
+      op.size = sizeof (void *);
+      op.align = ALIGNOF_DBIND_POINTER;
+      break;
     case DBUS_TYPE_ARRAY:
-      return sizeof (void *);
-    case DBUS_STRUCT_BEGIN_CHAR:
       {
-        int sum = 0, stralign;
-
-        stralign = dbind_find_c_alignment (*type - 1);
-
-        while (**type != DBUS_STRUCT_END_CHAR)
-          {
-            sum = ALIGN_VALUE (sum, dbind_find_c_alignment (*type));
-            sum += dbind_gather_alloc_info_r (type);
-          }
-        sum = ALIGN_VALUE (sum, stralign);
-
-        g_assert (**type == DBUS_STRUCT_END_CHAR);
-        (*type)++;
+        char *child_type_string;
 
-        return sum;
+        op.size = sizeof (void *);
+        op.align = ALIGNOF_DBIND_POINTER;
+        dbind_compile_type (ops, type);
+        child_type_string = g_strndup (start + 1, *type - start - 1);
+        op.signature = g_intern_string (child_type_string);
+        g_free (child_type_string);
+        break;
       }
+    case DBUS_STRUCT_BEGIN_CHAR:
     case DBUS_DICT_ENTRY_BEGIN_CHAR:
       {
-        int sum = 0, stralign;
-
-        stralign = dbind_find_c_alignment (*type - 1);
+        char end = (op.type == DBUS_STRUCT_BEGIN_CHAR ? DBUS_STRUCT_END_CHAR : DBUS_DICT_ENTRY_END_CHAR);
+        gsize offset = 0;
 
-        while (**type != DBUS_DICT_ENTRY_END_CHAR)
+#if ALIGNOF_DBIND_STRUCT > 1
+        op.align = MAX (op.align, ALIGNOF_DBIND_STRUCT);
+#endif
+        while (**type != end && **type != '\0')
           {
-            sum = ALIGN_VALUE (sum, dbind_find_c_alignment (*type));
-            sum += dbind_gather_alloc_info_r (type);
+            guint child = dbind_compile_type (ops, type);
+            DBindOp *child_op = &g_array_index (ops, DBindOp, child);
+
+            offset = ALIGN_VALUE (offset, child_op->align);
+            child_op->offset = offset;
+            offset += child_op->size;
+            op.align = MAX (op.align, child_op->align);
           }
-        sum = ALIGN_VALUE (sum, stralign);
+        op.size = ALIGN_VALUE (offset, op.align);
 
-        g_assert (**type == DBUS_DICT_ENTRY_END_CHAR);
+        g_assert (**type == end);
         (*type)++;
-
-        return sum;
+        break;
       }
     case DBUS_TYPE_STRUCT:
     case DBUS_TYPE_DICT_ENTRY:
       warn_braces ();
+      op.align = ALIGNOF_DBIND_POINTER;
+      break;
     default:
-      return 0;
+      break;
     }
+
+  op.n_ops = ops->len - index;
+  op.sig_len = *type - start;
+  g_array_index (ops, DBindOp, index) = op;
+  return index;
 }
 
-static size_t
-dbind_gather_alloc_info (const char *type)
+static DBindProgram *
+dbind_compile (const char *signature)
 {
-  return dbind_gather_alloc_info_r (&type);
+  DBindProgram *program = g_new0 (DBindProgram, 1);
+  GArray *ops = g_array_new (FALSE, FALSE, sizeof (DBindOp));
+  const char *p = signature;
+
+  while (*p != '\0' && *p != '=')
+    dbind_compile_type (ops, &p);
+  program->n_in_ops = ops->len;
+  program->in_len = p - signature;
+
+  if (p[0] == '=' && p[1] == '>')
+    p += 2;
+  while (*p != '\0')
+    dbind_compile_type (ops, &p);
+
+  program->n_ops = ops->len;
+  program->ops = (DBindOp *) g_array_free (ops, FALSE);
+  return program;
+}
+
+static GHashTable *programs = NULL;
+G_LOCK_DEFINE_STATIC (programs);
+
+/*
+ * Returns the compiled program for a signature. Signatures are almost
+ * always string literals, so the programs are kept for the life of the
+ * process.
+ */
+static const DBindProgram *
+dbind_lookup_program (const char *signature)
+{
+  DBindProgram *program;
+
+  G_LOCK (programs);
+  if (!programs)
+    programs = g_hash_table_new (g_str_hash, g_str_equal);
+  program = g_hash_table_lookup (programs, signature);
+  if (!program)
+    {
+      program = dbind_compile (signature);
+      g_hash_table_insert (programs, g_strdup (signature), program);
+    }
+  G_UNLOCK (programs);
+
+  return program;
 }
 
 /*---------------------------------------------------------------------------*/
 
 static void
-dbind_any_free_r (const char **type, void **data)
+dbind_free_op (const DBindOp *op, gpointer data)
 {
 #ifdef DEBUG
-  fprintf (stderr, "any free '%c' to %p\n", **type, *data);
+  fprintf (stderr, "any free '%c' to %p\n", op->type, data);
 #endif
 
-  switch (**type)
+  switch (op->type)
     {
-    case DBIND_POD_CASES:
-      *data = ((guchar *) *data) + dbind_gather_alloc_info (*type);
-      (*type)++;
-      break;
     case DBUS_TYPE_STRING:
     case DBUS_TYPE_OBJECT_PATH:
     case DBUS_TYPE_SIGNATURE:
 #ifdef DEBUG
-      fprintf (stderr, "string free %p\n", **(void ***) data);
+      fprintf (stderr, "string free %p\n", *(void **) data);
 #endif
-      g_free (**(void ***) data);
-      *data = ((guchar *) *data) + dbind_gather_alloc_info (*type);
-      (*type)++;
+      g_free (*(void **) data);
       break;
     case DBUS_TYPE_ARRAY:
       {
-        int i;
-        GArray *vals = **(void ***) data;
-        size_t elem_size, elem_align;
-        const char *saved_child_type;
+        const DBindOp *elem = op + 1;
+        GArray *vals = *(GArray **) data;
+        guint i;
 
-        (*type)++;
-        saved_child_type = *type;
-
-        elem_size = dbind_gather_alloc_info (*type);
-        elem_align = dbind_find_c_alignment_r (type);
-
-        for (i = 0; i < vals->len; i++)
+        if (!dbind_op_is_fixed (elem))
           {
-            void *ptr = vals->data + elem_size * i;
-            *type = saved_child_type; /* rewind type info */
-            ptr = ALIGN_ADDRESS (ptr, elem_align);
-            dbind_any_free_r (type, &ptr);
+            for (i = 0; i < vals->len; i++)
+              dbind_free_op (elem, ALIGN_ADDRESS (vals->data + elem->size * i, elem->align));
           }
         g_array_free (vals, TRUE);
         break;
       }
     case DBUS_STRUCT_BEGIN_CHAR:
-      {
-        gconstpointer data0 = *data;
-        int offset = 0, stralign;
-
-        stralign = dbind_find_c_alignment (*type);
-        (*type)++;
-
-        offset = 0;
-        while (**type != DBUS_STRUCT_END_CHAR)
-          {
-            const char *subt = *type;
-            offset = ALIGN_VALUE (offset, dbind_find_c_alignment (*type));
-            *data = PTR_PLUS (data0, offset);
-            dbind_any_free_r (type, data);
-            offset += dbind_gather_alloc_info (subt);
-          }
-
-        offset = ALIGN_VALUE (offset, stralign);
-        *data = PTR_PLUS (data0, offset);
-
-        g_assert (**type == DBUS_STRUCT_END_CHAR);
-        (*type)++;
-
-        break;
-      }
     case DBUS_DICT_ENTRY_BEGIN_CHAR:
       {
-        gconstpointer data0 = *data;
-        int offset = 0, stralign;
-
-        stralign = dbind_find_c_alignment (*type);
-        (*type)++;
-
-        offset = 0;
-        while (**type != DBUS_DICT_ENTRY_END_CHAR)
-          {
-            const char *subt = *type;
-            offset = ALIGN_VALUE (offset, dbind_find_c_alignment (*type));
-            *data = PTR_PLUS (data0, offset);
-            dbind_any_free_r (type, data);
-            offset += dbind_gather_alloc_info (subt);
-          }
-
-        offset = ALIGN_VALUE (offset, stralign);
-        *data = PTR_PLUS (data0, offset);
-
-        g_assert (**type == DBUS_DICT_ENTRY_END_CHAR);
-        (*type)++;
+        const DBindOp *child, *end = op + op->n_ops;
 
+        for (child = op + 1; child < end; child += child->n_ops)
+          dbind_free_op (child, PTR_PLUS (data, child->offset));
         break;
       }
-    case DBUS_TYPE_STRUCT:
-    case DBUS_TYPE_DICT_ENTRY:
-      warn_braces ();
+    default:
       break;
     }
 }
 
 /*---------------------------------------------------------------------------*/
 
-void
-dbind_any_marshal (DBusMessageIter *iter,
-                   const char **type,
-                   void **data)
+static void
+dbind_marshal_op (DBusMessageIter *iter, const DBindOp *op, gconstpointer data)
 {
-  size_t len;
-
 #ifdef DEBUG
-  fprintf (stderr, "any marshal '%c' to %p\n", **type, *data);
+  fprintf (stderr, "any marshal '%c' to %p\n", op->type, data);
 #endif
 
-  switch (**type)
+  switch (op->type)
     {
     case DBIND_POD_CASES:
     case DBUS_TYPE_STRING:
     case DBUS_TYPE_OBJECT_PATH:
     case DBUS_TYPE_SIGNATURE:
-      len = dbind_gather_alloc_info (*type);
-      dbus_message_iter_append_basic (iter, **type, *data);
-      *data = ((guchar *) *data) + len;
-      (*type)++;
+      dbus_message_iter_append_basic (iter, op->type, data);
       break;
     case DBUS_TYPE_ARRAY:
       {
-        int i;
-        GArray *vals = **(void ***) data;
-        size_t elem_size, elem_align;
+        const DBindOp *elem = op + 1;
+        GArray *vals = *(GArray **) data;
         DBusMessageIter sub;
-        const char *saved_child_type;
-        char *child_type_string;
-
-        (*type)++;
-        saved_child_type = *type;
+        guint i;
 
-        elem_size = dbind_gather_alloc_info (*type);
-        elem_align = dbind_find_c_alignment_r (type);
-
-        /* wow this part of the API sucks too ... */
-        child_type_string = g_strndup (saved_child_type, *type - saved_child_type);
-        /* fprintf (stderr, "array child type '%s'\n", child_type_string); */
-        dbus_message_iter_open_container (iter, DBUS_TYPE_ARRAY,
-                                          child_type_string, &sub);
-        for (i = 0; i < vals->len; i++)
+        dbus_message_iter_open_container (iter, DBUS_TYPE_ARRAY, op->signature, &sub);
+        if (dbind_op_is_fixed (elem))
           {
-            void *ptr = vals->data + elem_size * i;
-            *type = saved_child_type; /* rewind type info */
-            ptr = ALIGN_ADDRESS (ptr, elem_align);
-            dbind_any_marshal (&sub, type, &ptr);
+            const char *elems = vals->data;
+            dbus_message_iter_append_fixed_array (&sub, elem->type, &elems, vals->len);
           }
-
-        dbus_message_iter_close_container (iter, &sub);
-        g_free (child_type_string);
-        break;
-      }
-    case DBUS_STRUCT_BEGIN_CHAR:
-      {
-        gconstpointer data0 = *data;
-        int offset = 0, stralign;
-        DBusMessageIter sub;
-
-        stralign = dbind_find_c_alignment (*type);
-
-        (*type)++;
-
-        dbus_message_iter_open_container (iter, DBUS_TYPE_STRUCT, NULL, &sub);
-
-        offset = 0;
-        while (**type != DBUS_STRUCT_END_CHAR)
+        else
           {
-            const char *subt = *type;
-            offset = ALIGN_VALUE (offset, dbind_find_c_alignment (*type));
-            *data = PTR_PLUS (data0, offset);
-            dbind_any_marshal (&sub, type, data);
-            offset += dbind_gather_alloc_info (subt);
+            for (i = 0; i < vals->len; i++)
+              dbind_marshal_op (&sub, elem, ALIGN_ADDRESS (vals->data + elem->size * i, elem->align));
           }
-
-        offset = ALIGN_VALUE (offset, stralign);
-        *data = PTR_PLUS (data0, offset);
-
         dbus_message_iter_close_container (iter, &sub);
-
-        g_assert (**type == DBUS_STRUCT_END_CHAR);
-        (*type)++;
-
         break;
       }
+    case DBUS_STRUCT_BEGIN_CHAR:
     case DBUS_DICT_ENTRY_BEGIN_CHAR:
       {
-        gconstpointer data0 = *data;
-        int offset = 0, stralign;
+        const DBindOp *child, *end = op + op->n_ops;
         DBusMessageIter sub;
 
-        stralign = dbind_find_c_alignment (*type);
-
-        (*type)++;
-
-        dbus_message_iter_open_container (iter, DBUS_TYPE_DICT_ENTRY, NULL, &sub);
-
-        offset = 0;
-        while (**type != DBUS_DICT_ENTRY_END_CHAR)
-          {
-            const char *subt = *type;
-            offset = ALIGN_VALUE (offset, dbind_find_c_alignment (*type));
-            *data = PTR_PLUS (data0, offset);
-            dbind_any_marshal (&sub, type, data);
-            offset += dbind_gather_alloc_info (subt);
-          }
-
-        offset = ALIGN_VALUE (offset, stralign);
-        *data = PTR_PLUS (data0, offset);
-
+        dbus_message_iter_open_container (iter,
+                                          op->type == DBUS_STRUCT_BEGIN_CHAR ? DBUS_TYPE_STRUCT : DBUS_TYPE_DICT_ENTRY,
+                                          NULL, &sub);
+        for (child = op + 1; child < end; child += child->n_ops)
+          dbind_marshal_op (&sub, child, PTR_PLUS (data, child->offset));
         dbus_message_iter_close_container (iter, &sub);
-
-        g_assert (**type == DBUS_DICT_ENTRY_END_CHAR);
-        (*type)++;
-
         break;
       }
-    case DBUS_TYPE_STRUCT:
-    case DBUS_TYPE_DICT_ENTRY:
-      warn_braces ();
+    default:
       break;
     }
 }
 
+void
+dbind_any_marshal (DBusMessageIter *iter,
+                   const char **type,
+                   void **data)
+{
+  const DBindProgram *program = dbind_lookup_program (*type);
+
+  if (program->n_ops == 0)
+    return;
+
+  dbind_marshal_op (iter, program->ops, *data);
+  *data = PTR_PLUS (*data, program->ops->size);
+  *type += program->ops->sig_len;
+}
+
 /*---------------------------------------------------------------------------*/
 
+typedef union
+{
+  unsigned char byte;
+  dbus_bool_t boolean;
+  dbus_int16_t int16;
+  dbus_int32_t int32;
+  dbus_int64_t int64;
+  double dbl;
+  void *ptr;
+} DBindArg;
+
 void
 dbind_any_marshal_va (DBusMessageIter *iter,
                       const char **arg_types,
                       va_list args)
 {
   const char *p = *arg_types;
+  const DBindProgram *program;
+  const DBindOp *op, *end;
 
   /* Guard against null arg types
      Fix for - http://bugs.freedesktop.org/show_bug.cgi?id=23027
@@ -488,238 +404,164 @@ dbind_any_marshal_va (DBusMessageIter *iter,
   if (p == NULL)
     p = "";
 
-  {
-    /* special case base-types since we need to walk the stack worse-luck */
-    for (; *p != '\0' && *p != '=';)
-      {
-        int intarg;
-        void *ptrarg;
-        double doublearg;
-        dbus_int64_t int64arg;
-        void *arg = NULL;
+  program = dbind_lookup_program (p);
+  end = program->ops + program->n_in_ops;
 
-        switch (*p)
-          {
-          case DBUS_TYPE_BYTE:
-          case DBUS_TYPE_BOOLEAN:
-          case DBUS_TYPE_INT16:
-          case DBUS_TYPE_UINT16:
-          case DBUS_TYPE_INT32:
-          case DBUS_TYPE_UINT32:
-            intarg = va_arg (args, int);
-            arg = &intarg;
-            break;
-          case DBUS_TYPE_INT64:
-          case DBUS_TYPE_UINT64:
-            int64arg = va_arg (args, dbus_int64_t);
-            arg = &int64arg;
-            break;
-          case DBUS_TYPE_DOUBLE:
-            doublearg = va_arg (args, double);
-            arg = &doublearg;
-            break;
-          /* ptr types */
-          case DBUS_TYPE_STRING:
-          case DBUS_TYPE_OBJECT_PATH:
-          case DBUS_TYPE_SIGNATURE:
-          case DBUS_TYPE_ARRAY:
-          case DBUS_TYPE_DICT_ENTRY:
-            ptrarg = va_arg (args, void *);
-            arg = &ptrarg;
-            break;
-          case DBUS_STRUCT_BEGIN_CHAR:
-            ptrarg = va_arg (args, void *);
-            arg = ptrarg;
-            break;
-          case DBUS_DICT_ENTRY_BEGIN_CHAR:
-            ptrarg = va_arg (args, void *);
-            arg = ptrarg;
-            break;
+  /* special case base-types since we need to walk the stack worse-luck */
+  for (op = program->ops; op < end; op += op->n_ops)
+    {
+      DBindArg value;
+      void *arg = NULL;
 
-          case DBUS_TYPE_VARIANT:
-            fprintf (stderr, "No variant support yet - very toolkit specific\n");
-            ptrarg = va_arg (args, void *);
-            arg = &ptrarg;
-            break;
-          default:
-            fprintf (stderr, "Unknown / invalid arg type %c\n", *p);
-            break;
-          }
-        if (arg != NULL)
-          dbind_any_marshal (iter, &p, &arg);
-      }
-    if (*arg_types)
-      *arg_types = p;
-  }
+      switch (op->type)
+        {
+        case DBUS_TYPE_BYTE:
+          value.byte = va_arg (args, int);
+          arg = &value.byte;
+          break;
+        case DBUS_TYPE_BOOLEAN:
+          value.boolean = va_arg (args, int);
+          arg = &value.boolean;
+          break;
+        case DBUS_TYPE_INT16:
+        case DBUS_TYPE_UINT16:
+          value.int16 = va_arg (args, int);
+          arg = &value.int16;
+          break;
+        case DBUS_TYPE_INT32:
+        case DBUS_TYPE_UINT32:
+          value.int32 = va_arg (args, int);
+          arg = &value.int32;
+          break;
+        case DBUS_TYPE_INT64:
+        case DBUS_TYPE_UINT64:
+          value.int64 = va_arg (args, dbus_int64_t);
+          arg = &value.int64;
+          break;
+        case DBUS_TYPE_DOUBLE:
+          value.dbl = va_arg (args, double);
+          arg = &value.dbl;
+          break;
+        /* ptr types */
+        case DBUS_TYPE_STRING:
+        case DBUS_TYPE_OBJECT_PATH:
+        case DBUS_TYPE_SIGNATURE:
+        case DBUS_TYPE_ARRAY:
+        case DBUS_TYPE_DICT_ENTRY:
+          value.ptr = va_arg (args, void *);
+          arg = &value.ptr;
+          break;
+        case DBUS_STRUCT_BEGIN_CHAR:
+        case DBUS_DICT_ENTRY_BEGIN_CHAR:
+          arg = va_arg (args, void *);
+          break;
+
+        case DBUS_TYPE_VARIANT:
+          fprintf (stderr, "No variant support yet - very toolkit specific\n");
+          va_arg (args, void *);
+          break;
+        default:
+          fprintf (stderr, "Unknown / invalid arg type %c\n", op->type);
+          break;
+        }
+      if (arg != NULL)
+        dbind_marshal_op (iter, op, arg);
+    }
+  if (*arg_types)
+    *arg_types = p + program->in_len;
 }
 
 /*---------------------------------------------------------------------------*/
 
-void
-dbind_any_demarshal (DBusMessageIter *iter,
-                     const char **type,
-                     void **data)
+static void
+dbind_demarshal_op (DBusMessageIter *iter, const DBindOp *op, gpointer data)
 {
-  size_t len;
-
 #ifdef DEBUG
-  fprintf (stderr, "any demarshal '%c' to %p\n", **type, *data);
+  fprintf (stderr, "any demarshal '%c' to %p\n", op->type, data);
 #endif
 
-  switch (**type)
+  switch (op->type)
     {
     case DBIND_POD_CASES:
-      len = dbind_gather_alloc_info (*type);
-      dbus_message_iter_get_basic (iter, *data);
-      *data = ((guchar *) *data) + len;
-      (*type)++;
+      dbus_message_iter_get_basic (iter, data);
       break;
     case DBUS_TYPE_STRING:
     case DBUS_TYPE_OBJECT_PATH:
     case DBUS_TYPE_SIGNATURE:
-      len = dbind_gather_alloc_info (*type);
-      dbus_message_iter_get_basic (iter, *data);
+      dbus_message_iter_get_basic (iter, data);
 #ifdef DEBUG
-      fprintf (stderr, "dup string '%s' (%p)\n", **(void ***) data, **(void ***) data);
+      fprintf (stderr, "dup string '%s' (%p)\n", *(char **) data, *(char **) data);
 #endif
-      **(void ***) data = g_strdup (**(void ***) data);
-      *data = ((guchar *) *data) + len;
-      (*type)++;
+      *(char **) data = g_strdup (*(char **) data);
       break;
     case DBUS_TYPE_ARRAY:
       {
+        const DBindOp *elem = op + 1;
         GArray *vals;
         DBusMessageIter child;
-        size_t elem_size, elem_align;
-        const char *stored_child_type;
-        int i;
+        guint i;
 
-        (*type)++;
-        stored_child_type = *type;
+        vals = g_array_new (FALSE, FALSE, elem->size);
+        *(GArray **) data = vals;
 
-        elem_size = dbind_gather_alloc_info (*type);
-        elem_align = dbind_find_c_alignment_r (type);
-        vals = g_array_new (FALSE, FALSE, elem_size);
-        (**(void ***) data) = vals;
-        *data = ((guchar *) *data) + sizeof (void *);
+        dbus_message_iter_recurse (iter, &child);
+        if (dbind_op_is_fixed (elem) &&
+            dbus_message_iter_get_arg_type (&child) == elem->type)
+          {
+            const char *elems;
+            int n_elems;
+
+            dbus_message_iter_get_fixed_array (&child, &elems, &n_elems);
+            g_array_append_vals (vals, elems, n_elems);
+            break;
+          }
 
         i = 0;
-        dbus_message_iter_recurse (iter, &child);
         while (dbus_message_iter_get_arg_type (&child) != DBUS_TYPE_INVALID)
           {
-            void *ptr;
-            const char *subt = stored_child_type;
             g_array_set_size (vals, i + 1);
-            ptr = vals->data + elem_size * i;
-            ptr = ALIGN_ADDRESS (ptr, elem_align);
-            dbind_any_demarshal (&child, &subt, &ptr);
+            dbind_demarshal_op (&child, elem, ALIGN_ADDRESS (vals->data + elem->size * i, elem->align));
+            dbus_message_iter_next (&child);
             i++;
-          };
-        break;
-      }
-    case DBUS_STRUCT_BEGIN_CHAR:
-      {
-        gconstpointer data0 = *data;
-        int offset = 0, stralign;
-        DBusMessageIter child;
-
-        stralign = dbind_find_c_alignment (*type);
-
-        (*type)++;
-
-        dbus_message_iter_recurse (iter, &child);
-
-        while (**type != DBUS_STRUCT_END_CHAR)
-          {
-            const char *subt = *type;
-            offset = ALIGN_VALUE (offset, dbind_find_c_alignment (*type));
-            *data = PTR_PLUS (data0, offset);
-            dbind_any_demarshal (&child, type, data);
-            offset += dbind_gather_alloc_info (subt);
           }
-
-        offset = ALIGN_VALUE (offset, stralign);
-        *data = PTR_PLUS (data0, offset);
-
-        g_assert (**type == DBUS_STRUCT_END_CHAR);
-        (*type)++;
-
         break;
       }
+    case DBUS_STRUCT_BEGIN_CHAR:
     case DBUS_DICT_ENTRY_BEGIN_CHAR:
       {
-        gconstpointer data0 = *data;
-        int offset = 0, stralign;
+        const DBindOp *child_op, *end = op + op->n_ops;
         DBusMessageIter child;
 
-        stralign = dbind_find_c_alignment (*type);
-
-        (*type)++;
-
         dbus_message_iter_recurse (iter, &child);
-
-        while (**type != DBUS_DICT_ENTRY_END_CHAR)
+        for (child_op = op + 1; child_op < end; child_op += child_op->n_ops)
           {
-            const char *subt = *type;
-            offset = ALIGN_VALUE (offset, dbind_find_c_alignment (*type));
-            *data = PTR_PLUS (data0, offset);
-            dbind_any_demarshal (&child, type, data);
-            offset += dbind_gather_alloc_info (subt);
+            dbind_demarshal_op (&child, child_op, PTR_PLUS (data, child_op->offset));
+            dbus_message_iter_next (&child);
           }
-
-        offset = ALIGN_VALUE (offset, stralign);
-        *data = PTR_PLUS (data0, offset);
-
-        g_assert (**type == DBUS_DICT_ENTRY_END_CHAR);
-        (*type)++;
-
-        break;
-      case DBUS_TYPE_VARIANT:
-        /* skip; unimplemented for now */
-        (*type)++;
         break;
       }
-    case DBUS_TYPE_STRUCT:
-    case DBUS_TYPE_DICT_ENTRY:
-      warn_braces ();
+    case DBUS_TYPE_VARIANT:
+      /* skip; unimplemented for now */
+      break;
+    default:
       break;
     }
-  dbus_message_iter_next (iter);
 }
 
-static const char *
-pass_complex_arg (const char *p, char begin, char end)
+void
+dbind_any_demarshal (DBusMessageIter *iter,
+                     const char **type,
+                     void **data)
 {
-  int level = 1;
+  const DBindProgram *program = dbind_lookup_program (*type);
 
-  p++;
-  while (*p && level > 0)
-    {
-      if (*p == begin)
-        level++;
-      else if (*p == end)
-        level--;
-      p++;
-    }
-  if (*p == end)
-    p++;
-  return p;
-}
+  if (program->n_ops == 0)
+    return;
 
-static const char *
-pass_arg (const char *p)
-{
-  switch (*p)
-    {
-    case '(':
-      return pass_complex_arg (p, '(', ')');
-    case '{':
-      return pass_complex_arg (p, '{', '}');
-    case 'a':
-      return pass_arg (p + 1);
-    default:
-      return p + 1;
-    }
+  dbind_demarshal_op (iter, program->ops, *data);
+  dbus_message_iter_next (iter);
+  *data = PTR_PLUS (*data, program->ops->size);
+  *type += program->ops->sig_len;
 }
 
 /*---------------------------------------------------------------------------*/
@@ -729,12 +571,16 @@ dbind_any_demarshal_va (DBusMessageIter *iter,
                         const char **arg_types,
                         va_list args)
 {
-  const char *p = *arg_types;
+  const DBindProgram *program = dbind_lookup_program (*arg_types);
+  const DBindOp *op, *in_end, *end;
+
+  in_end = program->ops + program->n_in_ops;
+  end = program->ops + program->n_ops;
 
   /* Just consume the in args without doing anything to them */
-  for (; *p != '\0' && *p != '=';)
+  for (op = program->ops; op < in_end; op += op->n_ops)
     {
-      switch (*p)
+      switch (op->type)
         {
         case DBUS_TYPE_BYTE:
         case DBUS_TYPE_BOOLEAN:
@@ -757,11 +603,7 @@ dbind_any_demarshal_va (DBusMessageIter *iter,
         case DBUS_TYPE_SIGNATURE:
         case DBUS_TYPE_ARRAY:
         case DBUS_TYPE_DICT_ENTRY:
-          va_arg (args, void *);
-          break;
         case DBUS_STRUCT_BEGIN_CHAR:
-          va_arg (args, void *);
-          break;
         case DBUS_DICT_ENTRY_BEGIN_CHAR:
           va_arg (args, void *);
           break;
@@ -771,19 +613,16 @@ dbind_any_demarshal_va (DBusMessageIter *iter,
           va_arg (args, void *);
           break;
         default:
-          fprintf (stderr, "Unknown / invalid arg type %c\n", *p);
+          fprintf (stderr, "Unknown / invalid arg type %c\n", op->type);
           break;
         }
-      p = pass_arg (p);
     }
 
-  if (p[0] == '=' && p[1] == '>')
-    p += 2;
-
-  for (; *p != '\0';)
+  for (; op < end; op += op->n_ops)
     {
       void *arg = va_arg (args, void *);
-      dbind_any_demarshal (iter, &p, &arg);
+      dbind_demarshal_op (iter, op, arg);
+      dbus_message_iter_next (iter);
     }
 }
 
@@ -794,7 +633,10 @@ void
 dbind_any_free (const char *type,
                 void *ptr)
 {
-  dbind_any_free_r (&type, &ptr);
+  const DBindProgram *program = dbind_lookup_program (type);
+
+  if (program->n_ops > 0)
+    dbind_free_op (program->ops, ptr);
 }
 
 /* should this be the default normalization ? */
@@ -809,7 +651,9 @@ dbind_any_free_ptr (const char *type, void *ptr)
 unsigned int
 dbind_find_c_alignment (const char *type)
 {
-  return dbind_find_c_alignment_r (&type);
+  const DBindProgram *program = dbind_lookup_program (type);
+
+  return program->n_ops > 0 ? program->ops->align : 1;
 }
 
 /*END------------------------------------------------------------------------*/
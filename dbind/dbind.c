@@ -29,6 +29,8 @@
 
 static int dbind_timeout = -1;
 
+static DBindTraceFunction dbind_trace_func = NULL;
+
 /*
  * FIXME: compare types - to ensure they match &
  *        do dynamic padding of structures etc.
@@ -59,8 +61,8 @@ time_elapsed (struct timeval *origin)
   return (tv.tv_sec - origin->tv_sec) * 1000 + (tv.tv_usec - origin->tv_usec) / 1000;
 }
 
-DBusMessage *
-dbind_send_and_allow_reentry (DBusConnection *bus, DBusMessage *message, DBusError *error)
+static DBusMessage *
+send_and_allow_reentry (DBusConnection *bus, DBusMessage *message, DBusError *error)
 {
   DBusPendingCall *pending;
   SpiReentrantCallClosure *closure;
@@ -122,6 +124,21 @@ dbind_send_and_allow_reentry (DBusConnection *bus, DBusMessage *message, DBusErr
   return ret;
 }
 
+DBusMessage *
+dbind_send_and_allow_reentry (DBusConnection *bus, DBusMessage *message, DBusError *error)
+{
+  gint64 start_us;
+  DBusMessage *reply;
+
+  if (!dbind_trace_func)
+    return send_and_allow_reentry (bus, message, error);
+
+  start_us = g_get_monotonic_time ();
+  reply = send_and_allow_reentry (bus, message, error);
+  dbind_trace_func (bus, message, start_us);
+  return reply;
+}
+
 dbus_bool_t
 dbind_method_call_reentrant_va (DBusConnection *cnx,
                                 const char *bus_name,
@@ -322,4 +339,14 @@ dbind_set_timeout (int timeout)
   dbind_timeout = timeout;
 }
 
+/*
+ * Sets a function to be called after each call made with
+ * dbind_send_and_allow_reentry, with the time the call was sent.
+ */
+void
+dbind_set_trace_func (DBindTraceFunction func)
+{
+  dbind_trace_func = func;
+}
+
 /*END------------------------------------------------------------------------*/
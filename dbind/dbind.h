@@ -23,6 +23,9 @@
 #define DBUS_API_SUBJECT_TO_CHANGE
 #include <dbind/dbind-any.h>
 #include <dbus/dbus.h>
+#include <glib.h>
+
+typedef void (*DBindTraceFunction) (DBusConnection *, DBusMessage *, gint64);
 
 DBusMessage *
 dbind_send_and_allow_reentry (DBusConnection *bus, DBusMessage *message, DBusError *error);
@@ -66,4 +69,6 @@ dbind_method_call (DBusConnection *cnx,
                    ...);
 
 void dbind_set_timeout (int timeout);
+
+void dbind_set_trace_func (DBindTraceFunction func);
 #endif /* _DBIND_H_ */
@@ -355,6 +355,124 @@ test_twovals ()
   printf ("two-val ok\n");
 }
 
+void
+test_fixed_arrays ()
+{
+  typedef struct
+  {
+    GArray *bytes;
+    GArray *bools;
+    GArray *doubles;
+  } FixedArrays;
+#define TYPEOF_FIXEDARRAYS         \
+  DBUS_STRUCT_BEGIN_CHAR_AS_STRING \
+  DBUS_TYPE_ARRAY_AS_STRING        \
+  DBUS_TYPE_BYTE_AS_STRING         \
+  DBUS_TYPE_ARRAY_AS_STRING        \
+  DBUS_TYPE_BOOLEAN_AS_STRING      \
+  DBUS_TYPE_ARRAY_AS_STRING        \
+  DBUS_TYPE_DOUBLE_AS_STRING       \
+  DBUS_STRUCT_END_CHAR_AS_STRING
+
+  DBusMessage *msg;
+  FixedArrays f1, f2;
+  int i, j;
+
+  f1.bytes = g_array_new (FALSE, FALSE, sizeof (unsigned char));
+  f1.bools = g_array_new (FALSE, FALSE, sizeof (dbus_bool_t));
+  f1.doubles = g_array_new (FALSE, FALSE, sizeof (double));
+  for (i = 0; i < 1000; i++)
+    {
+      unsigned char b = i;
+      dbus_bool_t t = (i % 3 == 0);
+      double d = i / 4.0;
+      g_array_append_val (f1.bytes, b);
+      g_array_append_val (f1.bools, t);
+      g_array_append_val (f1.doubles, d);
+    }
+
+  /* the second round uses the cached program for the signature */
+  for (j = 0; j < 2; j++)
+    {
+      msg = dbus_message_new (DBUS_MESSAGE_TYPE_METHOD_CALL);
+      marshal (msg, TYPEOF_FIXEDARRAYS, &f1);
+      demarshal (msg, TYPEOF_FIXEDARRAYS, &f2);
+
+      g_assert (f2.bytes->len == 1000);
+      g_assert (f2.bools->len == 1000);
+      g_assert (f2.doubles->len == 1000);
+      for (i = 0; i < 1000; i++)
+        {
+          g_assert (g_array_index (f2.bytes, unsigned char, i) == (unsigned char) i);
+          g_assert (g_array_index (f2.bools, dbus_bool_t, i) == (i % 3 == 0));
+          g_assert (g_array_index (f2.doubles, double, i) == i / 4.0);
+        }
+
+      dbind_any_free (TYPEOF_FIXEDARRAYS, &f2);
+      dbus_message_unref (msg);
+    }
+
+  g_array_free (f1.bytes, TRUE);
+  g_array_free (f1.bools, TRUE);
+  g_array_free (f1.doubles, TRUE);
+
+  printf ("fixed arrays ok\n");
+}
+
+static void
+marshal_va (DBusMessage *msg, const char **arg_types, ...)
+{
+  DBusMessageIter iter;
+  va_list args;
+
+  va_start (args, arg_types);
+  dbus_message_iter_init_append (msg, &iter);
+  dbind_any_marshal_va (&iter, arg_types, args);
+  va_end (args);
+}
+
+static void
+demarshal_va (DBusMessage *msg, const char **arg_types, ...)
+{
+  DBusMessageIter iter;
+  va_list args;
+
+  va_start (args, arg_types);
+  dbus_message_iter_init (msg, &iter);
+  dbind_any_demarshal_va (&iter, arg_types, args);
+  va_end (args);
+}
+
+void
+test_va ()
+{
+  DBusMessage *msg;
+  const char *type = "ynbds=>ynbds";
+  unsigned char y = 0;
+  dbus_int16_t n = 0;
+  dbus_bool_t b = FALSE;
+  double d = 0;
+  char *str = NULL;
+
+  msg = dbus_message_new (DBUS_MESSAGE_TYPE_METHOD_CALL);
+  marshal_va (msg, &type, 200, -300, TRUE, 2.5, "va");
+  g_assert (!strcmp (type, "=>ynbds"));
+  g_assert (dbus_message_has_signature (msg, "ynbds"));
+
+  type = "ynbds=>ynbds";
+  demarshal_va (msg, &type, 0, 0, FALSE, 0.0, "", &y, &n, &b, &d, &str);
+  g_assert (y == 200);
+  g_assert (n == -300);
+  g_assert (b == TRUE);
+  g_assert (d == 2.5);
+  g_assert (!strcmp (str, "va"));
+
+  g_free (str);
+  dbus_message_unref (msg);
+
+  printf ("varargs ok\n");
+}
+
 void
 test_marshalling ()
 {
@@ -365,6 +483,8 @@ test_marshalling ()
   test_struct_complex ();
   test_struct_with_array ();
   test_twovals ();
+  test_fixed_arrays ();
+  test_va ();
 
   printf ("Marshalling ok\n");
 }
@@ -376,6 +496,7 @@ test_helpers ()
   dbind_find_c_alignment ("a(sss)");
   dbind_find_c_alignment ("(s(s)yd(d)s)");
   dbind_find_c_alignment ("a{ss}");
+  g_assert (dbind_find_c_alignment ("(yd)") == dbind_find_c_alignment ("d"));
   printf ("helpers passed\n");
 }
 
@@ -20,6 +20,9 @@
  * Boston, MA 02110-1301, USA.
  */
 
+#include <stdlib.h>
+#include <string.h>
+
 #include "droute-pairhash.h"
 
 /*---------------------------------------------------------------------------*/
@@ -84,4 +87,252 @@ str_pair_equal (gconstpointer a, gconstpointer b)
     }
 }
 
+/*---------------------------------------------------------------------------*/
+
+/*
+ * A read-only perfect hash table of string pairs, built with the hash and
+ * displace method once all the pairs are known. A lookup hashes the pair
+ * and needs at most one displacement to find the only slot the pair can be
+ * in, which is then checked with two string comparisons.
+ *
+ * To keep hashing cheap, only the length and last two characters of the
+ * first string (an interface name) are hashed, with the whole of the second
+ * (a member name). If pairs in the table can't be told apart that way, the
+ * table falls back to looking them up in the hash table it was built from.
+ */
+
+#define MAX_DISPLACEMENT (1 << 16)
+
+typedef struct _StrPairSlot
+{
+  const gchar *one;
+  const gchar *two;
+  gpointer value;
+} StrPairSlot;
+
+struct _StrPairTable
+{
+  guint size;
+  gint *displacements;
+  StrPairSlot *slots;
+  GHashTable *fallback;
+};
+
+typedef struct _StrPairItem
+{
+  guint32 key;
+  StrPair *pair;
+  gpointer value;
+} StrPairItem;
+
+static guint32
+str_pair_key (const gchar *one, const gchar *two)
+{
+  gsize len = strlen (one);
+  guint32 key = len;
+
+  if (len >= 2)
+    key = (key << 16) ^ ((guchar) one[len - 2] << 8) ^ (guchar) one[len - 1];
+  for (; *two != '\0'; two++)
+    key = (key << 5) - key + (guchar) *two;
+
+  return key;
+}
+
+static guint32
+str_pair_mix (guint32 displacement, guint32 key)
+{
+  guint32 h = key ^ (displacement * 0x9e3779b1u);
+
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
+  return h;
+}
+
+typedef struct _StrPairBucket
+{
+  guint index;
+  GArray *items;
+} StrPairBucket;
+
+static gint
+compare_bucket_length (gconstpointer a, gconstpointer b)
+{
+  const StrPairBucket *bucket_a = *(StrPairBucket *const *) a;
+  const StrPairBucket *bucket_b = *(StrPairBucket *const *) b;
+
+  return (gint) bucket_b->items->len - (gint) bucket_a->items->len;
+}
+
+/* Finds a displacement that moves every item of a bucket to a free slot */
+static gboolean
+place_bucket (StrPairTable *table, StrPairBucket *bucket, guint *slots)
+{
+  GArray *items = bucket->items;
+  guint32 d;
+  guint i, j;
+
+  /* Items with the same key can never be separated */
+  for (i = 0; i < items->len; i++)
+    for (j = 0; j < i; j++)
+      if (g_array_index (items, StrPairItem, i).key == g_array_index (items, StrPairItem, j).key)
+        return FALSE;
+
+  for (d = 1; d < MAX_DISPLACEMENT; d++)
+    {
+      for (i = 0; i < items->len; i++)
+        {
+          slots[i] = str_pair_mix (d, g_array_index (items, StrPairItem, i).key) % table->size;
+          if (table->slots[slots[i]].two)
+            break;
+          for (j = 0; j < i && slots[j] != slots[i]; j++)
+            ;
+          if (j < i)
+            break;
+        }
+      if (i < items->len)
+        continue;
+
+      for (i = 0; i < items->len; i++)
+        {
+          StrPairItem *item = &g_array_index (items, StrPairItem, i);
+          table->slots[slots[i]].one = item->pair->one;
+          table->slots[slots[i]].two = item->pair->two;
+          table->slots[slots[i]].value = item->value;
+        }
+      table->displacements[bucket->index] = d;
+      return TRUE;
+    }
+
+  return FALSE;
+}
+
+static gboolean
+str_pair_table_build (StrPairTable *table, GHashTable *pairs)
+{
+  StrPairBucket *buckets;
+  StrPairBucket **order;
+  GHashTableIter iter;
+  gpointer key, value;
+  guint *slots;
+  guint i, free_slot = 0;
+  gboolean ret = TRUE;
+
+  buckets = g_new0 (StrPairBucket, table->size);
+  order = g_new (StrPairBucket *, table->size);
+  for (i = 0; i < table->size; i++)
+    {
+      buckets[i].index = i;
+      buckets[i].items = g_array_new (FALSE, FALSE, sizeof (StrPairItem));
+      order[i] = &buckets[i];
+    }
+
+  g_hash_table_iter_init (&iter, pairs);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      StrPairItem item;
+
+      item.pair = key;
+      item.key = str_pair_key (item.pair->one, item.pair->two);
+      item.value = value;
+      g_array_append_val (buckets[str_pair_mix (0, item.key) % table->size].items, item);
+    }
+
+  /* Place the largest buckets first, while there is most room */
+  qsort (order, table->size, sizeof (StrPairBucket *), compare_bucket_length);
+
+  slots = g_new (guint, table->size);
+  for (i = 0; i < table->size && ret; i++)
+    {
+      StrPairBucket *bucket = order[i];
+
+      if (bucket->items->len > 1)
+        ret = place_bucket (table, bucket, slots);
+      else if (bucket->items->len == 1)
+        {
+          StrPairItem *item = &g_array_index (bucket->items, StrPairItem, 0);
+
+          /* A lone item goes straight to a free slot */
+          while (table->slots[free_slot].two)
+            free_slot++;
+          table->slots[free_slot].one = item->pair->one;
+          table->slots[free_slot].two = item->pair->two;
+          table->slots[free_slot].value = item->value;
+          table->displacements[bucket->index] = -(gint) free_slot - 1;
+        }
+    }
+  g_free (slots);
+
+  for (i = 0; i < table->size; i++)
+    g_array_free (buckets[i].items, TRUE);
+  g_free (order);
+  g_free (buckets);
+  return ret;
+}
+
+/*
+ * Builds a perfect hash table of the StrPair keys and values of pairs.
+ * pairs must outlive the table, and must not change while it is in use.
+ */
+StrPairTable *
+str_pair_table_new (GHashTable *pairs)
+{
+  StrPairTable *table;
+
+  table = g_new0 (StrPairTable, 1);
+  table->size = g_hash_table_size (pairs);
+  if (table->size == 0)
+    return table;
+
+  table->displacements = g_new0 (gint, table->size);
+  table->slots = g_new0 (StrPairSlot, table->size);
+  if (!str_pair_table_build (table, pairs))
+    {
+      g_clear_pointer (&table->displacements, g_free);
+      g_clear_pointer (&table->slots, g_free);
+      table->fallback = pairs;
+    }
+
+  return table;
+}
+
+void
+str_pair_table_free (StrPairTable *table)
+{
+  g_free (table->displacements);
+  g_free (table->slots);
+  g_free (table);
+}
+
+gpointer
+str_pair_table_lookup (StrPairTable *table, const gchar *one, const gchar *two)
+{
+  StrPairSlot *slot;
+  guint32 key;
+  gint d;
+
+  if (table->fallback)
+    {
+      StrPair pair;
+
+      pair.one = one;
+      pair.two = two;
+      return g_hash_table_lookup (table->fallback, &pair);
+    }
+
+  if (table->size == 0)
+    return NULL;
+
+  key = str_pair_key (one, two);
+  d = table->displacements[str_pair_mix (0, key) % table->size];
+  slot = &table->slots[d < 0 ? (guint) (-d - 1) : str_pair_mix (d, key) % table->size];
+
+  if (slot->two && strcmp (slot->two, two) == 0 && strcmp (slot->one, one) == 0)
+    return slot->value;
+  return NULL;
+}
+
 /*END------------------------------------------------------------------------*/
@@ -38,4 +38,13 @@ guint str_pair_hash (gconstpointer key);
 gboolean str_pair_equal (gconstpointer a,
                          gconstpointer b);
 
+typedef struct _StrPairTable StrPairTable;
+
+StrPairTable *str_pair_table_new (GHashTable *pairs);
+void str_pair_table_free (StrPairTable *table);
+
+gpointer str_pair_table_lookup (StrPairTable *table,
+                                const gchar *one,
+                                const gchar *two);
+
 #endif /* _DROUTE_PAIRHASH_H */
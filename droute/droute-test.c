@@ -1,3 +1,4 @@
+#include <droute/droute-pairhash.h>
 #include <droute/droute.h>
 #include <glib.h>
 #include <stdio.h>
@@ -7,6 +8,8 @@
 #include "atspi/atspi.h"
 
 #define TEST_OBJECT_PATH "/test/object"
+#define TEST_MANY_PATH "/test/many"
+#define TEST_MANY_OBJECTS 3
 #define TEST_INTERFACE_ONE "test.interface.One"
 #define TEST_INTERFACE_TWO "test.interface.Two"
 
@@ -181,10 +184,31 @@ static DRouteMethod test_methods_two[] = {
   { NULL, NULL }
 };
 
+static dbus_bool_t
+impl_get_AString (DBusMessageIter *iter, void *user_data)
+{
+  AnObject *object = (AnObject *) user_data;
+
+  return droute_return_v_string (iter, object->astring);
+}
+
 static DRouteProperty test_properties[] = {
+  { impl_get_AString, NULL, "AString" },
   { NULL, NULL, NULL }
 };
 
+static AnObject many_objects[TEST_MANY_OBJECTS];
+
+static void *
+get_many_datum (const char *path, void *user_data)
+{
+  guint index;
+
+  if (sscanf (path, TEST_MANY_PATH "/%u", &index) != 1 || index >= TEST_MANY_OBJECTS)
+    return NULL;
+  return &many_objects[index];
+}
+
 static void
 set_reply (DBusPendingCall *pending, void *user_data)
 {
@@ -213,6 +237,15 @@ send_and_allow_reentry (DBusConnection *bus, DBusMessage *message, DBusError *er
   return reply;
 }
 
+static void
+count_interface_calls (const char *iface, guint64 calls, guint64 time_us, void *user_data)
+{
+  guint64 *n_calls = user_data;
+
+  if (!strcmp (iface, TEST_INTERFACE_ONE))
+    *n_calls += calls;
+}
+
 gboolean
 do_tests_func (gpointer data)
 {
@@ -259,10 +292,186 @@ do_tests_func (gpointer data)
 
   /* --------------------------------------------------------*/
 
+  {
+    const char *paths[] = { TEST_OBJECT_PATH, TEST_MANY_PATH "/0", "/test/missing",
+                            TEST_MANY_PATH "/2", TEST_MANY_PATH "/7" };
+    const char *expected[] = { STRING_ONE, "many0", "many2" };
+    const char **paths_ptr = paths;
+    const char *itf = TEST_INTERFACE_ONE;
+    DBusMessageIter iter, iter_objects, iter_object, iter_props, iter_prop, iter_variant;
+    gint n_objects = 0;
+
+    message = dbus_message_new_method_call (bus_name,
+                                            TEST_OBJECT_PATH,
+                                            DROUTE_INTERFACE_PROPERTIES,
+                                            "GetAllForObjects");
+    dbus_message_append_args (message, DBUS_TYPE_STRING, &itf,
+                              DBUS_TYPE_ARRAY, DBUS_TYPE_OBJECT_PATH, &paths_ptr, G_N_ELEMENTS (paths),
+                              DBUS_TYPE_INVALID);
+    reply = send_and_allow_reentry (bus, message, NULL);
+    dbus_message_unref (message);
+    if (!reply || strcmp (dbus_message_get_signature (reply), "a{oa{sv}}"))
+      {
+        g_print ("Failed: bad reply to GetAllForObjects\n");
+        exit (1);
+      }
+
+    dbus_message_iter_init (reply, &iter);
+    dbus_message_iter_recurse (&iter, &iter_objects);
+    while (dbus_message_iter_get_arg_type (&iter_objects) != DBUS_TYPE_INVALID)
+      {
+        const char *path, *name;
+
+        dbus_message_iter_recurse (&iter_objects, &iter_object);
+        dbus_message_iter_get_basic (&iter_object, &path);
+        dbus_message_iter_next (&iter_object);
+        dbus_message_iter_recurse (&iter_object, &iter_props);
+        dbus_message_iter_recurse (&iter_props, &iter_prop);
+        dbus_message_iter_get_basic (&iter_prop, &name);
+        dbus_message_iter_next (&iter_prop);
+        dbus_message_iter_recurse (&iter_prop, &iter_variant);
+        dbus_message_iter_get_basic (&iter_variant, &result_string);
+        if (n_objects >= G_N_ELEMENTS (expected) ||
+            g_strcmp0 (name, "AString") ||
+            g_strcmp0 (result_string, expected[n_objects]))
+          {
+            g_print ("Failed: GetAllForObjects returned %s for %s\n", result_string, path);
+            exit (1);
+          }
+        n_objects++;
+        dbus_message_iter_next (&iter_objects);
+      }
+    dbus_message_unref (reply);
+    if (n_objects != G_N_ELEMENTS (expected))
+      {
+        g_print ("Failed: GetAllForObjects returned %d objects; expected %d\n",
+                 n_objects, (gint) G_N_ELEMENTS (expected));
+        exit (1);
+      }
+  }
+
+  /* --------------------------------------------------------*/
+
+  {
+    DBusMessageIter iter, iter_array, iter_struct;
+    gboolean found = FALSE;
+
+    message = dbus_message_new_method_call (bus_name,
+                                            TEST_OBJECT_PATH,
+                                            DROUTE_INTERFACE_DEBUG,
+                                            "GetLatencyHistograms");
+    reply = send_and_allow_reentry (bus, message, NULL);
+    dbus_message_unref (message);
+    if (!reply || strcmp (dbus_message_get_signature (reply), "a(sstttat)"))
+      {
+        g_print ("Failed: bad reply to GetLatencyHistograms\n");
+        exit (1);
+      }
+
+    dbus_message_iter_init (reply, &iter);
+    dbus_message_iter_recurse (&iter, &iter_array);
+    while (dbus_message_iter_get_arg_type (&iter_array) != DBUS_TYPE_INVALID)
+      {
+        const char *iface, *member;
+        dbus_uint64_t calls;
+
+        dbus_message_iter_recurse (&iter_array, &iter_struct);
+        dbus_message_iter_get_basic (&iter_struct, &iface);
+        dbus_message_iter_next (&iter_struct);
+        dbus_message_iter_get_basic (&iter_struct, &member);
+        dbus_message_iter_next (&iter_struct);
+        dbus_message_iter_get_basic (&iter_struct, &calls);
+        if (!strcmp (iface, TEST_INTERFACE_ONE) && !strcmp (member, "getInterfaceOne"))
+          found = (calls == 1);
+        dbus_message_iter_next (&iter_array);
+      }
+    dbus_message_unref (reply);
+    if (!found)
+      {
+        g_print ("Failed: no latency histogram for getInterfaceOne\n");
+        exit (1);
+      }
+  }
+
+  /* --------------------------------------------------------*/
+
   g_main_loop_quit (main_loop);
   return FALSE;
 }
 
+static const gchar *pair_interfaces[] = { TEST_INTERFACE_ONE, TEST_INTERFACE_TWO, "test.interface.Three" };
+
+#define PAIR_MEMBERS 100
+
+static void
+check_pair_table (GHashTable *pairs)
+{
+  StrPairTable *table;
+  guint i, j;
+
+  table = str_pair_table_new (pairs);
+  for (i = 0; i < G_N_ELEMENTS (pair_interfaces); i++)
+    for (j = 0; j < PAIR_MEMBERS; j++)
+      {
+        gchar *member = g_strdup_printf ("method%u", j);
+        if (str_pair_table_lookup (table, pair_interfaces[i], member) != GUINT_TO_POINTER (i * PAIR_MEMBERS + j + 1))
+          {
+            g_print ("Failed: %s|%s not found in pair table\n", pair_interfaces[i], member);
+            exit (1);
+          }
+        g_free (member);
+      }
+  if (str_pair_table_lookup (table, TEST_INTERFACE_ONE, "method100") ||
+      str_pair_table_lookup (table, "test.interface.Four", "method0") ||
+      str_pair_table_lookup (table, "", ""))
+    {
+      g_print ("Failed: unknown pair found in pair table\n");
+      exit (1);
+    }
+  str_pair_table_free (table);
+}
+
+/*
+ * Checks that a perfect hash table finds every pair it was built from, and
+ * nothing else, both for pairs it can hash apart and for pairs it can't.
+ */
+static void
+test_pair_table (void)
+{
+  GHashTable *pairs;
+  GPtrArray *members;
+  StrPairTable *table;
+  guint i, j;
+
+  pairs = g_hash_table_new_full ((GHashFunc) str_pair_hash, str_pair_equal, g_free, NULL);
+  members = g_ptr_array_new_with_free_func (g_free);
+  for (i = 0; i < G_N_ELEMENTS (pair_interfaces); i++)
+    for (j = 0; j < PAIR_MEMBERS; j++)
+      {
+        gchar *member = g_strdup_printf ("method%u", j);
+        g_ptr_array_add (members, member);
+        g_hash_table_insert (pairs, str_pair_new (pair_interfaces[i], member),
+                             GUINT_TO_POINTER (i * PAIR_MEMBERS + j + 1));
+      }
+  check_pair_table (pairs);
+
+  /* Interfaces of the same length ending the same way can't be hashed
+   * apart, so they are looked up in the table the pairs came from. */
+  g_hash_table_insert (pairs, str_pair_new ("test.interface.Ine", "method0"),
+                       GUINT_TO_POINTER (G_MAXUINT));
+  check_pair_table (pairs);
+  table = str_pair_table_new (pairs);
+  if (str_pair_table_lookup (table, "test.interface.Ine", "method0") != GUINT_TO_POINTER (G_MAXUINT))
+    {
+      g_print ("Failed: test.interface.Ine|method0 not found in pair table\n");
+      exit (1);
+    }
+  str_pair_table_free (table);
+
+  g_hash_table_destroy (pairs);
+  g_ptr_array_unref (members);
+}
+
 int
 main (int argc, char **argv)
 {
@@ -270,6 +479,8 @@ main (int argc, char **argv)
   DRoutePath *path;
   AnObject *object;
   DBusError error;
+  guint64 n_calls;
+  gint i;
 
   /* Setup some server object */
 
@@ -277,12 +488,15 @@ main (int argc, char **argv)
   object->astring = g_strdup (STRING_ONE);
   object->anint = INT_ONE;
 
+  test_pair_table ();
+
   dbus_error_init (&error);
   main_loop = g_main_loop_new (NULL, FALSE);
   bus = dbus_bus_get (DBUS_BUS_SESSION, &error);
   atspi_dbus_connection_setup_with_g_main (bus, g_main_context_default ());
 
   cnx = droute_new ();
+  droute_context_set_latency_histograms (cnx, TRUE);
   path = droute_add_one (cnx, TEST_OBJECT_PATH, object);
 
   droute_path_add_interface (path,
@@ -299,10 +513,36 @@ main (int argc, char **argv)
 
   droute_path_register (path, bus);
 
+  for (i = 0; i < TEST_MANY_OBJECTS; i++)
+    many_objects[i].astring = g_strdup_printf ("many%d", i);
+
+  path = droute_add_many (cnx, TEST_MANY_PATH, NULL, NULL, NULL,
+                          get_many_datum, NULL);
+
+  droute_path_add_interface (path,
+                             TEST_INTERFACE_ONE,
+                             test_interface_One,
+                             test_methods_one,
+                             test_properties);
+
+  droute_path_register (path, bus);
+
   g_idle_add (do_tests_func, NULL);
   g_main_loop_run (main_loop);
 
+  /* null and getInterfaceOne */
+  n_calls = 0;
+  droute_context_foreach_interface_stats (cnx, count_interface_calls, &n_calls);
+  if (n_calls != 2)
+    {
+      g_print ("Failed: %" G_GUINT64_FORMAT " calls counted to %s; expected 2\n",
+               n_calls, TEST_INTERFACE_ONE);
+      success = FALSE;
+    }
+
   droute_free (cnx);
+  for (i = 0; i < TEST_MANY_OBJECTS; i++)
+    g_free (many_objects[i].astring);
   g_free (object->astring);
   g_free (object);
 
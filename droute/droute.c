@@ -43,6 +43,10 @@ struct _DRouteContext
   GPtrArray *registered_paths;
 
   gchar *introspect_string;
+  gboolean latency_histograms;
+
+  DRouteTraceFunction trace_func;
+  void *trace_data;
 };
 
 struct _DRoutePath
@@ -52,9 +56,12 @@ struct _DRoutePath
   gboolean prefix;
   GStringChunk *chunks;
   GPtrArray *interfaces;
+  GPtrArray *interface_stats;
   GPtrArray *introspection;
   GHashTable *methods;
   GHashTable *properties;
+  StrPairTable *method_table;
+  StrPairTable *property_table;
 
   DRouteIntrospectChildrenFunction introspect_children_cb;
   void *introspect_children_data;
@@ -65,12 +72,71 @@ struct _DRoutePath
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * The latency of calls to a member of an interface, recorded when latency
+ * histograms are enabled. Bucket i counts the calls that took less than
+ * 2^i microseconds but not less than 2^(i-1); the last bucket also counts
+ * all the slower ones.
+ */
+#define LATENCY_BUCKETS 24
+
+typedef struct Histogram
+{
+  const gchar *member;
+  guint64 calls;
+  guint64 time_us;
+  guint64 max_us;
+  guint64 buckets[LATENCY_BUCKETS];
+} Histogram;
+
+/* Calls made to an interface of a path, and the time spent serving them */
+typedef struct InterfaceStats
+{
+  const gchar *name;
+  guint64 calls;
+  guint64 time_us;
+  Histogram *get_all;
+} InterfaceStats;
+
+typedef struct MethodEntry
+{
+  DRouteFunction func;
+  const gchar *name;
+  InterfaceStats *stats;
+  Histogram *histogram;
+} MethodEntry;
+
 typedef struct PropertyPair
 {
   DRoutePropertyFunction get;
   DRoutePropertyFunction set;
+  InterfaceStats *stats;
+  Histogram *get_histogram;
+  Histogram *set_histogram;
 } PropertyPair;
 
+static void
+interface_stats_free (InterfaceStats *stats)
+{
+  g_free (stats->get_all);
+  g_free (stats);
+}
+
+static void
+method_entry_free (MethodEntry *entry)
+{
+  g_free (entry->histogram);
+  g_free (entry);
+}
+
+static void
+property_pair_free (PropertyPair *pair)
+{
+  g_free (pair->get_histogram);
+  g_free (pair->set_histogram);
+  g_free (pair);
+}
+
 /*---------------------------------------------------------------------------*/
 
 static DBusHandlerResult
@@ -99,17 +165,18 @@ path_new (DRouteContext *cnx,
   new_path->prefix = prefix;
   new_path->chunks = g_string_chunk_new (CHUNKS_DEFAULT);
   new_path->interfaces = g_ptr_array_new ();
+  new_path->interface_stats = g_ptr_array_new_with_free_func ((GDestroyNotify) interface_stats_free);
   new_path->introspection = g_ptr_array_new ();
 
   new_path->methods = g_hash_table_new_full ((GHashFunc) str_pair_hash,
                                              str_pair_equal,
                                              g_free,
-                                             NULL);
+                                             (GDestroyNotify) method_entry_free);
 
   new_path->properties = g_hash_table_new_full ((GHashFunc) str_pair_hash,
                                                 str_pair_equal,
                                                 g_free,
-                                                g_free);
+                                                (GDestroyNotify) property_pair_free);
 
   new_path->introspect_children_cb = introspect_children_cb;
   new_path->introspect_children_data = introspect_children_data;
@@ -126,12 +193,89 @@ path_free (DRoutePath *path, gpointer user_data)
   g_free (path->path);
   g_string_chunk_free (path->chunks);
   g_ptr_array_free (path->interfaces, TRUE);
+  g_ptr_array_free (path->interface_stats, TRUE);
   g_free (g_ptr_array_free (path->introspection, FALSE));
+  g_clear_pointer (&path->method_table, str_pair_table_free);
+  g_clear_pointer (&path->property_table, str_pair_table_free);
   g_hash_table_destroy (path->methods);
   g_hash_table_destroy (path->properties);
   g_free (path);
 }
 
+/*
+ * Methods and properties are dispatched through perfect hash tables, built
+ * on the first call after interfaces were added to the path.
+ */
+static MethodEntry *
+path_lookup_method (DRoutePath *path, const gchar *iface, const gchar *member)
+{
+  if (!path->method_table)
+    path->method_table = str_pair_table_new (path->methods);
+  return str_pair_table_lookup (path->method_table, iface, member);
+}
+
+static PropertyPair *
+path_lookup_property (DRoutePath *path, const gchar *iface, const gchar *name)
+{
+  if (!path->property_table)
+    path->property_table = str_pair_table_new (path->properties);
+  return str_pair_table_lookup (path->property_table, iface, name);
+}
+
+static InterfaceStats *
+path_lookup_interface_stats (DRoutePath *path, const gchar *iface)
+{
+  guint i;
+
+  for (i = 0; i < path->interfaces->len; i++)
+    {
+      if (!strcmp (g_ptr_array_index (path->interfaces, i), iface))
+        return g_ptr_array_index (path->interface_stats, i);
+    }
+  return NULL;
+}
+
+/*
+ * Counts a call to an interface that started at start_us and, if latency
+ * histograms are enabled, records its latency in the histogram of
+ * prefix + member, creating it on first use.
+ */
+static void
+record_call (DRoutePath *path,
+             InterfaceStats *stats,
+             Histogram **histogram,
+             const gchar *prefix,
+             const gchar *member,
+             gint64 start_us)
+{
+  guint64 elapsed_us = g_get_monotonic_time () - start_us;
+  Histogram *h;
+  guint bucket = 0;
+
+  stats->calls++;
+  stats->time_us += elapsed_us;
+
+  if (!path->cnx->latency_histograms)
+    return;
+
+  h = *histogram;
+  if (!h)
+    {
+      gchar *name = g_strconcat (prefix, member, NULL);
+
+      h = *histogram = g_new0 (Histogram, 1);
+      h->member = g_string_chunk_insert_const (path->chunks, name);
+      g_free (name);
+    }
+
+  while (bucket < LATENCY_BUCKETS - 1 && elapsed_us >> bucket)
+    bucket++;
+  h->calls++;
+  h->time_us += elapsed_us;
+  h->max_us = MAX (h->max_us, elapsed_us);
+  h->buckets[bucket]++;
+}
+
 static void *
 path_get_datum (DRoutePath *path, const gchar *pathstr)
 {
@@ -215,19 +359,32 @@ droute_path_add_interface (DRoutePath *path,
                            const DRouteProperty *properties)
 {
   gchar *itf;
+  InterfaceStats *stats;
 
   g_return_if_fail (name != NULL);
 
+  g_clear_pointer (&path->method_table, str_pair_table_free);
+  g_clear_pointer (&path->property_table, str_pair_table_free);
+
   itf = g_string_chunk_insert (path->chunks, name);
   g_ptr_array_add (path->interfaces, itf);
   g_ptr_array_add (path->introspection, (gpointer) introspect);
 
+  stats = g_new0 (InterfaceStats, 1);
+  stats->name = itf;
+  g_ptr_array_add (path->interface_stats, stats);
+
   for (; methods != NULL && methods->name != NULL; methods++)
     {
       gchar *meth;
+      MethodEntry *entry;
 
       meth = g_string_chunk_insert (path->chunks, methods->name);
-      g_hash_table_insert (path->methods, str_pair_new (itf, meth), methods->func);
+      entry = g_new0 (MethodEntry, 1);
+      entry->func = methods->func;
+      entry->name = meth;
+      entry->stats = stats;
+      g_hash_table_insert (path->methods, str_pair_new (itf, meth), entry);
     }
 
   for (; properties != NULL && properties->name != NULL; properties++)
@@ -236,9 +393,10 @@ droute_path_add_interface (DRoutePath *path,
       PropertyPair *pair;
 
       prop = g_string_chunk_insert (path->chunks, properties->name);
-      pair = g_new (PropertyPair, 1);
+      pair = g_new0 (PropertyPair, 1);
       pair->get = properties->get;
       pair->set = properties->set;
+      pair->stats = stats;
       g_hash_table_insert (path->properties, str_pair_new (itf, prop), pair);
     }
 }
@@ -248,19 +406,53 @@ droute_path_add_interface (DRoutePath *path,
 /* The data structures don't support an efficient implementation of GetAll
  * and I don't really care.
  */
+static void
+path_append_all_properties (DRoutePath *path,
+                            void *datum,
+                            const char *iface,
+                            DBusMessageIter *iter)
+{
+  DBusMessageIter iter_dict, iter_dict_entry;
+  GHashTableIter prop_iter;
+
+  StrPair *key;
+  PropertyPair *value;
+
+  if (!dbus_message_iter_open_container (iter, DBUS_TYPE_ARRAY, "{sv}", &iter_dict))
+    oom ();
+
+  g_hash_table_iter_init (&prop_iter, path->properties);
+  while (g_hash_table_iter_next (&prop_iter, (gpointer *) &key, (gpointer *) &value))
+    {
+      if (!g_strcmp0 (key->one, iface))
+        {
+          if (!value->get)
+            continue;
+          if (!dbus_message_iter_open_container (&iter_dict, DBUS_TYPE_DICT_ENTRY, NULL, &iter_dict_entry))
+            oom ();
+          dbus_message_iter_append_basic (&iter_dict_entry, DBUS_TYPE_STRING,
+                                          &key->two);
+          (value->get) (&iter_dict_entry, datum);
+          if (!dbus_message_iter_close_container (&iter_dict, &iter_dict_entry))
+            oom ();
+        }
+    }
+
+  if (!dbus_message_iter_close_container (iter, &iter_dict))
+    oom ();
+}
+
 static DBusMessage *
 impl_prop_GetAll (DBusMessage *message,
                   DRoutePath *path,
                   const char *pathstr)
 {
-  DBusMessageIter iter, iter_dict, iter_dict_entry;
+  DBusMessageIter iter;
   DBusMessage *reply;
   DBusError error;
-  GHashTableIter prop_iter;
-
-  StrPair *key;
-  PropertyPair *value;
   gchar *iface;
+  InterfaceStats *stats;
+  gint64 start_us = g_get_monotonic_time ();
 
   void *datum = path_get_datum (path, pathstr);
   if (!datum)
@@ -284,27 +476,107 @@ impl_prop_GetAll (DBusMessage *message,
     oom ();
 
   dbus_message_iter_init_append (reply, &iter);
-  if (!dbus_message_iter_open_container (&iter, DBUS_TYPE_ARRAY, "{sv}", &iter_dict))
-    oom ();
+  path_append_all_properties (path, datum, iface, &iter);
 
-  g_hash_table_iter_init (&prop_iter, path->properties);
-  while (g_hash_table_iter_next (&prop_iter, (gpointer *) &key, (gpointer *) &value))
+  stats = path_lookup_interface_stats (path, iface);
+  if (stats)
+    record_call (path, stats, &stats->get_all, "", "GetAll", start_us);
+  return reply;
+}
+
+/*
+ * Finds the path of a context that messages to pathstr are dispatched to:
+ * the path registered for exactly that object, or else the longest prefix
+ * path that it is below, as libdbus does.
+ */
+static DRoutePath *
+context_lookup_path (DRouteContext *cnx, const char *pathstr)
+{
+  DRoutePath *fallback = NULL;
+  gsize fallback_len = 0;
+  guint i;
+
+  for (i = 0; i < cnx->registered_paths->len; i++)
     {
-      if (!g_strcmp0 (key->one, iface))
+      DRoutePath *path = g_ptr_array_index (cnx->registered_paths, i);
+      gsize len = strlen (path->path);
+
+      if (strncmp (path->path, pathstr, len) != 0)
+        continue;
+      if (!path->prefix)
         {
-          if (!value->get)
-            continue;
-          if (!dbus_message_iter_open_container (&iter_dict, DBUS_TYPE_DICT_ENTRY, NULL, &iter_dict_entry))
-            oom ();
-          dbus_message_iter_append_basic (&iter_dict_entry, DBUS_TYPE_STRING,
-                                          &key->two);
-          (value->get) (&iter_dict_entry, datum);
-          if (!dbus_message_iter_close_container (&iter_dict, &iter_dict_entry))
-            oom ();
+          if (pathstr[len] == '\0')
+            return path;
+        }
+      else if ((pathstr[len] == '\0' || pathstr[len] == '/') && len >= fallback_len)
+        {
+          fallback = path;
+          fallback_len = len;
         }
     }
 
-  if (!dbus_message_iter_close_container (&iter, &iter_dict))
+  return fallback;
+}
+
+/*
+ * GetAll for a list of objects: takes an interface and an array of object
+ * paths and replies with the properties of that interface for each of the
+ * objects, keyed by path. Objects that do not exist or do not implement the
+ * interface are left out of the reply.
+ */
+static DBusMessage *
+impl_GetAllForObjects (DBusMessage *message,
+                       DRoutePath *path)
+{
+  DBusMessageIter iter, iter_paths, iter_objects, iter_object;
+  DBusMessage *reply;
+  const char *iface;
+
+  if (!dbus_message_has_signature (message, "sao"))
+    return droute_invalid_arguments_error (message);
+
+  dbus_message_iter_init (message, &iter);
+  dbus_message_iter_get_basic (&iter, &iface);
+  dbus_message_iter_next (&iter);
+  dbus_message_iter_recurse (&iter, &iter_paths);
+
+  reply = dbus_message_new_method_return (message);
+  if (!reply)
+    oom ();
+
+  dbus_message_iter_init_append (reply, &iter);
+  if (!dbus_message_iter_open_container (&iter, DBUS_TYPE_ARRAY, "{oa{sv}}", &iter_objects))
+    oom ();
+
+  while (dbus_message_iter_get_arg_type (&iter_paths) == DBUS_TYPE_OBJECT_PATH)
+    {
+      const char *pathstr;
+      DRoutePath *object_path;
+      void *datum = NULL;
+
+      dbus_message_iter_get_basic (&iter_paths, &pathstr);
+      dbus_message_iter_next (&iter_paths);
+
+      object_path = context_lookup_path (path->cnx, pathstr);
+      if (object_path)
+        datum = path_get_datum (object_path, pathstr);
+      if (!datum)
+        continue;
+      if (object_path->query_interface_cb &&
+          !object_path->query_interface_cb (datum, iface))
+        continue;
+
+      _DROUTE_DEBUG ("DRoute (handle GetAllForObjects): %s on %s\n", iface, pathstr);
+
+      if (!dbus_message_iter_open_container (&iter_objects, DBUS_TYPE_DICT_ENTRY, NULL, &iter_object))
+        oom ();
+      dbus_message_iter_append_basic (&iter_object, DBUS_TYPE_OBJECT_PATH, &pathstr);
+      path_append_all_properties (object_path, datum, iface, &iter_object);
+      if (!dbus_message_iter_close_container (&iter_objects, &iter_object))
+        oom ();
+    }
+
+  if (!dbus_message_iter_close_container (&iter, &iter_objects))
     oom ();
   return reply;
 }
@@ -320,6 +592,7 @@ impl_prop_GetSet (DBusMessage *message,
 
   StrPair pair;
   PropertyPair *prop_funcs = NULL;
+  gint64 start_us = g_get_monotonic_time ();
 
   void *datum;
 
@@ -340,7 +613,7 @@ impl_prop_GetSet (DBusMessage *message,
 
   _DROUTE_DEBUG ("DRoute (handle prop): %s|%s on %s\n", pair.one, pair.two, pathstr);
 
-  prop_funcs = (PropertyPair *) g_hash_table_lookup (path->properties, &pair);
+  prop_funcs = path_lookup_property (path, pair.one, pair.two);
   if (!prop_funcs)
     {
       DBusMessage *ret;
@@ -391,6 +664,10 @@ impl_prop_GetSet (DBusMessage *message,
       reply = dbus_message_new_error (message, DBUS_ERROR_FAILED, "Getter or setter unavailable");
     }
 
+  if (get)
+    record_call (path, prop_funcs->stats, &prop_funcs->get_histogram, "Get.", pair.two, start_us);
+  else
+    record_call (path, prop_funcs->stats, &prop_funcs->set_histogram, "Set.", pair.two, start_us);
   return reply;
 }
 
@@ -434,10 +711,10 @@ handle_properties (DBusConnection *bus,
   DBusMessage *reply = NULL;
   DBusHandlerResult result = DBUS_HANDLER_RESULT_HANDLED;
 
-  if (!g_strcmp0 (member, "GetAll"))
-    reply = impl_prop_GetAll (message, path, pathstr);
-  else if (!g_strcmp0 (member, "Get"))
+  if (!g_strcmp0 (member, "Get"))
     reply = impl_prop_GetSet (message, path, pathstr, TRUE);
+  else if (!g_strcmp0 (member, "GetAll"))
+    reply = impl_prop_GetAll (message, path, pathstr);
   else if (!g_strcmp0 (member, "Set"))
     reply = impl_prop_GetSet (message, path, pathstr, FALSE);
   else
@@ -452,6 +729,153 @@ handle_properties (DBusConnection *bus,
   return result;
 }
 
+static DBusHandlerResult
+handle_droute_properties (DBusConnection *bus,
+                          DBusMessage *message,
+                          DRoutePath *path,
+                          const gchar *iface,
+                          const gchar *member,
+                          const gchar *pathstr)
+{
+  DBusMessage *reply;
+
+  if (g_strcmp0 (member, "GetAllForObjects"))
+    return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+
+  reply = impl_GetAllForObjects (message, path);
+  dbus_connection_send (bus, reply, NULL);
+  dbus_message_unref (reply);
+  return DBUS_HANDLER_RESULT_HANDLED;
+}
+
+/*---------------------------------------------------------------------------*/
+
+static void
+add_histogram (GHashTable *totals, const gchar *iface, Histogram *histogram)
+{
+  StrPair pair;
+  Histogram *total;
+  guint i;
+
+  if (!histogram)
+    return;
+
+  pair.one = iface;
+  pair.two = histogram->member;
+  total = g_hash_table_lookup (totals, &pair);
+  if (!total)
+    {
+      total = g_new0 (Histogram, 1);
+      total->member = histogram->member;
+      g_hash_table_insert (totals, str_pair_new (iface, histogram->member), total);
+    }
+
+  total->calls += histogram->calls;
+  total->time_us += histogram->time_us;
+  total->max_us = MAX (total->max_us, histogram->max_us);
+  for (i = 0; i < LATENCY_BUCKETS; i++)
+    total->buckets[i] += histogram->buckets[i];
+}
+
+/* Sums the histograms of each interface member over all the paths */
+static DBusMessage *
+impl_GetLatencyHistograms (DBusMessage *message, DRoutePath *path)
+{
+  GHashTable *totals;
+  GHashTableIter iter_totals;
+  gpointer key, value;
+  DBusMessage *reply;
+  DBusMessageIter iter, iter_array, iter_struct, iter_buckets;
+  guint i, j;
+
+  totals = g_hash_table_new_full ((GHashFunc) str_pair_hash, str_pair_equal, g_free, g_free);
+  for (i = 0; i < path->cnx->registered_paths->len; i++)
+    {
+      DRoutePath *p = g_ptr_array_index (path->cnx->registered_paths, i);
+      GHashTableIter iter_path;
+
+      g_hash_table_iter_init (&iter_path, p->methods);
+      while (g_hash_table_iter_next (&iter_path, &key, &value))
+        add_histogram (totals, ((StrPair *) key)->one, ((MethodEntry *) value)->histogram);
+
+      g_hash_table_iter_init (&iter_path, p->properties);
+      while (g_hash_table_iter_next (&iter_path, &key, &value))
+        {
+          add_histogram (totals, ((StrPair *) key)->one, ((PropertyPair *) value)->get_histogram);
+          add_histogram (totals, ((StrPair *) key)->one, ((PropertyPair *) value)->set_histogram);
+        }
+
+      for (j = 0; j < p->interface_stats->len; j++)
+        {
+          InterfaceStats *stats = g_ptr_array_index (p->interface_stats, j);
+          add_histogram (totals, stats->name, stats->get_all);
+        }
+    }
+
+  reply = dbus_message_new_method_return (message);
+  if (!reply)
+    oom ();
+
+  dbus_message_iter_init_append (reply, &iter);
+  dbus_message_iter_open_container (&iter, DBUS_TYPE_ARRAY, "(sstttat)", &iter_array);
+  g_hash_table_iter_init (&iter_totals, totals);
+  while (g_hash_table_iter_next (&iter_totals, &key, &value))
+    {
+      StrPair *pair = key;
+      Histogram *total = value;
+      const guint64 *buckets = total->buckets;
+
+      dbus_message_iter_open_container (&iter_array, DBUS_TYPE_STRUCT, NULL, &iter_struct);
+      dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_STRING, &pair->one);
+      dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_STRING, &pair->two);
+      dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_UINT64, &total->calls);
+      dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_UINT64, &total->time_us);
+      dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_UINT64, &total->max_us);
+      dbus_message_iter_open_container (&iter_struct, DBUS_TYPE_ARRAY, "t", &iter_buckets);
+      dbus_message_iter_append_fixed_array (&iter_buckets, DBUS_TYPE_UINT64, &buckets, LATENCY_BUCKETS);
+      dbus_message_iter_close_container (&iter_struct, &iter_buckets);
+      dbus_message_iter_close_container (&iter_array, &iter_struct);
+    }
+  dbus_message_iter_close_container (&iter, &iter_array);
+
+  g_hash_table_unref (totals);
+  return reply;
+}
+
+static DBusMessage *
+impl_SetLatencyHistograms (DBusMessage *message, DRoutePath *path)
+{
+  dbus_bool_t enabled;
+
+  if (!dbus_message_get_args (message, NULL, DBUS_TYPE_BOOLEAN, &enabled, DBUS_TYPE_INVALID))
+    return droute_invalid_arguments_error (message);
+
+  droute_context_set_latency_histograms (path->cnx, enabled);
+  return dbus_message_new_method_return (message);
+}
+
+static DBusHandlerResult
+handle_droute_debug (DBusConnection *bus,
+                     DBusMessage *message,
+                     DRoutePath *path,
+                     const gchar *iface,
+                     const gchar *member,
+                     const gchar *pathstr)
+{
+  DBusMessage *reply;
+
+  if (!g_strcmp0 (member, "GetLatencyHistograms"))
+    reply = impl_GetLatencyHistograms (message, path);
+  else if (!g_strcmp0 (member, "SetLatencyHistograms"))
+    reply = impl_SetLatencyHistograms (message, path);
+  else
+    return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+
+  dbus_connection_send (bus, reply, NULL);
+  dbus_message_unref (reply);
+  return DBUS_HANDLER_RESULT_HANDLED;
+}
+
 /*---------------------------------------------------------------------------*/
 
 static const char *introspection_header =
@@ -537,25 +961,23 @@ handle_other (DBusConnection *bus,
 {
   gint result = DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
 
-  StrPair pair;
-  DRouteFunction func;
+  MethodEntry *entry;
   DBusMessage *reply = NULL;
+  gint64 start_us = g_get_monotonic_time ();
 
   void *datum;
 
-  pair.one = iface;
-  pair.two = member;
-
   _DROUTE_DEBUG ("DRoute (handle other): %s|%s on %s\n", member, iface, pathstr);
 
-  func = (DRouteFunction) g_hash_table_lookup (path->methods, &pair);
-  if (func != NULL)
+  entry = path_lookup_method (path, iface, member);
+  if (entry != NULL)
     {
       datum = path_get_datum (path, pathstr);
       if (!datum)
         reply = droute_object_does_not_exist_error (message);
       else
-        reply = (func) (bus, message, datum);
+        reply = (entry->func) (bus, message, datum);
+      record_call (path, entry->stats, &entry->histogram, "", entry->name, start_us);
 
       /* All D-Bus method calls must have a reply.
        * If one is not provided presume that the caller has already
@@ -584,6 +1006,7 @@ handle_message (DBusConnection *bus, DBusMessage *message, void *user_data)
   const gchar *member = dbus_message_get_member (message);
   const gint type = dbus_message_get_type (message);
   const gchar *pathstr = dbus_message_get_path (message);
+  gint64 start_us = path->cnx->trace_func ? g_get_monotonic_time () : 0;
 
   DBusHandlerResult result = DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
 
@@ -599,10 +1022,17 @@ handle_message (DBusConnection *bus, DBusMessage *message, void *user_data)
     result = handle_dbus (bus, message, iface, member, pathstr);
   else if (!strcmp (iface, "org.freedesktop.DBus.Properties"))
     result = handle_properties (bus, message, path, iface, member, pathstr);
+  else if (!strcmp (iface, DROUTE_INTERFACE_PROPERTIES))
+    result = handle_droute_properties (bus, message, path, iface, member, pathstr);
+  else if (!strcmp (iface, DROUTE_INTERFACE_DEBUG))
+    result = handle_droute_debug (bus, message, path, iface, member, pathstr);
   else if (!strcmp (iface, "org.freedesktop.DBus.Introspectable"))
     result = handle_introspection (bus, message, path, iface, member, pathstr);
   else
     result = handle_other (bus, message, path, iface, member, pathstr);
+
+  if (path->cnx->trace_func && result == DBUS_HANDLER_RESULT_HANDLED)
+    path->cnx->trace_func (bus, message, start_us, path->cnx->trace_data);
 #if 0
     if (result == DBUS_HANDLER_RESULT_NOT_YET_HANDLED)
         g_print ("DRoute | Unhandled message: %s|%s of type %d on %s\n", member, iface, type, pathstr);
@@ -688,6 +1118,49 @@ droute_invalid_arguments_error (DBusMessage *message)
   return reply;
 }
 
+void
+droute_context_set_latency_histograms (DRouteContext *cnx, gboolean enabled)
+{
+  cnx->latency_histograms = enabled;
+}
+
+/*
+ * Sets a function to be called after each method call handled on the paths
+ * of the context, with the connection it arrived on and the time it arrived.
+ */
+void
+droute_context_set_trace_func (DRouteContext *cnx,
+                               DRouteTraceFunction func,
+                               void *user_data)
+{
+  cnx->trace_func = func;
+  cnx->trace_data = user_data;
+}
+
+/*
+ * Calls func with the number of calls served by each interface of each path,
+ * including property reads and writes, and the time spent serving them.
+ */
+void
+droute_context_foreach_interface_stats (DRouteContext *cnx,
+                                        DRouteInterfaceStatsFunction func,
+                                        void *user_data)
+{
+  guint i, j;
+
+  for (i = 0; i < cnx->registered_paths->len; i++)
+    {
+      DRoutePath *path = g_ptr_array_index (cnx->registered_paths, i);
+
+      for (j = 0; j < path->interface_stats->len; j++)
+        {
+          InterfaceStats *stats = g_ptr_array_index (path->interface_stats, j);
+
+          func (stats->name, stats->calls, stats->time_us, user_data);
+        }
+    }
+}
+
 void
 droute_path_register (DRoutePath *path, DBusConnection *bus)
 {
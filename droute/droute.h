@@ -28,6 +28,31 @@
 
 #include <droute/droute-variant.h>
 
+/*
+ * Extension to org.freedesktop.DBus.Properties served on every path:
+ *
+ *   GetAllForObjects (s interface, ao paths) -> a{oa{sv}}
+ *
+ * returns the properties of an interface for many objects of the same
+ * context in one reply.
+ */
+#define DROUTE_INTERFACE_PROPERTIES "org.a11y.atspi.DRoute.Properties"
+
+/*
+ * Debugging interface served on every path:
+ *
+ *   SetLatencyHistograms (b enabled)
+ *   GetLatencyHistograms () -> a(sstttat)
+ *
+ * While enabled, the latency of every method call, property read ("Get."
+ * followed by the property name), property write ("Set." ...) and GetAll
+ * is recorded per interface member. GetLatencyHistograms returns, for each
+ * member called, its interface and name, the number of calls, their total
+ * and longest time in microseconds, and the number of calls that took less
+ * than 1, 2, 4, ... 2^22 microseconds, then longer.
+ */
+#define DROUTE_INTERFACE_DEBUG "org.a11y.atspi.DRoute.Debug"
+
 typedef DBusMessage *(*DRouteFunction) (DBusConnection *, DBusMessage *, void *);
 typedef dbus_bool_t (*DRoutePropertyFunction) (DBusMessageIter *, void *);
 typedef gchar *(*DRouteIntrospectChildrenFunction) (const char *, void *);
@@ -35,6 +60,11 @@ typedef gchar *(*DRouteIntrospectChildrenFunction) (const char *, void *);
 typedef void *(*DRouteGetDatumFunction) (const char *, void *);
 typedef gboolean (*DRouteQueryInterfaceFunction) (void *, const char *);
 
+/* Called with an interface name, its number of calls and the time spent in them */
+typedef void (*DRouteInterfaceStatsFunction) (const char *, guint64, guint64, void *);
+
+typedef void (*DRouteTraceFunction) (DBusConnection *, DBusMessage *, gint64, void *);
+
 typedef struct _DRouteMethod DRouteMethod;
 struct _DRouteMethod
 {
@@ -94,6 +124,19 @@ droute_invalid_arguments_error (DBusMessage *message);
 DBusMessage *
 droute_out_of_memory_error (DBusMessage *message);
 
+void
+droute_context_set_latency_histograms (DRouteContext *cnx, gboolean enabled);
+
+void
+droute_context_set_trace_func (DRouteContext *cnx,
+                               DRouteTraceFunction func,
+                               void *user_data);
+
+void
+droute_context_foreach_interface_stats (DRouteContext *cnx,
+                                        DRouteInterfaceStatsFunction func,
+                                        void *user_data);
+
 void
 droute_path_register (DRoutePath *path, DBusConnection *bus);
 
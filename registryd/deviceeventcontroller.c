@@ -38,6 +38,7 @@
 
 #include <dbus/dbus.h>
 
+#include "atspi/atspi-trace.h"
 #include "de-types.h"
 #include "keymasks.h"
 #include "marshal-dbus.h"
@@ -1665,6 +1666,7 @@ handle_message (DBusMessage *message, SpiDEController *controller)
   const gchar *member = dbus_message_get_member (message);
   DBusHandlerResult result = DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
   DBusMessage *reply = NULL;
+  gint64 start_us = g_get_monotonic_time ();
 
   if (!strcmp (iface, SPI_DBUS_INTERFACE_DEC))
     {
@@ -1705,6 +1707,7 @@ handle_message (DBusMessage *message, SpiDEController *controller)
 
       dbus_connection_send (controller->bus, reply, NULL);
       dbus_message_unref (reply);
+      _atspi_trace_handled (controller->bus, message, start_us);
     }
 }
 
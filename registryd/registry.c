@@ -26,6 +26,7 @@
 #include <ctype.h>
 #include <string.h>
 
+#include "atspi/atspi-trace.h"
 #include "introspection.h"
 #include "paths.h"
 #include "registry.h"
@@ -82,6 +83,7 @@ spi_registry_finalize (GObject *object)
   SpiRegistry *registry = SPI_REGISTRY (object);
 
   g_clear_pointer (&registry->bus_unique_name, g_free);
+  g_clear_pointer (&registry->window_map, spi_window_map_free);
 
   G_OBJECT_CLASS (spi_registry_parent_class)->finalize (object);
 }
@@ -208,6 +210,9 @@ add_application (SpiRegistry *registry, SpiReference *app_root)
   g_ptr_array_add (registry->apps, app_root);
   index = registry->apps->len - 1;
 
+  spi_window_map_add_application (registry->window_map, app_root->name,
+                                  app_root->path);
+
   emit_children_changed (registry->bus, "add", index, app_root);
 }
 
@@ -239,6 +244,7 @@ remove_application (SpiRegistry *registry, guint index)
   SpiReference *ref = g_ptr_array_index (registry->apps, index);
 
   spi_remove_device_listeners (registry->dec, ref->name);
+  spi_window_map_remove_application (registry->window_map, ref->name);
   emit_children_changed (registry->bus, "remove", index, ref);
   g_ptr_array_remove_index (registry->apps, index);
 }
@@ -396,6 +402,11 @@ signal_filter (DBusConnection *bus, DBusMessage *message, void *user_data)
   if (!g_strcmp0 (iface, DBUS_INTERFACE_DBUS) &&
       !g_strcmp0 (member, "NameOwnerChanged"))
     handle_disconnection (reg, message);
+  else if (!g_strcmp0 (iface, SPI_DBUS_INTERFACE_EVENT_WINDOW))
+    {
+      spi_window_map_handle_event (reg->window_map, message);
+      res = DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+    }
   else
     res = DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
 
@@ -506,19 +517,26 @@ impl_Contains (DBusMessage *message, SpiRegistry *registry)
   return reply;
 }
 
+/*
+ * Returns the topmost toplevel window at the point, which is looked up in
+ * the window map. The desktop covers the whole screen, so all coordinate
+ * types are taken as screen coordinates. Returns NULL when the reply is
+ * sent later, once the window has confirmed that it contains the point.
+ */
 static DBusMessage *
 impl_GetAccessibleAtPoint (DBusMessage *message, SpiRegistry *registry)
 {
-  DBusMessage *reply = NULL;
-  DBusMessageIter iter;
-  SpiReference *null_ref = spi_reference_null (registry->bus_unique_name);
+  dbus_int32_t x, y;
+  dbus_uint32_t coord_type;
 
-  reply = dbus_message_new_method_return (message);
-  dbus_message_iter_init_append (reply, &iter);
-  append_reference (&iter, null_ref);
-  spi_reference_free (null_ref);
+  if (!dbus_message_get_args (message, NULL, DBUS_TYPE_INT32, &x,
+                              DBUS_TYPE_INT32, &y, DBUS_TYPE_UINT32,
+                              &coord_type, DBUS_TYPE_INVALID))
+    return dbus_message_new_error (message, DBUS_ERROR_INVALID_ARGS,
+                                   "Invalid arguments");
 
-  return reply;
+  spi_window_map_reply_accessible_at_point (registry->window_map, message, x, y);
+  return NULL;
 }
 
 static DBusMessage *
@@ -1114,6 +1132,7 @@ handle_method_root (DBusConnection *bus, DBusMessage *message, void *user_data)
 {
   SpiRegistry *registry = SPI_REGISTRY (user_data);
   DBusHandlerResult result = DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+  gint64 start_us = g_get_monotonic_time ();
 
   const gchar *iface = dbus_message_get_interface (message);
   const gchar *member = dbus_message_get_member (message);
@@ -1230,7 +1249,11 @@ handle_method_root (DBusConnection *bus, DBusMessage *message, void *user_data)
       if (!strcmp (member, "Contains"))
         reply = impl_Contains (message, registry);
       else if (!strcmp (member, "GetAccessibleAtPoint"))
-        reply = impl_GetAccessibleAtPoint (message, registry);
+        {
+          reply = impl_GetAccessibleAtPoint (message, registry);
+          if (!reply)
+            return DBUS_HANDLER_RESULT_HANDLED;
+        }
       else if (!strcmp (member, "GetExtents"))
         reply = impl_GetExtents (message, registry);
       else if (!strcmp (member, "GetPosition"))
@@ -1278,6 +1301,7 @@ handle_method_root (DBusConnection *bus, DBusMessage *message, void *user_data)
 
       dbus_connection_send (bus, reply, NULL);
       dbus_message_unref (reply);
+      _atspi_trace_handled (bus, message, start_us);
     }
 #if 0
   else
@@ -1294,6 +1318,7 @@ handle_method_cache (DBusConnection *bus, DBusMessage *message, void *user_data)
 {
   SpiRegistry *registry = SPI_REGISTRY (user_data);
   DBusHandlerResult result = DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+  gint64 start_us = g_get_monotonic_time ();
 
   const gchar *iface = dbus_message_get_interface (message);
   const gchar *member = dbus_message_get_member (message);
@@ -1325,6 +1350,7 @@ handle_method_cache (DBusConnection *bus, DBusMessage *message, void *user_data)
 
       dbus_connection_send (bus, reply, NULL);
       dbus_message_unref (reply);
+      _atspi_trace_handled (bus, message, start_us);
     }
   return result;
 }
@@ -1334,6 +1360,7 @@ handle_method_registry (DBusConnection *bus, DBusMessage *message, void *user_da
 {
   SpiRegistry *registry = SPI_REGISTRY (user_data);
   DBusHandlerResult result = DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+  gint64 start_us = g_get_monotonic_time ();
 
   const gchar *iface = dbus_message_get_interface (message);
   const gchar *member = dbus_message_get_member (message);
@@ -1378,6 +1405,7 @@ handle_method_registry (DBusConnection *bus, DBusMessage *message, void *user_da
 
       dbus_connection_send (bus, reply, NULL);
       dbus_message_unref (reply);
+      _atspi_trace_handled (bus, message, start_us);
     }
 #if 0
   else
@@ -1412,6 +1440,45 @@ static DBusObjectPathVTable cache_vtable = {
 static gchar *app_sig_match_name_owner =
     "type='signal', interface='org.freedesktop.DBus', member='NameOwnerChanged'";
 
+/*
+ * The window events that the window map uses. Others, such as deactivate,
+ * would not change it, and listening to all of them would make every
+ * application send them even when no AT asks for them.
+ */
+static const gchar *window_map_events[] = {
+  "Create", "Destroy", "Activate", "Minimize", "Maximize", "Restore", NULL
+};
+
+/*
+ * Listens to window events, to keep the window map up to date. The
+ * registry is listed as a listener like any other, so that applications
+ * send them.
+ */
+static void
+listen_to_window_events (SpiRegistry *registry)
+{
+  gint i;
+
+  for (i = 0; window_map_events[i]; i++)
+    {
+      EventData *evdata;
+      gchar *name, *match;
+
+      name = g_strconcat ("Window:", window_map_events[i], NULL);
+      evdata = g_new0 (EventData, 1);
+      evdata->listener_bus_name = g_strdup (registry->bus_unique_name);
+      evdata->data = g_strsplit (name, ":", 3);
+      registry->events = g_list_append (registry->events, evdata);
+      g_free (name);
+
+      match = g_strdup_printf ("type='signal', interface='%s', member='%s'",
+                               SPI_DBUS_INTERFACE_EVENT_WINDOW,
+                               window_map_events[i]);
+      dbus_bus_add_match (registry->bus, match, NULL);
+      g_free (match);
+    }
+}
+
 SpiRegistry *
 spi_registry_new (DBusConnection *bus, SpiDEController *dec)
 {
@@ -1434,9 +1501,11 @@ spi_registry_new (DBusConnection *bus, SpiDEController *dec)
 
   dbus_connection_register_object_path (bus, SPI_DBUS_PATH_REGISTRY, &registry_vtable, registry);
 
-  emit_Available (bus);
-
   registry->events = NULL;
+  registry->window_map = spi_window_map_new (bus, bus_unique_name);
+  listen_to_window_events (registry);
+
+  emit_Available (bus);
 
   return registry;
 }
@@ -33,6 +33,7 @@ typedef struct _SpiRegistry SpiRegistry;
 typedef struct _SpiRegistryClass SpiRegistryClass;
 
 #include "deviceeventcontroller.h"
+#include "window-map.h"
 
 G_BEGIN_DECLS
 
@@ -52,6 +53,8 @@ struct _SpiRegistry
   DBusConnection *bus;
   char *bus_unique_name;
   GList *events;
+
+  SpiWindowMap *window_map;
 };
 
 struct _SpiRegistryClass
@@ -0,0 +1,556 @@
+/*
+ * AT-SPI - Assistive Technology Service Provider Interface
+ * (Gnome Accessibility Project; http://developer.gnome.org/projects/gap)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <config.h>
+#include <string.h>
+
+#include "paths.h"
+#include "window-map.h"
+
+/*
+ * The window map lets the registry answer GetAccessibleAtPoint on the
+ * desktop without asking every application in turn.
+ *
+ * It keeps the toplevel windows of all applications, topmost first, with
+ * their last known screen extents. Windows are found by listing the
+ * children of applications as they register, and by window events, which
+ * also keep the stacking order: a window that is created or activated
+ * goes to the top.
+ *
+ * The extents are refreshed on window events, but windows can move without
+ * any, so the map only tells which windows to ask: a hit test asks the
+ * topmost candidate for its extents, and only answers with it if it does
+ * contain the point, moving on to the next candidate otherwise.
+ */
+
+/* How long to wait for an application to give the extents of a window */
+#define EXTENTS_TIMEOUT 500
+
+typedef struct _SpiWindow
+{
+  gchar *bus_name;
+  gchar *path;
+  gboolean have_extents;
+  gint x, y, width, height;
+  gboolean minimized;
+} SpiWindow;
+
+struct _SpiWindowMap
+{
+  DBusConnection *bus;
+  gchar *bus_unique_name;
+  GQueue windows; /* Topmost first */
+};
+
+typedef struct _HitTest
+{
+  SpiWindowMap *map;
+  DBusMessage *message;
+  gint x, y;
+  GPtrArray *candidates; /* Copies of the windows to try, topmost first */
+  guint next;
+} HitTest;
+
+/*---------------------------------------------------------------------------*/
+
+static SpiWindow *
+window_new (const char *bus_name, const char *path)
+{
+  SpiWindow *window = g_new0 (SpiWindow, 1);
+
+  window->bus_name = g_strdup (bus_name);
+  window->path = g_strdup (path);
+  return window;
+}
+
+static void
+window_free (SpiWindow *window)
+{
+  g_free (window->bus_name);
+  g_free (window->path);
+  g_free (window);
+}
+
+static SpiWindow *
+window_copy (const SpiWindow *window)
+{
+  SpiWindow *copy = window_new (window->bus_name, window->path);
+
+  copy->have_extents = window->have_extents;
+  copy->x = window->x;
+  copy->y = window->y;
+  copy->width = window->width;
+  copy->height = window->height;
+  copy->minimized = window->minimized;
+  return copy;
+}
+
+static gboolean
+window_contains (const SpiWindow *window, gint x, gint y)
+{
+  return (x >= window->x && x < window->x + window->width &&
+          y >= window->y && y < window->y + window->height);
+}
+
+static GList *
+find_window (SpiWindowMap *map, const char *bus_name, const char *path)
+{
+  GList *l;
+
+  for (l = map->windows.head; l; l = l->next)
+    {
+      SpiWindow *window = l->data;
+
+      if (!strcmp (window->path, path) && !strcmp (window->bus_name, bus_name))
+        return l;
+    }
+  return NULL;
+}
+
+static gboolean
+read_extents (DBusMessage *reply, gint *x, gint *y, gint *width, gint *height)
+{
+  DBusMessageIter iter, iter_struct;
+  dbus_int32_t d_int;
+
+  if (dbus_message_get_type (reply) != DBUS_MESSAGE_TYPE_METHOD_RETURN ||
+      strcmp (dbus_message_get_signature (reply), "(iiii)") != 0)
+    return FALSE;
+
+  dbus_message_iter_init (reply, &iter);
+  dbus_message_iter_recurse (&iter, &iter_struct);
+  dbus_message_iter_get_basic (&iter_struct, &d_int);
+  *x = d_int;
+  dbus_message_iter_next (&iter_struct);
+  dbus_message_iter_get_basic (&iter_struct, &d_int);
+  *y = d_int;
+  dbus_message_iter_next (&iter_struct);
+  dbus_message_iter_get_basic (&iter_struct, &d_int);
+  *width = d_int;
+  dbus_message_iter_next (&iter_struct);
+  dbus_message_iter_get_basic (&iter_struct, &d_int);
+  *height = d_int;
+  return TRUE;
+}
+
+/*
+ * Stores the extents from a GetExtents reply in the window, if it is still
+ * in the map. Returns FALSE if the reply is an error.
+ */
+static gboolean
+update_extents (SpiWindowMap *map, const SpiWindow *key, DBusMessage *reply,
+                gint *x, gint *y, gint *width, gint *height)
+{
+  GList *l;
+
+  if (!reply || !read_extents (reply, x, y, width, height))
+    return FALSE;
+
+  l = find_window (map, key->bus_name, key->path);
+  if (l)
+    {
+      SpiWindow *window = l->data;
+
+      window->have_extents = TRUE;
+      window->x = *x;
+      window->y = *y;
+      window->width = *width;
+      window->height = *height;
+    }
+  return TRUE;
+}
+
+static gboolean
+call_get_extents (SpiWindowMap *map, const SpiWindow *window,
+                  DBusPendingCallNotifyFunction notify,
+                  void *user_data, DBusFreeFunction free_user_data)
+{
+  DBusMessage *message;
+  DBusPendingCall *pending = NULL;
+  dbus_uint32_t coord_type = 0; /* Screen */
+
+  message = dbus_message_new_method_call (window->bus_name, window->path,
+                                          SPI_DBUS_INTERFACE_COMPONENT,
+                                          "GetExtents");
+  if (!message)
+    return FALSE;
+  dbus_message_append_args (message, DBUS_TYPE_UINT32, &coord_type,
+                            DBUS_TYPE_INVALID);
+  if (!dbus_connection_send_with_reply (map->bus, message, &pending,
+                                        EXTENTS_TIMEOUT) ||
+      !pending)
+    {
+      dbus_message_unref (message);
+      return FALSE;
+    }
+  dbus_message_unref (message);
+  dbus_pending_call_set_notify (pending, notify, user_data, free_user_data);
+  dbus_pending_call_unref (pending);
+  return TRUE;
+}
+
+typedef struct _ExtentsRequest
+{
+  SpiWindowMap *map;
+  SpiWindow *window;
+} ExtentsRequest;
+
+static void
+extents_request_free (void *data)
+{
+  ExtentsRequest *request = data;
+
+  window_free (request->window);
+  g_free (request);
+}
+
+static void
+refresh_extents_reply (DBusPendingCall *pending, void *user_data)
+{
+  ExtentsRequest *request = user_data;
+  DBusMessage *reply = dbus_pending_call_steal_reply (pending);
+  gint x, y, width, height;
+
+  update_extents (request->map, request->window, reply, &x, &y, &width, &height);
+  if (reply)
+    dbus_message_unref (reply);
+}
+
+static void
+refresh_extents (SpiWindowMap *map, SpiWindow *window)
+{
+  ExtentsRequest *request = g_new0 (ExtentsRequest, 1);
+
+  request->map = map;
+  request->window = window_copy (window);
+  if (!call_get_extents (map, window, refresh_extents_reply, request,
+                         extents_request_free))
+    extents_request_free (request);
+}
+
+/* Adds a window at the top, or moves it there if it is already known */
+static SpiWindow *
+raise_window (SpiWindowMap *map, const char *bus_name, const char *path)
+{
+  GList *l = find_window (map, bus_name, path);
+  SpiWindow *window;
+
+  if (l)
+    {
+      window = l->data;
+      g_queue_unlink (&map->windows, l);
+      g_queue_push_head_link (&map->windows, l);
+    }
+  else
+    {
+      window = window_new (bus_name, path);
+      g_queue_push_head (&map->windows, window);
+    }
+  return window;
+}
+
+/*---------------------------------------------------------------------------*/
+
+SpiWindowMap *
+spi_window_map_new (DBusConnection *bus, const char *bus_unique_name)
+{
+  SpiWindowMap *map = g_new0 (SpiWindowMap, 1);
+
+  map->bus = bus;
+  map->bus_unique_name = g_strdup (bus_unique_name);
+  g_queue_init (&map->windows);
+  return map;
+}
+
+void
+spi_window_map_free (SpiWindowMap *map)
+{
+  g_queue_clear_full (&map->windows, (GDestroyNotify) window_free);
+  g_free (map->bus_unique_name);
+  g_free (map);
+}
+
+typedef struct _ChildrenRequest
+{
+  SpiWindowMap *map;
+  gchar *bus_name;
+} ChildrenRequest;
+
+static void
+children_request_free (void *data)
+{
+  ChildrenRequest *request = data;
+
+  g_free (request->bus_name);
+  g_free (request);
+}
+
+static void
+get_children_reply (DBusPendingCall *pending, void *user_data)
+{
+  ChildrenRequest *request = user_data;
+  SpiWindowMap *map = request->map;
+  DBusMessage *reply = dbus_pending_call_steal_reply (pending);
+  DBusMessageIter iter, iter_array, iter_struct;
+
+  if (!reply)
+    return;
+  if (dbus_message_get_type (reply) != DBUS_MESSAGE_TYPE_METHOD_RETURN ||
+      strcmp (dbus_message_get_signature (reply), "a(so)") != 0)
+    {
+      dbus_message_unref (reply);
+      return;
+    }
+
+  dbus_message_iter_init (reply, &iter);
+  dbus_message_iter_recurse (&iter, &iter_array);
+  while (dbus_message_iter_get_arg_type (&iter_array) != DBUS_TYPE_INVALID)
+    {
+      const char *path;
+      SpiWindow *window;
+
+      dbus_message_iter_recurse (&iter_array, &iter_struct);
+      dbus_message_iter_next (&iter_struct);
+      dbus_message_iter_get_basic (&iter_struct, &path);
+
+      /* Windows that existed before we knew about them go below the others */
+      if (strcmp (path, SPI_DBUS_PATH_NULL) != 0 &&
+          !find_window (map, request->bus_name, path))
+        {
+          window = window_new (request->bus_name, path);
+          g_queue_push_tail (&map->windows, window);
+          refresh_extents (map, window);
+        }
+      dbus_message_iter_next (&iter_array);
+    }
+
+  dbus_message_unref (reply);
+}
+
+/* Adds the existing windows of a newly registered application */
+void
+spi_window_map_add_application (SpiWindowMap *map, const char *bus_name, const char *path)
+{
+  DBusMessage *message;
+  DBusPendingCall *pending = NULL;
+  ChildrenRequest *request;
+
+  message = dbus_message_new_method_call (bus_name, path,
+                                          SPI_DBUS_INTERFACE_ACCESSIBLE,
+                                          "GetChildren");
+  if (!message)
+    return;
+  if (!dbus_connection_send_with_reply (map->bus, message, &pending, -1) ||
+      !pending)
+    {
+      dbus_message_unref (message);
+      return;
+    }
+  dbus_message_unref (message);
+
+  request = g_new0 (ChildrenRequest, 1);
+  request->map = map;
+  request->bus_name = g_strdup (bus_name);
+  dbus_pending_call_set_notify (pending, get_children_reply, request,
+                                children_request_free);
+  dbus_pending_call_unref (pending);
+}
+
+void
+spi_window_map_remove_application (SpiWindowMap *map, const char *bus_name)
+{
+  GList *l, *next;
+
+  for (l = map->windows.head; l; l = next)
+    {
+      SpiWindow *window = l->data;
+
+      next = l->next;
+      if (!strcmp (window->bus_name, bus_name))
+        {
+          window_free (window);
+          g_queue_delete_link (&map->windows, l);
+        }
+    }
+}
+
+/* Updates the map from an org.a11y.atspi.Event.Window signal */
+void
+spi_window_map_handle_event (SpiWindowMap *map, DBusMessage *signal)
+{
+  const char *member = dbus_message_get_member (signal);
+  const char *bus_name = dbus_message_get_sender (signal);
+  const char *path = dbus_message_get_path (signal);
+  SpiWindow *window;
+  GList *l;
+
+  if (!member || !bus_name || !path)
+    return;
+
+  if (!strcmp (member, "Destroy"))
+    {
+      l = find_window (map, bus_name, path);
+      if (l)
+        {
+          window_free (l->data);
+          g_queue_delete_link (&map->windows, l);
+        }
+      return;
+    }
+
+  if (!strcmp (member, "Create") || !strcmp (member, "Activate"))
+    window = raise_window (map, bus_name, path);
+  else
+    {
+      l = find_window (map, bus_name, path);
+      if (!l)
+        return;
+      window = l->data;
+    }
+
+  if (!strcmp (member, "Minimize"))
+    {
+      window->minimized = TRUE;
+      return;
+    }
+  if (!strcmp (member, "Create") || !strcmp (member, "Activate") ||
+      !strcmp (member, "Restore") || !strcmp (member, "Maximize"))
+    window->minimized = FALSE;
+
+  refresh_extents (map, window);
+}
+
+/*---------------------------------------------------------------------------*/
+
+static void
+append_reference (DBusMessageIter *iter, const char *name, const char *path)
+{
+  DBusMessageIter iter_struct;
+
+  dbus_message_iter_open_container (iter, DBUS_TYPE_STRUCT, NULL,
+                                    &iter_struct);
+  dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_STRING, &name);
+  dbus_message_iter_append_basic (&iter_struct, DBUS_TYPE_OBJECT_PATH, &path);
+  dbus_message_iter_close_container (iter, &iter_struct);
+}
+
+static void
+hit_test_reply (HitTest *test, const SpiWindow *window)
+{
+  DBusMessage *reply;
+  DBusMessageIter iter;
+
+  reply = dbus_message_new_method_return (test->message);
+  if (!reply)
+    return;
+  dbus_message_iter_init_append (reply, &iter);
+  if (window)
+    append_reference (&iter, window->bus_name, window->path);
+  else
+    append_reference (&iter, test->map->bus_unique_name, SPI_DBUS_PATH_NULL);
+  dbus_connection_send (test->map->bus, reply, NULL);
+  dbus_message_unref (reply);
+}
+
+static void
+hit_test_free (HitTest *test)
+{
+  dbus_message_unref (test->message);
+  g_ptr_array_free (test->candidates, TRUE);
+  g_free (test);
+}
+
+static void hit_test_next (HitTest *test);
+
+static void
+hit_test_extents_reply (DBusPendingCall *pending, void *user_data)
+{
+  HitTest *test = user_data;
+  DBusMessage *reply = dbus_pending_call_steal_reply (pending);
+  SpiWindow *candidate = g_ptr_array_index (test->candidates, test->next);
+  gint x, y, width, height;
+
+  if (update_extents (test->map, candidate, reply, &x, &y, &width, &height) &&
+      x <= test->x && test->x < x + width && y <= test->y && test->y < y + height)
+    {
+      hit_test_reply (test, candidate);
+      hit_test_free (test);
+    }
+  else
+    {
+      test->next++;
+      hit_test_next (test);
+    }
+
+  if (reply)
+    dbus_message_unref (reply);
+}
+
+/* Asks the next candidate whether it contains the point */
+static void
+hit_test_next (HitTest *test)
+{
+  while (test->next < test->candidates->len)
+    {
+      SpiWindow *candidate = g_ptr_array_index (test->candidates, test->next);
+
+      if (call_get_extents (test->map, candidate, hit_test_extents_reply, test,
+                            NULL))
+        return;
+      test->next++;
+    }
+
+  hit_test_reply (test, NULL);
+  hit_test_free (test);
+}
+
+/*
+ * Replies to a GetAccessibleAtPoint call on the desktop with the topmost
+ * window containing the point, in screen coordinates. The reply is sent
+ * once the candidate window has confirmed its extents.
+ */
+void
+spi_window_map_reply_accessible_at_point (SpiWindowMap *map, DBusMessage *message, gint x, gint y)
+{
+  HitTest *test;
+  GList *l;
+
+  test = g_new0 (HitTest, 1);
+  test->map = map;
+  test->message = dbus_message_ref (message);
+  test->x = x;
+  test->y = y;
+  test->candidates = g_ptr_array_new_with_free_func ((GDestroyNotify) window_free);
+
+  /* Windows whose extents are not known yet might contain the point too */
+  for (l = map->windows.head; l; l = l->next)
+    {
+      SpiWindow *window = l->data;
+
+      if (window->minimized)
+        continue;
+      if (!window->have_extents || window_contains (window, x, y))
+        g_ptr_array_add (test->candidates, window_copy (window));
+    }
+
+  hit_test_next (test);
+}
+
+/*END------------------------------------------------------------------------*/
@@ -0,0 +1,46 @@
+/*
+ * AT-SPI - Assistive Technology Service Provider Interface
+ * (Gnome Accessibility Project; http://developer.gnome.org/projects/gap)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef SPI_WINDOW_MAP_H_
+#define SPI_WINDOW_MAP_H_
+
+#include <glib.h>
+
+#include <dbus/dbus.h>
+
+G_BEGIN_DECLS
+
+typedef struct _SpiWindowMap SpiWindowMap;
+
+SpiWindowMap *spi_window_map_new (DBusConnection *bus, const char *bus_unique_name);
+
+void spi_window_map_free (SpiWindowMap *map);
+
+void spi_window_map_add_application (SpiWindowMap *map, const char *bus_name, const char *path);
+
+void spi_window_map_remove_application (SpiWindowMap *map, const char *bus_name);
+
+void spi_window_map_handle_event (SpiWindowMap *map, DBusMessage *signal);
+
+void spi_window_map_reply_accessible_at_point (SpiWindowMap *map, DBusMessage *message, gint x, gint y);
+
+G_END_DECLS
+
+#endif /* SPI_WINDOW_MAP_H_ */
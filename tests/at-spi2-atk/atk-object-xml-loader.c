@@ -52,7 +52,9 @@
 #define IMAGE_NODE ((const xmlChar *) "image")
 #define TABLE_NODE ((const xmlChar *) "table")
 #define TABLE_CELL_NODE ((const xmlChar *) "table_cell")
+#define TABLE_GRID_NODE ((const xmlChar *) "table_grid")
 #define TEXT_NODE ((const xmlChar *) "text_node")
+#define TEXT_EDIT_NODE ((const xmlChar *) "text_edit_node")
 #define VALUE_NODE ((const xmlChar *) "value_node")
 #define SELECT_NODE ((const xmlChar *) "select_node")
 
@@ -89,6 +91,8 @@
 #define TEXT_BOLD_ATTR ((const xmlChar *) "bold_text")
 #define TEXT_UNDERLINE_ATTR ((const xmlChar *) "underline_text")
 #define TEXT_DUMMY_ATTR ((const xmlChar *) "dummy_text")
+#define TEXT_REPEAT_ATTR ((const xmlChar *) "repeat")
+#define TEXT_RUN_LENGTH_ATTR ((const xmlChar *) "run_length")
 #define START_ATTR ((const xmlChar *) "start")
 #define END_ATTR ((const xmlChar *) "end")
 #define LINK_ATTR ((const xmlChar *) "link")
@@ -96,6 +100,10 @@
 #define CELL_Y_ATTR ((const xmlChar *) "cell_y")
 #define ROW_SPAN_ATTR ((const xmlChar *) "row_span")
 #define COLUMN_SPAN_ATTR ((const xmlChar *) "column_span")
+#define ROWS_ATTR ((const xmlChar *) "rows")
+#define COLUMNS_ATTR ((const xmlChar *) "columns")
+#define SELECTED_STEP_ATTR ((const xmlChar *) "selected_step")
+#define KEEP_CELLS_ATTR ((const xmlChar *) "keep_cells")
 #define SELECT_ATTR ((const xmlChar *) "selected")
 #define PAGE_ATTR ((const xmlChar *) "page_no")
 #define PAGE_NUM_ATTR ((const xmlChar *) "page_number")
@@ -349,6 +357,8 @@ create_atk_object_from_element (xmlNode *element)
           if (!xmlStrcmp (child_node2->name, TEXT_NODE))
             {
               xmlChar *text = xmlGetProp (child_node2, TEXT_TEXT_ATTR);
+              int repeat = atoi_get_prop (child_node2, TEXT_REPEAT_ATTR);
+              GString *full_text = g_string_new ((const gchar *) text);
               AtkAttributeSet *attrSet = NULL;
               AtkAttribute *a1 = get_atk_attribute (child_node2, TEXT_BOLD_ATTR);
               AtkAttribute *a2 = get_atk_attribute (child_node2, TEXT_UNDERLINE_ATTR);
@@ -356,13 +366,25 @@ create_atk_object_from_element (xmlNode *element)
               attrSet = g_slist_append (NULL, a1);
               attrSet = g_slist_append (attrSet, a2);
               attrSet = g_slist_append (attrSet, a3);
+              /* Large documents are built by repeating a short text */
+              for (; text && repeat > 1; repeat--)
+                g_string_append (full_text, (const gchar *) text);
               my_atk_set_text (ATK_TEXT (child_obj),
-                               (const gchar *) text,
+                               full_text->str,
                                atoi_get_prop (child_node2, COMP_X_ATTR),
                                atoi_get_prop (child_node2, COMP_Y_ATTR),
                                atoi_get_prop (child_node2, COMP_WIDTH_ATTR),
                                atoi_get_prop (child_node2, COMP_HEIGHT_ATTR),
                                attrSet);
+              my_atk_text_set_run_length (ATK_TEXT (child_obj),
+                                          atoi_get_prop (child_node2, TEXT_RUN_LENGTH_ATTR));
+              g_string_free (full_text, TRUE);
+              xmlFree (text);
+            }
+          if (!xmlStrcmp (child_node2->name, TEXT_EDIT_NODE))
+            {
+              xmlChar *text = xmlGetProp (child_node2, TEXT_TEXT_ATTR);
+              my_atk_set_editable_text (ATK_EDITABLE_TEXT (child_obj), (const gchar *) text);
               xmlFree (text);
             }
           if (!xmlStrcmp (child_node2->name, TABLE_CELL_NODE))
@@ -373,6 +395,16 @@ create_atk_object_from_element (xmlNode *element)
                                      atoi_get_prop (child_node2, ROW_SPAN_ATTR),
                                      atoi_get_prop (child_node2, COLUMN_SPAN_ATTR));
             }
+          if (!xmlStrcmp (child_node2->name, TABLE_GRID_NODE))
+            {
+              my_atk_table_set_grid (ATK_TABLE (child_obj),
+                                     atoi_get_prop (child_node2, ROWS_ATTR),
+                                     atoi_get_prop (child_node2, COLUMNS_ATTR),
+                                     atoi_get_prop (child_node2, ROW_SPAN_ATTR),
+                                     atoi_get_prop (child_node2, SELECTED_STEP_ATTR));
+              if (atoi_get_prop (child_node2, KEEP_CELLS_ATTR))
+                my_atk_table_grid_keep_cells (ATK_TABLE (child_obj));
+            }
           if (!xmlStrcmp (child_node2->name, VALUE_NODE))
             {
               my_atk_set_value (ATK_VALUE (child_obj),
@@ -0,0 +1,320 @@
+/*
+ * AT-SPI - Assistive Technology Service Provider Interface
+ * (Gnome Accessibility Project; https://wiki.gnome.org/Accessibility)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Benchmarks the Table and TableCell interfaces on virtualized tables of
+ * 1k, 10k, 100k and 1M cells, with cells spanning several rows in the first
+ * column, row and column headers and a selection.
+ *
+ * After each table, the growth of the test application's resident memory
+ * during a long scroll through it is reported, which is mostly the bridge's
+ * object register and leases.
+ */
+
+#include "atk_bench_util.h"
+
+#define DATA_FILE TESTS_DATA_DIR "/bench-table.xml"
+
+/* The size of the viewport used to scroll through tables */
+#define VIEW_ROWS 20
+#define VIEW_COLUMNS 10
+
+/* The number of cells read one by one or as a region for a row */
+#define ROW_COLUMNS 25
+
+typedef struct
+{
+  AtspiTable *table;
+  gint n_rows;
+  gint n_columns;
+  const gchar *size;
+} TableBench;
+
+/* Spreads calls over the whole table, the same way on every run */
+static void
+bench_position (TableBench *bench, gint i, gint *row, gint *column)
+{
+  gint64 index = ((gint64) i * 7919) % ((gint64) bench->n_rows * bench->n_columns);
+
+  *row = index / bench->n_columns;
+  *column = index % bench->n_columns;
+}
+
+static void
+bench_get_accessible_at (gpointer data, gint i, gsize *bytes)
+{
+  TableBench *bench = data;
+  AtspiAccessible *cell;
+  gint row, column;
+
+  bench_position (bench, i, &row, &column);
+  cell = atspi_table_get_accessible_at (bench->table, row, column, NULL);
+  g_assert_nonnull (cell);
+  g_object_unref (cell);
+}
+
+static void
+bench_get_cell_name (gpointer data, gint i, gsize *bytes)
+{
+  TableBench *bench = data;
+  AtspiAccessible *cell;
+  gint row, column;
+  gchar *name;
+
+  bench_position (bench, i, &row, &column);
+  cell = atspi_table_get_accessible_at (bench->table, row, column, NULL);
+  g_assert_nonnull (cell);
+  name = atspi_accessible_get_name (cell, NULL);
+  g_assert_nonnull (name);
+  *bytes += strlen (name);
+  g_free (name);
+  g_object_unref (cell);
+}
+
+static void
+bench_read_row_per_cell (gpointer data, gint i, gsize *bytes)
+{
+  TableBench *bench = data;
+  gint row = i % bench->n_rows;
+  gint column;
+
+  for (column = 0; column < MIN (bench->n_columns, ROW_COLUMNS); column++)
+    {
+      AtspiAccessible *cell;
+      gchar *name;
+
+      cell = atspi_table_get_accessible_at (bench->table, row, column, NULL);
+      g_assert_nonnull (cell);
+      name = atspi_accessible_get_name (cell, NULL);
+      *bytes += strlen (name);
+      g_free (name);
+      g_object_unref (cell);
+    }
+}
+
+static void
+bench_read_row_region (gpointer data, gint i, gsize *bytes)
+{
+  TableBench *bench = data;
+  GArray *cells;
+  guint j;
+
+  cells = atspi_table_get_region (bench->table, i % bench->n_rows, 0, 1,
+                                  MIN (bench->n_columns, ROW_COLUMNS),
+                                  ATSPI_CACHE_NAME, NULL, NULL, NULL);
+  g_assert_nonnull (cells);
+  for (j = 0; j < cells->len; j++)
+    {
+      AtspiTableRegionCell *cell = &g_array_index (cells, AtspiTableRegionCell, j);
+      gchar *name = atspi_accessible_get_name (cell->cell, NULL);
+      *bytes += strlen (name);
+      g_free (name);
+    }
+  g_array_free (cells, TRUE);
+}
+
+static void
+bench_get_headers (gpointer data, gint i, gsize *bytes)
+{
+  TableBench *bench = data;
+  AtspiAccessible *header;
+  gint row, column;
+
+  bench_position (bench, i, &row, &column);
+  header = atspi_table_get_row_header (bench->table, row, NULL);
+  g_assert_nonnull (header);
+  g_object_unref (header);
+  header = atspi_table_get_column_header (bench->table, column, NULL);
+  g_assert_nonnull (header);
+  g_object_unref (header);
+}
+
+static void
+bench_get_header_cells (gpointer data, gint i, gsize *bytes)
+{
+  TableBench *bench = data;
+  AtspiAccessible *cell;
+  AtspiTableCell *table_cell;
+  GPtrArray *headers;
+  gint row, column;
+
+  bench_position (bench, i, &row, &column);
+  cell = atspi_table_get_accessible_at (bench->table, row, column, NULL);
+  g_assert_nonnull (cell);
+  table_cell = atspi_accessible_get_table_cell (cell);
+  g_assert_nonnull (table_cell);
+  headers = atspi_table_cell_get_column_header_cells (table_cell, NULL);
+  g_assert_nonnull (headers);
+  g_ptr_array_unref (headers);
+  headers = atspi_table_cell_get_row_header_cells (table_cell, NULL);
+  g_assert_nonnull (headers);
+  g_ptr_array_unref (headers);
+  g_object_unref (table_cell);
+  g_object_unref (cell);
+}
+
+static void
+bench_get_selected_rows (gpointer data, gint i, gsize *bytes)
+{
+  TableBench *bench = data;
+  GArray *rows;
+
+  rows = atspi_table_get_selected_rows (bench->table, NULL);
+  g_assert_nonnull (rows);
+  *bytes += rows->len * sizeof (gint);
+  g_array_free (rows, TRUE);
+}
+
+static void
+bench_is_selected (gpointer data, gint i, gsize *bytes)
+{
+  TableBench *bench = data;
+  gint row, column;
+
+  bench_position (bench, i, &row, &column);
+  atspi_table_is_selected (bench->table, row, column, NULL);
+}
+
+/*
+ * Scrolls down by one row, reading the names of all the cells in view. The
+ * view wraps around at the bottom of the table.
+ */
+static void
+bench_scroll (gpointer data, gint i, gsize *bytes)
+{
+  TableBench *bench = data;
+  GArray *cells;
+  guint j;
+
+  cells = atspi_table_get_region (bench->table,
+                                  i % MAX (bench->n_rows - VIEW_ROWS, 1), 0,
+                                  VIEW_ROWS, VIEW_COLUMNS,
+                                  ATSPI_CACHE_NAME, NULL, NULL, NULL);
+  g_assert_nonnull (cells);
+  for (j = 0; j < cells->len; j++)
+    {
+      AtspiTableRegionCell *cell = &g_array_index (cells, AtspiTableRegionCell, j);
+      gchar *name = atspi_accessible_get_name (cell->cell, NULL);
+      *bytes += strlen (name);
+      g_free (name);
+    }
+  g_array_free (cells, TRUE);
+}
+
+/* Runs a benchmark, labelled with the size of the table */
+static void
+table_bench_run (TableBench *bench, const gchar *what, gint iterations, BenchFunc func)
+{
+  gchar *label = g_strdup_printf ("%s (%s)", what, bench->size);
+
+  bench_run (label, iterations, func, bench);
+  g_free (label);
+}
+
+/* Returns the resident memory of process pid in bytes, or 0 if unknown */
+static gsize
+get_resident_memory (pid_t pid)
+{
+  gchar *path = g_strdup_printf ("/proc/%d/statm", (int) pid);
+  gchar *contents = NULL;
+  gsize resident = 0;
+  gulong size, pages;
+
+  if (g_file_get_contents (path, &contents, NULL, NULL) &&
+      sscanf (contents, "%lu %lu", &size, &pages) == 2)
+    resident = (gsize) pages * sysconf (_SC_PAGESIZE);
+
+  g_free (contents);
+  g_free (path);
+  return resident;
+}
+
+static void
+bench_table (TestAppFixture *fixture, AtspiAccessible *accessible)
+{
+  TableBench bench;
+  gchar *name;
+  gsize resident_before, resident_after;
+  gint n, n_scroll;
+
+  bench.table = atspi_accessible_get_table_iface (accessible);
+  g_assert_nonnull (bench.table);
+  bench.n_rows = atspi_table_get_n_rows (bench.table, NULL);
+  bench.n_columns = atspi_table_get_n_columns (bench.table, NULL);
+  g_assert_cmpint (bench.n_rows, >, 0);
+  g_assert_cmpint (bench.n_columns, >, 0);
+
+  name = atspi_accessible_get_name (accessible, NULL);
+  g_assert_true (g_str_has_prefix (name, "table "));
+  bench.size = name + strlen ("table ");
+  g_print ("\n%s: %d rows, %d columns\n", name, bench.n_rows, bench.n_columns);
+
+  n = bench_iterations (20, 5000);
+  table_bench_run (&bench, "get_accessible_at", n, bench_get_accessible_at);
+  table_bench_run (&bench, "get_accessible_at + get_name", n, bench_get_cell_name);
+  table_bench_run (&bench, "row read (per cell)", bench_iterations (2, 200), bench_read_row_per_cell);
+  table_bench_run (&bench, "row read (region)", bench_iterations (2, 200), bench_read_row_region);
+  table_bench_run (&bench, "get_row/column_header", n, bench_get_headers);
+  table_bench_run (&bench, "get_row/column_header_cells", n, bench_get_header_cells);
+  table_bench_run (&bench, "get_selected_rows", bench_iterations (5, 500), bench_get_selected_rows);
+  table_bench_run (&bench, "is_selected", n, bench_is_selected);
+
+  n_scroll = bench_iterations (20, 2 * bench.n_rows);
+  resident_before = get_resident_memory (fixture->child_pid);
+  table_bench_run (&bench, "scroll by one row", n_scroll, bench_scroll);
+  resident_after = get_resident_memory (fixture->child_pid);
+  if (resident_before && resident_after)
+    g_print ("%-36s %+8ld KB after %d rows\n", "application memory growth",
+             ((glong) resident_after - (glong) resident_before) / 1024, n_scroll);
+
+  g_free (name);
+  g_object_unref (bench.table);
+}
+
+static void
+atk_bench_table (TestAppFixture *fixture, gconstpointer user_data)
+{
+  gint i, n_tables;
+
+  g_assert_nonnull (fixture->root_obj);
+  n_tables = atspi_accessible_get_child_count (fixture->root_obj, NULL);
+  g_assert_cmpint (n_tables, >, 0);
+
+  for (i = 0; i < n_tables; i++)
+    {
+      AtspiAccessible *child = atspi_accessible_get_child_at_index (fixture->root_obj, i, NULL);
+      g_assert_nonnull (child);
+      bench_table (fixture, child);
+      g_object_unref (child);
+    }
+}
+
+static void
+add_benchmarks (void)
+{
+  g_test_add ("/table/atk_bench_table",
+              TestAppFixture, DATA_FILE, fixture_setup, atk_bench_table, fixture_teardown);
+}
+
+int
+main (int argc, char **argv)
+{
+  return bench_main (argc, argv, add_benchmarks);
+}
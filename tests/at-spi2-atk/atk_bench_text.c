@@ -0,0 +1,190 @@
+/*
+ * AT-SPI - Assistive Technology Service Provider Interface
+ * (Gnome Accessibility Project; https://wiki.gnome.org/Accessibility)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Benchmarks the Text interface on a synthetic document of about a
+ * megabyte, with an attribute run every 16 characters.
+ */
+
+#include "atk_bench_util.h"
+
+#define DATA_FILE TESTS_DATA_DIR "/bench-text.xml"
+
+typedef struct
+{
+  AtspiText *text;
+  gint n_chars;
+  AtspiTextGranularity granularity;
+} TextBench;
+
+/* Spreads calls over the whole document, the same way on every run */
+static gint
+bench_offset (TextBench *bench, gint i)
+{
+  return (gint) (((gint64) i * 7919) % bench->n_chars);
+}
+
+static void
+bench_get_text_window (gpointer data, gint i, gsize *bytes)
+{
+  TextBench *bench = data;
+  gint offset = bench_offset (bench, i);
+  gchar *str;
+
+  str = atspi_text_get_text (bench->text, offset,
+                             MIN (offset + 80, bench->n_chars), NULL);
+  g_assert_nonnull (str);
+  *bytes += strlen (str);
+  g_free (str);
+}
+
+static void
+bench_get_text_all (gpointer data, gint i, gsize *bytes)
+{
+  TextBench *bench = data;
+  gchar *str;
+
+  str = atspi_text_get_text (bench->text, 0, -1, NULL);
+  g_assert_nonnull (str);
+  *bytes += strlen (str);
+  g_free (str);
+}
+
+static void
+bench_get_string_at_offset (gpointer data, gint i, gsize *bytes)
+{
+  TextBench *bench = data;
+  AtspiTextRange *range;
+
+  range = atspi_text_get_string_at_offset (bench->text, bench_offset (bench, i),
+                                           bench->granularity, NULL);
+  g_assert_nonnull (range);
+  if (range->content)
+    *bytes += strlen (range->content);
+  g_free (range->content);
+  g_free (range);
+}
+
+static void
+bench_get_attribute_run (gpointer data, gint i, gsize *bytes)
+{
+  TextBench *bench = data;
+  GHashTable *attributes;
+  gint start, end;
+
+  attributes = atspi_text_get_attribute_run (bench->text, bench_offset (bench, i),
+                                             FALSE, &start, &end, NULL);
+  g_assert_nonnull (attributes);
+  g_assert_cmpint (start, <, end);
+  g_hash_table_unref (attributes);
+}
+
+static void
+bench_get_character_extents (gpointer data, gint i, gsize *bytes)
+{
+  TextBench *bench = data;
+  AtspiRect *rect;
+
+  rect = atspi_text_get_character_extents (bench->text, bench_offset (bench, i),
+                                           ATSPI_COORD_TYPE_SCREEN, NULL);
+  g_assert_nonnull (rect);
+  g_free (rect);
+}
+
+static void
+bench_get_bounded_ranges (gpointer data, gint i, gsize *bytes)
+{
+  TextBench *bench = data;
+  GArray *ranges;
+  guint j;
+
+  ranges = atspi_text_get_bounded_ranges (bench->text, 0, 0, 640, 480,
+                                          ATSPI_COORD_TYPE_SCREEN,
+                                          ATSPI_TEXT_CLIP_NONE,
+                                          ATSPI_TEXT_CLIP_NONE, NULL);
+  g_assert_nonnull (ranges);
+  for (j = 0; j < ranges->len; j++)
+    {
+      AtspiTextRange *range = &g_array_index (ranges, AtspiTextRange, j);
+      if (range->content)
+        *bytes += strlen (range->content);
+      g_free (range->content);
+    }
+  g_array_free (ranges, TRUE);
+}
+
+static void
+atk_bench_text (TestAppFixture *fixture, gconstpointer user_data)
+{
+  static const struct
+  {
+    const gchar *name;
+    AtspiTextGranularity granularity;
+  } granularities[] = {
+    { "get_string_at_offset (char)", ATSPI_TEXT_GRANULARITY_CHAR },
+    { "get_string_at_offset (word)", ATSPI_TEXT_GRANULARITY_WORD },
+    { "get_string_at_offset (sentence)", ATSPI_TEXT_GRANULARITY_SENTENCE },
+    { "get_string_at_offset (line)", ATSPI_TEXT_GRANULARITY_LINE },
+    /* The dummy text has no paragraph granularity; it would measure an
+     * empty reply. */
+  };
+  AtspiAccessible *child;
+  TextBench bench;
+  guint i;
+  gint n;
+
+  g_assert_nonnull (fixture->root_obj);
+  child = atspi_accessible_get_child_at_index (fixture->root_obj, 0, NULL);
+  g_assert_nonnull (child);
+  bench.text = atspi_accessible_get_text_iface (child);
+  g_assert_nonnull (bench.text);
+  bench.n_chars = atspi_text_get_character_count (bench.text, NULL);
+  g_assert_cmpint (bench.n_chars, >=, 1024 * 1024);
+  g_print ("\ndocument: %d characters\n", bench.n_chars);
+
+  n = bench_iterations (20, 5000);
+  bench_run ("get_text (80 characters)", n, bench_get_text_window, &bench);
+  bench_run ("get_text (whole document)", bench_iterations (2, 50),
+             bench_get_text_all, &bench);
+  for (i = 0; i < G_N_ELEMENTS (granularities); i++)
+    {
+      bench.granularity = granularities[i].granularity;
+      bench_run (granularities[i].name, n, bench_get_string_at_offset, &bench);
+    }
+  bench_run ("get_attribute_run", n, bench_get_attribute_run, &bench);
+  bench_run ("get_character_extents", n, bench_get_character_extents, &bench);
+  bench_run ("get_bounded_ranges", n, bench_get_bounded_ranges, &bench);
+
+  g_object_unref (bench.text);
+  g_object_unref (child);
+}
+
+static void
+add_benchmarks (void)
+{
+  g_test_add ("/text/atk_bench_text",
+              TestAppFixture, DATA_FILE, fixture_setup, atk_bench_text, fixture_teardown);
+}
+
+int
+main (int argc, char **argv)
+{
+  return bench_main (argc, argv, add_benchmarks);
+}
@@ -0,0 +1,94 @@
+/*
+ * AT-SPI - Assistive Technology Service Provider Interface
+ * (Gnome Accessibility Project; https://wiki.gnome.org/Accessibility)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Helpers for benchmarks that measure calls made through the real bridge,
+ * against a test application started with the usual test fixtures.
+ *
+ * Benchmarks are GTest cases. They run a handful of iterations by default,
+ * so that they double as smoke tests, and many more when the binary is run
+ * in performance mode ("-m perf"), which is what "meson test --benchmark"
+ * does.
+ */
+
+#include "atk_bench_util.h"
+
+gint
+bench_iterations (gint quick_iterations, gint perf_iterations)
+{
+  return (g_test_perf () ? perf_iterations : quick_iterations);
+}
+
+/*
+ * Calls func iterations times and reports the mean latency per call, the
+ * number of calls per second and, if func reports the bytes it fetched, the
+ * throughput.
+ */
+void
+bench_run (const gchar *name, gint iterations, BenchFunc func, gpointer data)
+{
+  gsize bytes = 0;
+  gdouble elapsed;
+  gint i;
+
+  g_test_timer_start ();
+  for (i = 0; i < iterations; i++)
+    func (data, i, &bytes);
+  elapsed = g_test_timer_elapsed ();
+
+  if (elapsed <= 0)
+    elapsed = 1e-9;
+
+  if (bytes)
+    g_print ("%-36s %8d calls %10.1f us/call %10.0f calls/s %8.1f MB/s\n",
+             name, iterations, elapsed * 1e6 / iterations,
+             iterations / elapsed, bytes / elapsed / (1024 * 1024));
+  else
+    g_print ("%-36s %8d calls %10.1f us/call %10.0f calls/s\n",
+             name, iterations, elapsed * 1e6 / iterations,
+             iterations / elapsed);
+  g_test_minimized_result (elapsed * 1e6 / iterations, "%s: %.1f us/call",
+                           name, elapsed * 1e6 / iterations);
+}
+
+int
+bench_main (int argc, char **argv, void (*add_benchmarks) (void))
+{
+  int init_result;
+
+  g_test_init (&argc, &argv, NULL);
+
+  setlocale (LC_ALL, "");
+  init_result = atspi_init ();
+  if (init_result != 0)
+    {
+      g_error ("Could not initialize atspi, code %d", init_result);
+    }
+
+  fixture_listener_init ();
+
+  add_benchmarks ();
+
+  int result = g_test_run ();
+
+  atspi_exit ();
+
+  return result;
+}
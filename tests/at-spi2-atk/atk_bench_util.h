@@ -0,0 +1,38 @@
+/*
+ * AT-SPI - Assistive Technology Service Provider Interface
+ * (Gnome Accessibility Project; https://wiki.gnome.org/Accessibility)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _ATK_BENCH_UTIL_H
+#define _ATK_BENCH_UTIL_H
+
+#include "atk_test_util.h"
+
+/*
+ * A benchmarked operation. It is called with the index of the call, and
+ * may add the number of bytes it transferred to *bytes.
+ */
+typedef void (*BenchFunc) (gpointer data, gint i, gsize *bytes);
+
+gint bench_iterations (gint quick_iterations, gint perf_iterations);
+
+void bench_run (const gchar *name, gint iterations, BenchFunc func, gpointer data);
+
+int bench_main (int argc, char **argv, void (*add_benchmarks) (void));
+
+#endif /* _ATK_BENCH_UTIL_H */
@@ -24,6 +24,7 @@
 #include "atk_test_util.h"
 
 #define DATA_FILE TESTS_DATA_DIR "/test-component.xml"
+#define GRID_DATA_FILE TESTS_DATA_DIR "/test-component-grid.xml"
 
 static void
 atk_test_component_sample (TestAppFixture *fixture, gconstpointer user_data)
@@ -88,6 +89,41 @@ atk_test_component_get_extents (TestAppFixture *fixture, gconstpointer user_data
   g_object_unref (child);
 }
 
+static void
+atk_test_component_get_extents_batch (TestAppFixture *fixture, gconstpointer user_data)
+{
+  AtspiAccessible *obj = fixture->root_obj;
+  GPtrArray *children = g_ptr_array_new_with_free_func (g_object_unref);
+  int i;
+
+  for (i = 0; i < 3; i++)
+    g_ptr_array_add (children, atspi_accessible_get_child_at_index (obj, i, NULL));
+
+  GArray *extents = atspi_component_get_extents_batch (children, ATSPI_COORD_TYPE_SCREEN, NULL);
+  g_assert_nonnull (extents);
+  g_assert_cmpint (extents->len, ==, 3);
+
+  for (i = 0; i < 2; i++)
+    {
+      AtspiComponent *iface = atspi_accessible_get_component_iface (g_ptr_array_index (children, i));
+      AtspiRect *r = atspi_component_get_extents (iface, ATSPI_COORD_TYPE_SCREEN, NULL);
+      AtspiRect *batch = &g_array_index (extents, AtspiRect, i);
+      g_assert_cmpint (batch->x, ==, r->x);
+      g_assert_cmpint (batch->y, ==, r->y);
+      g_assert_cmpint (batch->width, ==, r->width);
+      g_assert_cmpint (batch->height, ==, r->height);
+      g_free (r);
+      g_object_unref (iface);
+    }
+
+  /* The last child is not a component */
+  g_assert_cmpint (g_array_index (extents, AtspiRect, 2).x, ==, -1);
+  g_assert_cmpint (g_array_index (extents, AtspiRect, 2).width, ==, -1);
+
+  g_array_free (extents, TRUE);
+  g_ptr_array_free (children, TRUE);
+}
+
 static void
 atk_test_component_get_layer (TestAppFixture *fixture, gconstpointer user_data)
 {
@@ -172,6 +208,253 @@ atk_test_component_set_extents (TestAppFixture *fixture, gconstpointer user_data
   g_object_unref (child);
 }
 
+static void
+check_extents (AtspiComponent *iface, AtspiCoordType ctype, gint x, gint y)
+{
+  AtspiRect *r = atspi_component_get_extents (iface, ctype, NULL);
+
+  g_assert_cmpint (r->x, ==, x);
+  g_assert_cmpint (r->y, ==, y);
+  g_assert_cmpint (r->width, ==, 250);
+  g_assert_cmpint (r->height, ==, 250);
+  g_free (r);
+}
+
+static void
+atk_test_component_get_extents_cached_window_move (TestAppFixture *fixture, gconstpointer user_data)
+{
+  AtspiAccessible *child = atspi_accessible_get_child_at_index (fixture->root_obj, 1, NULL);
+  AtspiComponent *iface = atspi_accessible_get_component_iface (child);
+  AtspiAction *action = atspi_accessible_get_action_iface (child);
+  EventCollector *collector;
+
+  /* Extents are only cached while bounds changes are listened to */
+  collector = event_collector_new ("object:bounds-changed");
+  atspi_accessible_set_cache_mask (child, ATSPI_CACHE_DEFAULT | ATSPI_CACHE_EXTENTS);
+
+  check_extents (iface, ATSPI_COORD_TYPE_SCREEN, 350, 200);
+  check_extents (iface, ATSPI_COORD_TYPE_WINDOW, 350, 200);
+
+  /* Moving the window sends no bounds change, but moves the object on the screen */
+  g_assert_true (atspi_action_do_action (action, 0, NULL));
+  check_extents (iface, ATSPI_COORD_TYPE_SCREEN, 450, 300);
+  check_extents (iface, ATSPI_COORD_TYPE_WINDOW, 350, 200);
+
+  event_collector_free (collector);
+  g_object_unref (action);
+  g_object_unref (iface);
+  g_object_unref (child);
+}
+
+/*
+ * The grid has more children than the bridge hit tests by itself, so with
+ * ATSPI_SPATIAL_INDEX set the children are looked up in its spatial index.
+ * cell<i> is at (i % 10 * 10, i / 10 * 10), 10 pixels square, except for
+ * cell0, which starts empty. The dummy component reports x, y, width and
+ * height as width, height, x and y, hence the order of the arguments
+ * given to atspi_component_set_extents below.
+ */
+static void
+spatial_index_fixture_setup (TestAppFixture *fixture, gconstpointer user_data)
+{
+  g_setenv ("ATSPI_SPATIAL_INDEX", "1", TRUE);
+  fixture_setup (fixture, user_data);
+  g_unsetenv ("ATSPI_SPATIAL_INDEX");
+}
+
+static AtspiComponent *
+get_grid (TestAppFixture *fixture)
+{
+  AtspiAccessible *grid = atspi_accessible_get_child_at_index (fixture->root_obj, 0, NULL);
+  AtspiComponent *iface = atspi_accessible_get_component_iface (grid);
+
+  g_assert_nonnull (iface);
+  g_object_unref (grid);
+  return iface;
+}
+
+static AtspiComponent *
+get_cell (TestAppFixture *fixture, gint index)
+{
+  AtspiAccessible *grid = atspi_accessible_get_child_at_index (fixture->root_obj, 0, NULL);
+  AtspiAccessible *cell = atspi_accessible_get_child_at_index (grid, index, NULL);
+  AtspiComponent *iface = atspi_accessible_get_component_iface (cell);
+
+  g_assert_nonnull (iface);
+  g_object_unref (cell);
+  g_object_unref (grid);
+  return iface;
+}
+
+static void
+check_accessible_at_point (AtspiComponent *iface, gint x, gint y, const char *expected_name)
+{
+  AtspiAccessible *r = atspi_component_get_accessible_at_point (iface, x, y,
+                                                                ATSPI_COORD_TYPE_SCREEN,
+                                                                NULL);
+  if (!expected_name)
+    {
+      g_assert_null (r);
+      return;
+    }
+  g_assert_nonnull (r);
+  check_name (r, expected_name);
+  g_object_unref (r);
+}
+
+static void
+atk_test_component_get_accessible_at_point_indexed (TestAppFixture *fixture, gconstpointer user_data)
+{
+  AtspiComponent *grid = get_grid (fixture);
+
+  check_accessible_at_point (grid, 15, 5, "cell1");
+  check_accessible_at_point (grid, 45, 35, "cell34");
+  check_accessible_at_point (grid, 90, 60, "cell69");
+  check_accessible_at_point (grid, 99, 69, "cell69");
+  check_accessible_at_point (grid, 5, 5, NULL);
+  check_accessible_at_point (grid, 100, 5, NULL);
+  check_accessible_at_point (grid, 5, 70, NULL);
+  g_object_unref (grid);
+}
+
+static void
+atk_test_component_get_accessible_at_point_moved (TestAppFixture *fixture, gconstpointer user_data)
+{
+  AtspiComponent *grid = get_grid (fixture);
+  AtspiComponent *cell = get_cell (fixture, 34);
+
+  check_accessible_at_point (grid, 45, 35, "cell34");
+
+  g_assert_true (atspi_component_set_extents (cell, 10, 10, 200, 200, ATSPI_COORD_TYPE_SCREEN, NULL));
+  check_accessible_at_point (grid, 205, 205, "cell34");
+  check_accessible_at_point (grid, 45, 35, NULL);
+  check_accessible_at_point (grid, 35, 35, "cell33");
+
+  /* Growing a child over its neighbours makes it the first child at their points */
+  g_assert_true (atspi_component_set_extents (cell, 100, 70, 0, 0, ATSPI_COORD_TYPE_SCREEN, NULL));
+  check_accessible_at_point (grid, 35, 35, "cell33");
+  check_accessible_at_point (grid, 45, 35, "cell34");
+  check_accessible_at_point (grid, 95, 65, "cell34");
+  g_object_unref (cell);
+  g_object_unref (grid);
+}
+
+static void
+atk_test_component_get_accessible_at_point_resized (TestAppFixture *fixture, gconstpointer user_data)
+{
+  AtspiComponent *grid = get_grid (fixture);
+  AtspiComponent *cell = get_cell (fixture, 0);
+
+  /* cell0 is empty when the index is built, so it is left out of it */
+  check_accessible_at_point (grid, 15, 5, "cell1");
+
+  g_assert_true (atspi_component_set_extents (cell, 20, 10, 0, 0, ATSPI_COORD_TYPE_SCREEN, NULL));
+  check_accessible_at_point (grid, 5, 5, "cell0");
+  check_accessible_at_point (grid, 15, 5, "cell0");
+  check_accessible_at_point (grid, 25, 5, "cell2");
+
+  g_assert_true (atspi_component_set_extents (cell, 0, 10, 0, 0, ATSPI_COORD_TYPE_SCREEN, NULL));
+  check_accessible_at_point (grid, 5, 5, NULL);
+  check_accessible_at_point (grid, 15, 5, "cell1");
+  g_object_unref (cell);
+  g_object_unref (grid);
+}
+
+/*
+ * With ATSPI_BOUNDS_CHANGE_INTERVAL set, the bounds changes of an object
+ * are coalesced for that long, unless a client listens to
+ * object:bounds-changed:unthrottled.
+ */
+static void
+bounds_throttle_fixture_setup (TestAppFixture *fixture, gconstpointer user_data)
+{
+  g_setenv ("ATSPI_BOUNDS_CHANGE_INTERVAL", "500", TRUE);
+  fixture_setup (fixture, user_data);
+  g_unsetenv ("ATSPI_BOUNDS_CHANGE_INTERVAL");
+}
+
+static void
+check_bounds_event (AtspiEvent *event, const char *type, gint size)
+{
+  AtspiRect *rect;
+
+  g_assert_cmpstr (event->type, ==, type);
+  g_assert_true (G_VALUE_HOLDS (&event->any_data, ATSPI_TYPE_RECT));
+  rect = g_value_get_boxed (&event->any_data);
+  g_assert_cmpint (rect->x, ==, size);
+  g_assert_cmpint (rect->y, ==, size);
+  g_assert_cmpint (rect->width, ==, size);
+  g_assert_cmpint (rect->height, ==, size);
+}
+
+static void
+set_square_extents (AtspiComponent *iface, gint size)
+{
+  g_assert_true (atspi_component_set_extents (iface, size, size, size, size, ATSPI_COORD_TYPE_SCREEN, NULL));
+}
+
+static void
+atk_test_component_bounds_changed_coalesced (TestAppFixture *fixture, gconstpointer user_data)
+{
+  AtspiAccessible *child = atspi_accessible_get_child_at_index (fixture->root_obj, 1, NULL);
+  AtspiComponent *iface = atspi_accessible_get_component_iface (child);
+  EventCollector *collector;
+
+  collector = event_collector_new ("object:bounds-changed");
+  set_square_extents (iface, 10);
+  set_square_extents (iface, 20);
+  set_square_extents (iface, 30);
+  event_collector_wait (collector, G_MAXUINT, 1000);
+
+  g_assert_cmpint (collector->events->len, ==, 1);
+  check_bounds_event (g_ptr_array_index (collector->events, 0), "object:bounds-changed", 30);
+
+  event_collector_free (collector);
+  g_object_unref (iface);
+  g_object_unref (child);
+}
+
+static void
+atk_test_component_bounds_changed_unthrottled (TestAppFixture *fixture, gconstpointer user_data)
+{
+  AtspiAccessible *child = atspi_accessible_get_child_at_index (fixture->root_obj, 1, NULL);
+  AtspiComponent *iface = atspi_accessible_get_component_iface (child);
+  EventCollector *unthrottled, *collector;
+  gint i;
+
+  unthrottled = event_collector_new ("object:bounds-changed:unthrottled");
+  collector = event_collector_new ("object:bounds-changed");
+  set_square_extents (iface, 10);
+  set_square_extents (iface, 20);
+  set_square_extents (iface, 30);
+  event_collector_wait (unthrottled, G_MAXUINT, 1000);
+
+  /* Every change is sent, to plain listeners as well */
+  g_assert_cmpint (unthrottled->events->len, ==, 3);
+  g_assert_cmpint (collector->events->len, ==, 3);
+  for (i = 0; i < 3; i++)
+    {
+      check_bounds_event (g_ptr_array_index (unthrottled->events, i),
+                          "object:bounds-changed:unthrottled", (i + 1) * 10);
+      check_bounds_event (g_ptr_array_index (collector->events, i),
+                          "object:bounds-changed:unthrottled", (i + 1) * 10);
+    }
+
+  /* Once nobody listens to unthrottled changes, they are coalesced again */
+  event_collector_free (unthrottled);
+  g_ptr_array_set_size (collector->events, 0);
+  set_square_extents (iface, 40);
+  set_square_extents (iface, 50);
+  event_collector_wait (collector, G_MAXUINT, 1000);
+
+  g_assert_cmpint (collector->events->len, ==, 1);
+  check_bounds_event (g_ptr_array_index (collector->events, 0), "object:bounds-changed", 50);
+
+  event_collector_free (collector);
+  g_object_unref (iface);
+  g_object_unref (child);
+}
+
 void
 atk_test_component (void)
 {
@@ -193,4 +476,18 @@ atk_test_component (void)
               TestAppFixture, DATA_FILE, fixture_setup, atk_test_component_get_alpha, fixture_teardown);
   g_test_add ("/component/atk_test_component_set_extents",
               TestAppFixture, DATA_FILE, fixture_setup, atk_test_component_set_extents, fixture_teardown);
+  g_test_add ("/component/atk_test_component_get_extents_batch",
+              TestAppFixture, DATA_FILE, fixture_setup, atk_test_component_get_extents_batch, fixture_teardown);
+  g_test_add ("/component/atk_test_component_get_extents_cached_window_move",
+              TestAppFixture, DATA_FILE, fixture_setup, atk_test_component_get_extents_cached_window_move, fixture_teardown);
+  g_test_add ("/component/atk_test_component_get_accessible_at_point_indexed",
+              TestAppFixture, GRID_DATA_FILE, spatial_index_fixture_setup, atk_test_component_get_accessible_at_point_indexed, fixture_teardown);
+  g_test_add ("/component/atk_test_component_get_accessible_at_point_moved",
+              TestAppFixture, GRID_DATA_FILE, spatial_index_fixture_setup, atk_test_component_get_accessible_at_point_moved, fixture_teardown);
+  g_test_add ("/component/atk_test_component_get_accessible_at_point_resized",
+              TestAppFixture, GRID_DATA_FILE, spatial_index_fixture_setup, atk_test_component_get_accessible_at_point_resized, fixture_teardown);
+  g_test_add ("/component/atk_test_component_bounds_changed_coalesced",
+              TestAppFixture, DATA_FILE, bounds_throttle_fixture_setup, atk_test_component_bounds_changed_coalesced, fixture_teardown);
+  g_test_add ("/component/atk_test_component_bounds_changed_unthrottled",
+              TestAppFixture, DATA_FILE, bounds_throttle_fixture_setup, atk_test_component_bounds_changed_unthrottled, fixture_teardown);
 }
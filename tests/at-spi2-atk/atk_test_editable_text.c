@@ -112,6 +112,84 @@ atk_test_editable_text_paste_text (TestAppFixture *fixture, gconstpointer user_d
   g_object_unref (child);
 }
 
+static void
+atk_test_editable_text_apply_edits (TestAppFixture *fixture, gconstpointer user_data)
+{
+  AtspiAccessible *obj = fixture->root_obj;
+  AtspiAccessible *child = atspi_accessible_get_child_at_index (obj, 1, NULL);
+  AtspiEditableText *iface = atspi_accessible_get_editable_text_iface (child);
+  AtspiText *text_iface = atspi_accessible_get_text_iface (child);
+  EventCollector *collector;
+  AtspiEvent *event;
+  gchar *text;
+  g_assert_nonnull (iface);
+  g_assert_nonnull (text_iface);
+
+  collector = event_collector_new ("object:text-changed");
+
+  GArray *edits = g_array_new (FALSE, TRUE, sizeof (AtspiTextEdit));
+  AtspiTextEdit edit = { ATSPI_TEXT_EDIT_INSERT, 0, 0, "test_text" };
+  g_array_append_val (edits, edit);
+  edit.type = ATSPI_TEXT_EDIT_DELETE;
+  edit.start_pos = 1;
+  edit.end_pos = 2;
+  edit.text = NULL;
+  g_array_append_val (edits, edit);
+  edit.type = ATSPI_TEXT_EDIT_COPY;
+  edit.start_pos = 0;
+  edit.end_pos = 3;
+  g_array_append_val (edits, edit);
+  edit.type = ATSPI_TEXT_EDIT_PASTE;
+  edit.start_pos = 2;
+  g_array_append_val (edits, edit);
+  g_assert_true (atspi_editable_text_apply_edits (iface, edits, NULL));
+
+  text = atspi_text_get_text (text_iface, 0, -1, NULL);
+  g_assert_cmpstr (text, ==, "tstst_textsecond test text");
+  g_free (text);
+
+  /* The four edits are reported as a single insertion */
+  event_collector_wait (collector, G_MAXUINT, 200);
+  g_assert_cmpint (collector->events->len, ==, 1);
+  event = g_ptr_array_index (collector->events, 0);
+  g_assert_cmpstr (event->type, ==, "object:text-changed:insert");
+  g_assert_cmpint (event->detail1, ==, 0);
+  g_assert_cmpint (event->detail2, ==, 10);
+  g_assert_cmpstr (g_value_get_string (&event->any_data), ==, "tstst_text");
+  g_ptr_array_set_size (collector->events, 0);
+
+  /* A batch with one bad edit is rejected as a whole */
+  g_array_remove_index (edits, 3);
+  edit.type = ATSPI_TEXT_EDIT_CUT;
+  edit.start_pos = 3;
+  edit.end_pos = 1;
+  g_array_append_val (edits, edit);
+  g_assert_false (atspi_editable_text_apply_edits (iface, edits, NULL));
+
+  /* So is one whose offsets can't be checked, as they follow a paste */
+  g_array_remove_index (edits, 3);
+  edit.type = ATSPI_TEXT_EDIT_PASTE;
+  edit.start_pos = 2;
+  g_array_append_val (edits, edit);
+  edit.type = ATSPI_TEXT_EDIT_DELETE;
+  edit.start_pos = 0;
+  edit.end_pos = 1;
+  g_array_append_val (edits, edit);
+  g_assert_false (atspi_editable_text_apply_edits (iface, edits, NULL));
+
+  text = atspi_text_get_text (text_iface, 0, -1, NULL);
+  g_assert_cmpstr (text, ==, "tstst_textsecond test text");
+  g_free (text);
+  event_collector_wait (collector, G_MAXUINT, 200);
+  g_assert_cmpint (collector->events->len, ==, 0);
+
+  event_collector_free (collector);
+  g_array_free (edits, TRUE);
+  g_object_unref (text_iface);
+  g_object_unref (iface);
+  g_object_unref (child);
+}
+
 void
 atk_test_editable_text (void)
 {
@@ -131,4 +209,6 @@ atk_test_editable_text (void)
               TestAppFixture, DATA_FILE, fixture_setup, atk_test_editable_text_delete_text, fixture_teardown);
   g_test_add ("/editable_text/atk_test_editable_text_paste_text",
               TestAppFixture, DATA_FILE, fixture_setup, atk_test_editable_text_paste_text, fixture_teardown);
+  g_test_add ("/editable_text/atk_test_editable_text_apply_edits",
+              TestAppFixture, DATA_FILE, fixture_setup, atk_test_editable_text_apply_edits, fixture_teardown);
 }
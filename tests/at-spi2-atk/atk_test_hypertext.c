@@ -66,6 +66,41 @@ atk_test_hypertext_get_link (TestAppFixture *fixture, gconstpointer user_data)
   g_object_unref (child);
 }
 
+static void
+atk_test_hypertext_get_all_links (TestAppFixture *fixture, gconstpointer user_data)
+{
+  AtspiAccessible *_obj = fixture->root_obj;
+  g_assert_nonnull (_obj);
+  AtspiAccessible *child = atspi_accessible_get_child_at_index (_obj, 0, NULL);
+  g_assert_nonnull (child);
+  AtspiHypertext *obj = atspi_accessible_get_hypertext_iface (child);
+  g_assert_nonnull (obj);
+  GArray *links = atspi_hypertext_get_links (obj, NULL);
+  g_assert_nonnull (links);
+  g_assert_cmpint (links->len, ==, 2);
+
+  AtspiHyperlinkInfo *info = &g_array_index (links, AtspiHyperlinkInfo, 0);
+  g_assert_nonnull (info->link);
+  g_assert_cmpstr (info->uri, ==, "dh-zone.com");
+  g_assert_cmpint (info->start_offset, ==, 50);
+  g_assert_cmpint (info->end_offset, ==, 61);
+  g_assert_cmpint (info->n_anchors, ==, 1);
+
+  info = &g_array_index (links, AtspiHyperlinkInfo, 1);
+  g_assert_nonnull (info->link);
+  g_assert_cmpstr (info->uri, ==, "pinkbike.com");
+  g_assert_cmpint (info->start_offset, ==, 69);
+  g_assert_cmpint (info->end_offset, ==, 81);
+
+  gchar *str = atspi_hyperlink_get_uri (info->link, 0, NULL);
+  g_assert_cmpstr (str, ==, "pinkbike.com");
+  g_free (str);
+
+  g_array_free (links, TRUE);
+  g_object_unref (obj);
+  g_object_unref (child);
+}
+
 static void
 atk_test_hypertext_get_link_index (TestAppFixture *fixture, gconstpointer user_data)
 {
@@ -92,6 +127,8 @@ atk_test_hypertext (void)
               TestAppFixture, DATA_FILE, fixture_setup, atk_test_hypertext_get_n_links, fixture_teardown);
   g_test_add ("/hypertext/atk_test_hypertext_get_links",
               TestAppFixture, DATA_FILE, fixture_setup, atk_test_hypertext_get_link, fixture_teardown);
+  g_test_add ("/hypertext/atk_test_hypertext_get_all_links",
+              TestAppFixture, DATA_FILE, fixture_setup, atk_test_hypertext_get_all_links, fixture_teardown);
   g_test_add ("/hypertext/atk_test_hypertext_get_link_index",
               TestAppFixture, DATA_FILE, fixture_setup, atk_test_hypertext_get_link_index, fixture_teardown);
 }
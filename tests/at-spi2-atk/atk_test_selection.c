@@ -185,6 +185,160 @@ atk_test_selection_clear_selection (TestAppFixture *fixture, gconstpointer user_
   g_object_unref (child);
 }
 
+static void
+atk_test_selection_get_selection_snapshot (TestAppFixture *fixture, gconstpointer user_data)
+{
+  AtspiAccessible *obj = fixture->root_obj;
+  check_name (obj, "root_object");
+  AtspiAccessible *child = atspi_accessible_get_child_at_index (obj, 0, NULL);
+  AtspiSelection *iface = atspi_accessible_get_selection_iface (child);
+  g_assert_nonnull (iface);
+
+  GArray *rows = NULL, *columns = NULL;
+  GArray *ranges = atspi_selection_get_selection_snapshot (iface, &rows, &columns, NULL);
+  g_assert_nonnull (ranges);
+  g_assert_cmpint (ranges->len, ==, 2);
+  g_assert_cmpint (g_array_index (ranges, AtspiSelectionRange, 0).start, ==, 0);
+  g_assert_cmpint (g_array_index (ranges, AtspiSelectionRange, 0).count, ==, 2);
+  g_assert_cmpint (g_array_index (ranges, AtspiSelectionRange, 1).start, ==, 4);
+  g_assert_cmpint (g_array_index (ranges, AtspiSelectionRange, 1).count, ==, 1);
+  g_assert_cmpint (rows->len, ==, 0);
+  g_assert_cmpint (columns->len, ==, 0);
+  g_array_free (ranges, TRUE);
+  g_array_free (rows, TRUE);
+  g_array_free (columns, TRUE);
+
+  atspi_selection_select_child (iface, 2, NULL);
+  ranges = atspi_selection_get_selection_snapshot (iface, NULL, NULL, NULL);
+  g_assert_cmpint (ranges->len, ==, 2);
+  g_assert_cmpint (g_array_index (ranges, AtspiSelectionRange, 0).count, ==, 3);
+  g_array_free (ranges, TRUE);
+
+  g_object_unref (iface);
+  g_object_unref (child);
+}
+
+static void
+check_selection_change (GArray *changes, guint i, gboolean selected, gint start, gint count)
+{
+  AtspiSelectionChange *change = &g_array_index (changes, AtspiSelectionChange, i);
+
+  g_assert_cmpint (change->selected, ==, selected);
+  g_assert_cmpint (change->start, ==, start);
+  g_assert_cmpint (change->count, ==, count);
+}
+
+/* Waits for the next selection-changed event and returns its changes */
+static GArray *
+wait_for_selection_changes (EventCollector *collector, gint n_selected, gint n_deselected)
+{
+  AtspiEvent *event;
+
+  event_collector_wait (collector, 1, 1000);
+  g_assert_cmpint (collector->events->len, ==, 1);
+  event = g_ptr_array_index (collector->events, 0);
+  g_assert_cmpstr (event->type, ==, "object:selection-changed");
+  g_assert_cmpint (event->detail1, ==, n_selected);
+  g_assert_cmpint (event->detail2, ==, n_deselected);
+  g_assert_true (G_VALUE_HOLDS (&event->any_data, G_TYPE_ARRAY));
+  return g_array_ref (g_value_get_boxed (&event->any_data));
+}
+
+static void
+atk_test_selection_changed_event (TestAppFixture *fixture, gconstpointer user_data)
+{
+  AtspiAccessible *obj = fixture->root_obj;
+  AtspiAccessible *child = atspi_accessible_get_child_at_index (obj, 0, NULL);
+  AtspiSelection *iface = atspi_accessible_get_selection_iface (child);
+  EventCollector *collector;
+  GArray *changes;
+  g_assert_nonnull (iface);
+
+  collector = event_collector_new ("object:selection-changed");
+  changes = atspi_selection_get_selection_snapshot (iface, NULL, NULL, NULL);
+  g_array_free (changes, TRUE);
+
+  atspi_selection_select_child (iface, 2, NULL);
+  changes = wait_for_selection_changes (collector, 1, 0);
+  g_assert_cmpint (changes->len, ==, 1);
+  check_selection_change (changes, 0, TRUE, 2, 1);
+  g_array_unref (changes);
+  g_ptr_array_set_size (collector->events, 0);
+
+  atspi_selection_clear_selection (iface, NULL);
+  changes = wait_for_selection_changes (collector, 0, 4);
+  g_assert_cmpint (changes->len, ==, 2);
+  check_selection_change (changes, 0, FALSE, 0, 3);
+  check_selection_change (changes, 1, FALSE, 4, 1);
+  g_array_unref (changes);
+
+  event_collector_free (collector);
+  g_object_unref (iface);
+  g_object_unref (child);
+}
+
+static void
+atk_test_selection_changed_event_unlistened (TestAppFixture *fixture, gconstpointer user_data)
+{
+  AtspiAccessible *obj = fixture->root_obj;
+  AtspiAccessible *child = atspi_accessible_get_child_at_index (obj, 0, NULL);
+  AtspiSelection *iface = atspi_accessible_get_selection_iface (child);
+  EventCollector *collector;
+  GArray *changes;
+  g_assert_nonnull (iface);
+
+  changes = atspi_selection_get_selection_snapshot (iface, NULL, NULL, NULL);
+  g_array_free (changes, TRUE);
+
+  /* With no one listening, the change is not worked out yet */
+  atspi_selection_select_child (iface, 2, NULL);
+
+  /* so the next event is relative to the snapshot */
+  collector = event_collector_new ("object:selection-changed");
+  atspi_selection_clear_selection (iface, NULL);
+  changes = wait_for_selection_changes (collector, 0, 3);
+  g_assert_cmpint (changes->len, ==, 2);
+  check_selection_change (changes, 0, FALSE, 0, 2);
+  check_selection_change (changes, 1, FALSE, 4, 1);
+  g_array_unref (changes);
+
+  event_collector_free (collector);
+  g_object_unref (iface);
+  g_object_unref (child);
+}
+
+static void
+atk_test_selection_changed_event_untracked (TestAppFixture *fixture, gconstpointer user_data)
+{
+  AtspiAccessible *obj = fixture->root_obj;
+  AtspiAccessible *child = atspi_accessible_get_child_at_index (obj, 0, NULL);
+  AtspiSelection *iface = atspi_accessible_get_selection_iface (child);
+  EventCollector *collector;
+  AtspiEvent *event;
+  GArray *changes;
+  g_assert_nonnull (iface);
+
+  collector = event_collector_new ("object:selection-changed");
+  changes = atspi_selection_get_selection_snapshot (iface, NULL, NULL, NULL);
+  g_array_free (changes, TRUE);
+
+  /* Once no one listens, the snapshot is dropped */
+  event_collector_free (collector);
+
+  /* and later events carry no changes until a new one is taken */
+  collector = event_collector_new ("object:selection-changed");
+  atspi_selection_select_child (iface, 2, NULL);
+  event_collector_wait (collector, 1, 1000);
+  g_assert_cmpint (collector->events->len, ==, 1);
+  event = g_ptr_array_index (collector->events, 0);
+  g_assert_cmpstr (event->type, ==, "object:selection-changed");
+  g_assert_false (G_VALUE_HOLDS (&event->any_data, G_TYPE_ARRAY));
+
+  event_collector_free (collector);
+  g_object_unref (iface);
+  g_object_unref (child);
+}
+
 void
 atk_test_selection (void)
 {
@@ -206,4 +360,12 @@ atk_test_selection (void)
               TestAppFixture, DATA_FILE, fixture_setup, atk_test_selection_select_all, fixture_teardown);
   g_test_add ("/selection/atk_test_selection_clear_selection",
               TestAppFixture, DATA_FILE, fixture_setup, atk_test_selection_clear_selection, fixture_teardown);
+  g_test_add ("/selection/atk_test_selection_get_selection_snapshot",
+              TestAppFixture, DATA_FILE, fixture_setup, atk_test_selection_get_selection_snapshot, fixture_teardown);
+  g_test_add ("/selection/atk_test_selection_changed_event",
+              TestAppFixture, DATA_FILE, fixture_setup, atk_test_selection_changed_event, fixture_teardown);
+  g_test_add ("/selection/atk_test_selection_changed_event_unlistened",
+              TestAppFixture, DATA_FILE, fixture_setup, atk_test_selection_changed_event_unlistened, fixture_teardown);
+  g_test_add ("/selection/atk_test_selection_changed_event_untracked",
+              TestAppFixture, DATA_FILE, fixture_setup, atk_test_selection_changed_event_untracked, fixture_teardown);
 }
@@ -22,6 +22,7 @@
 #include "atk_test_util.h"
 
 #define DATA_FILE TESTS_DATA_DIR "/test-table.xml"
+#define GRID_DATA_FILE TESTS_DATA_DIR "/test-table-grid.xml"
 
 static void
 atk_test_table_get_caption (TestAppFixture *fixture, gconstpointer user_data)
@@ -467,6 +468,155 @@ atk_test_table_is_selected (TestAppFixture *fixture, gconstpointer user_data)
   g_object_unref (child);
 }
 
+static void
+atk_test_table_get_region (TestAppFixture *fixture, gconstpointer user_data)
+{
+  AtspiAccessible *_obj = fixture->root_obj;
+  g_assert_nonnull (_obj);
+  AtspiAccessible *child = atspi_accessible_get_child_at_index (_obj, 0, NULL);
+  g_assert_nonnull (child);
+  AtspiTable *obj = atspi_accessible_get_table_iface (child);
+  GPtrArray *row_headers, *column_headers;
+  AtspiTableRegionCell *cell;
+
+  GArray *cells = atspi_table_get_region (obj, 0, 0, 2, 3, ATSPI_CACHE_NAME | ATSPI_CACHE_ROLE,
+                                          &row_headers, &column_headers, NULL);
+  g_assert_nonnull (cells);
+  g_assert_cmpint (cells->len, ==, 6);
+
+  cell = &g_array_index (cells, AtspiTableRegionCell, 0);
+  check_name (cell->cell, "cell 0/0");
+  g_assert_cmpint (cell->row, ==, 0);
+  g_assert_cmpint (cell->column, ==, 0);
+  g_assert_cmpint (cell->row_extent, ==, 2);
+  g_assert_cmpint (cell->column_extent, ==, 1);
+  g_assert_false (cell->is_selected);
+  g_assert_cmpint (atspi_accessible_get_role (cell->cell, NULL), ==, ATSPI_ROLE_TABLE_CELL);
+
+  cell = &g_array_index (cells, AtspiTableRegionCell, 2);
+  check_name (cell->cell, "cell 2/0");
+  g_assert_cmpint (cell->row, ==, 0);
+  g_assert_cmpint (cell->column, ==, 2);
+  g_assert_true (cell->is_selected);
+
+  cell = &g_array_index (cells, AtspiTableRegionCell, 4);
+  check_name (cell->cell, "cell 1/1");
+  g_assert_cmpint (cell->row, ==, 1);
+  g_assert_cmpint (cell->column, ==, 1);
+
+  g_assert_cmpint (row_headers->len, ==, 2);
+  check_name (g_ptr_array_index (row_headers, 0), "row 1 header");
+  check_name (g_ptr_array_index (row_headers, 1), "row 2 header");
+  g_assert_cmpint (column_headers->len, ==, 3);
+  check_name (g_ptr_array_index (column_headers, 2), "column 3 header");
+
+  g_array_free (cells, TRUE);
+  g_ptr_array_unref (row_headers);
+  g_ptr_array_unref (column_headers);
+
+  /* The region is clipped to the table */
+  cells = atspi_table_get_region (obj, 3, 2, 5, 5, ATSPI_CACHE_NONE, NULL, NULL, NULL);
+  g_assert_nonnull (cells);
+  g_assert_cmpint (cells->len, ==, 1);
+  cell = &g_array_index (cells, AtspiTableRegionCell, 0);
+  check_name (cell->cell, "cell 2/3");
+  g_array_free (cells, TRUE);
+
+  g_object_unref (obj);
+  g_object_unref (child);
+}
+
+static void
+check_cell_position (AtspiAccessible *accessible, gint expected_row, gint expected_column)
+{
+  AtspiTableCell *cell = atspi_accessible_get_table_cell (accessible);
+  gint row = -1, column = -1;
+
+  g_assert_nonnull (cell);
+  atspi_table_cell_get_position (cell, &row, &column, NULL);
+  g_assert_cmpint (row, ==, expected_row);
+  g_assert_cmpint (column, ==, expected_column);
+  g_object_unref (cell);
+}
+
+/* Inserts a row at the top of the grid, moving all of its cells down */
+static void
+grid_insert_row (AtspiAccessible *grid)
+{
+  AtspiAction *action = atspi_accessible_get_action_iface (grid);
+
+  g_assert_nonnull (action);
+  g_assert_true (atspi_action_do_action (action, 0, NULL));
+  g_object_unref (action);
+}
+
+static void
+atk_test_table_virtual_cell_moved (TestAppFixture *fixture, gconstpointer user_data)
+{
+  AtspiAccessible *_obj = fixture->root_obj;
+  g_assert_nonnull (_obj);
+  AtspiAccessible *child = atspi_accessible_get_child_at_index (_obj, 0, NULL);
+  g_assert_nonnull (child);
+  AtspiTable *obj = atspi_accessible_get_table_iface (child);
+  AtspiAccessible *cell, *moved, *other;
+
+  /* Cells of a table that manages its descendants keep their path */
+  cell = atspi_table_get_accessible_at (obj, 2, 1, NULL);
+  check_name (cell, "cell 1/2");
+  check_cell_position (cell, 2, 1);
+  other = atspi_table_get_accessible_at (obj, 2, 1, NULL);
+  g_assert_true (other == cell);
+  g_object_unref (other);
+
+  grid_insert_row (child);
+
+  /* The cell is found under its new position */
+  moved = atspi_table_get_accessible_at (obj, 3, 1, NULL);
+  g_assert_nonnull (moved);
+  g_assert_true (moved != cell);
+  check_name (moved, "cell 1/2");
+  check_cell_position (moved, 3, 1);
+
+  /* and its old path leads to the cell now in its place */
+  check_cell_position (cell, 2, 1);
+  other = atspi_table_get_accessible_at (obj, 2, 1, NULL);
+  g_assert_true (other == cell);
+  g_object_unref (other);
+
+  g_object_unref (moved);
+  g_object_unref (cell);
+  g_object_unref (obj);
+  g_object_unref (child);
+}
+
+static void
+atk_test_table_virtual_cell_moved_twice (TestAppFixture *fixture, gconstpointer user_data)
+{
+  AtspiAccessible *_obj = fixture->root_obj;
+  g_assert_nonnull (_obj);
+  AtspiAccessible *child = atspi_accessible_get_child_at_index (_obj, 0, NULL);
+  g_assert_nonnull (child);
+  AtspiTable *obj = atspi_accessible_get_table_iface (child);
+  AtspiAccessible *cell, *moved;
+
+  cell = atspi_table_get_accessible_at (obj, 0, 3, NULL);
+  check_cell_position (cell, 0, 3);
+  grid_insert_row (child);
+  grid_insert_row (child);
+  g_assert_cmpint (atspi_table_get_n_rows (obj, NULL), ==, 12);
+
+  /* The cell is found two rows down */
+  moved = atspi_table_get_accessible_at (obj, 2, 3, NULL);
+  check_name (moved, "cell 3/0");
+  check_cell_position (moved, 2, 3);
+  g_assert_null (atspi_table_get_accessible_at (obj, 12, 3, NULL));
+
+  g_object_unref (moved);
+  g_object_unref (cell);
+  g_object_unref (obj);
+  g_object_unref (child);
+}
+
 void
 atk_test_table (void)
 {
@@ -522,4 +672,10 @@ atk_test_table (void)
               TestAppFixture, DATA_FILE, fixture_setup, atk_test_table_get_row_column_extents_at_index, fixture_teardown);
   g_test_add ("/table/atk_test_table_is_selected",
               TestAppFixture, DATA_FILE, fixture_setup, atk_test_table_is_selected, fixture_teardown);
+  g_test_add ("/table/atk_test_table_get_region",
+              TestAppFixture, DATA_FILE, fixture_setup, atk_test_table_get_region, fixture_teardown);
+  g_test_add ("/table/atk_test_table_virtual_cell_moved",
+              TestAppFixture, GRID_DATA_FILE, fixture_setup, atk_test_table_virtual_cell_moved, fixture_teardown);
+  g_test_add ("/table/atk_test_table_virtual_cell_moved_twice",
+              TestAppFixture, GRID_DATA_FILE, fixture_setup, atk_test_table_virtual_cell_moved_twice, fixture_teardown);
 }
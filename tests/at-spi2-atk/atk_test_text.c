@@ -24,6 +24,12 @@
 #include "atk_test_util.h"
 
 #define DATA_FILE TESTS_DATA_DIR "/test-text.xml"
+#define LARGE_DATA_FILE TESTS_DATA_DIR "/test-text-large.xml"
+
+/* Repeated in test-text-large.xml to go past the size at which text is
+ * passed through a file descriptor */
+#define LARGE_TEXT_UNIT "abcdefghijklmnop"
+#define LARGE_TEXT_REPEAT 4500
 
 static gboolean
 GHRunc_find (gpointer key, gpointer value, gpointer user_data)
@@ -66,6 +72,22 @@ atk_test_text_get_text (TestAppFixture *fixture, gconstpointer user_data)
   g_object_unref (child);
 }
 
+static void
+atk_test_text_get_whole_text (TestAppFixture *fixture, gconstpointer user_data)
+{
+  AtspiAccessible *_obj = fixture->root_obj;
+  g_assert_nonnull (_obj);
+  AtspiAccessible *child = atspi_accessible_get_child_at_index (_obj, 0, NULL);
+  g_assert_nonnull (child);
+  AtspiText *obj = atspi_accessible_get_text_iface (child);
+
+  gchar *text = atspi_text_get_text (obj, 0, -1, NULL);
+  g_assert_cmpstr (text, ==, "text0 it works!.");
+  g_free (text);
+  g_object_unref (obj);
+  g_object_unref (child);
+}
+
 static void
 atk_test_text_get_caret_offset (TestAppFixture *fixture, gconstpointer user_data)
 {
@@ -474,6 +496,60 @@ atk_test_text_get_bounded_ranges (TestAppFixture *fixture, gconstpointer user_da
   g_object_unref (child);
 }
 
+static gchar *
+large_text_expected (void)
+{
+  GString *expected = g_string_new (NULL);
+  int i;
+
+  for (i = 0; i < LARGE_TEXT_REPEAT; i++)
+    g_string_append (expected, LARGE_TEXT_UNIT);
+  return g_string_free (expected, FALSE);
+}
+
+static void
+atk_test_text_get_large_text (TestAppFixture *fixture, gconstpointer user_data)
+{
+  AtspiAccessible *_obj = fixture->root_obj;
+  g_assert_nonnull (_obj);
+  AtspiAccessible *child = atspi_accessible_get_child_at_index (_obj, 0, NULL);
+  g_assert_nonnull (child);
+  AtspiText *obj = atspi_accessible_get_text_iface (child);
+  gchar *expected = large_text_expected ();
+  gint n_chars = strlen (expected);
+  gchar *sub;
+
+  g_assert_cmpint (n_chars, >, 70000);
+  g_assert_cmpint (atspi_text_get_character_count (obj, NULL), ==, n_chars);
+
+  /* Whole text */
+  gchar *text = atspi_text_get_text (obj, 0, -1, NULL);
+  g_assert_cmpstr (text, ==, expected);
+  g_free (text);
+
+  /* A range passed through the fd, starting mid-unit */
+  text = atspi_text_get_text (obj, 1005, 1005 + 70000, NULL);
+  sub = g_strndup (expected + 1005, 70000);
+  g_assert_cmpint (strlen (text), ==, 70000);
+  g_assert_cmpstr (text, ==, sub);
+  g_free (sub);
+  g_free (text);
+
+  /* A range running to the end of the text, passed through the fd */
+  text = atspi_text_get_text (obj, 1001, -1, NULL);
+  g_assert_cmpstr (text, ==, expected + 1001);
+  g_free (text);
+
+  /* Large enough to ask for an fd, but small enough to be sent inline */
+  text = atspi_text_get_text (obj, n_chars - 20000, -1, NULL);
+  g_assert_cmpstr (text, ==, expected + n_chars - 20000);
+  g_free (text);
+
+  g_free (expected);
+  g_object_unref (obj);
+  g_object_unref (child);
+}
+
 void
 atk_test_text (void)
 {
@@ -481,6 +557,10 @@ atk_test_text (void)
               TestAppFixture, DATA_FILE, fixture_setup, atk_test_text_get_character_count, fixture_teardown);
   g_test_add ("/text/atk_test_text_get_text",
               TestAppFixture, DATA_FILE, fixture_setup, atk_test_text_get_text, fixture_teardown);
+  g_test_add ("/text/atk_test_text_get_whole_text",
+              TestAppFixture, DATA_FILE, fixture_setup, atk_test_text_get_whole_text, fixture_teardown);
+  g_test_add ("/text/atk_test_text_get_large_text",
+              TestAppFixture, LARGE_DATA_FILE, fixture_setup, atk_test_text_get_large_text, fixture_teardown);
   g_test_add ("/text/atk_test_text_get_caret_offset",
               TestAppFixture, DATA_FILE, fixture_setup, atk_test_text_get_caret_offset, fixture_teardown);
   g_test_add ("/text/atk_test_text_get_text_attributes",
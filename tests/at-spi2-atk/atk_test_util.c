@@ -263,3 +263,79 @@ check_name (AtspiAccessible *accessible, const char *expected_name)
   g_assert_cmpstr (expected_name, ==, obj_name);
   g_free (obj_name);
 }
+
+static void
+event_free (gpointer event)
+{
+  g_boxed_free (ATSPI_TYPE_EVENT, event);
+}
+
+static void
+event_collector_cb (AtspiEvent *event, void *user_data)
+{
+  EventCollector *collector = user_data;
+
+  g_ptr_array_add (collector->events, event);
+  if (collector->events->len == collector->n_wanted)
+    atspi_event_quit ();
+}
+
+/*
+ * Starts collecting events of event_type, which are kept in
+ * collector->events until the collector is freed.
+ */
+EventCollector *
+event_collector_new (const gchar *event_type)
+{
+  EventCollector *collector = g_new0 (EventCollector, 1);
+  GError *error = NULL;
+
+  collector->event_type = g_strdup (event_type);
+  collector->events = g_ptr_array_new_with_free_func (event_free);
+  collector->listener = atspi_event_listener_new (event_collector_cb, collector, NULL);
+  if (!atspi_event_listener_register (collector->listener, event_type, &error))
+    g_error ("Could not register event listener for %s: %s\n", event_type, error->message);
+
+  return collector;
+}
+
+static gboolean
+event_collector_timeout_cb (gpointer user_data)
+{
+  guint *timeout = user_data;
+
+  *timeout = 0;
+  atspi_event_quit ();
+  return G_SOURCE_REMOVE;
+}
+
+/*
+ * Runs the main loop until n_events events have been collected in all, or
+ * until timeout_ms have passed. Pass G_MAXUINT to check that no more
+ * events arrive within the timeout.
+ */
+void
+event_collector_wait (EventCollector *collector, guint n_events, guint timeout_ms)
+{
+  guint timeout;
+
+  if (collector->events->len >= n_events)
+    return;
+
+  collector->n_wanted = n_events;
+  timeout = g_timeout_add (timeout_ms, event_collector_timeout_cb, &timeout);
+  atspi_event_main ();
+  if (timeout)
+    g_source_remove (timeout);
+  collector->n_wanted = 0;
+}
+
+void
+event_collector_free (EventCollector *collector)
+{
+  atspi_event_listener_deregister (collector->listener, collector->event_type, NULL);
+  g_object_unref (collector->listener);
+  g_ptr_array_free (collector->events, TRUE);
+  g_free (collector->event_type);
+  g_free (collector);
+}
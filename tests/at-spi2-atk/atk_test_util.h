@@ -60,4 +60,17 @@ void fixture_setup (TestAppFixture *fixture, gconstpointer user_data);
 void fixture_teardown (TestAppFixture *fixture, gconstpointer user_data);
 
 void check_name (AtspiAccessible *accessible, const char *expected_name);
+
+/* Collects the events of one type that the test application emits */
+typedef struct
+{
+  AtspiEventListener *listener;
+  gchar *event_type;
+  GPtrArray *events;
+  guint n_wanted;
+} EventCollector;
+
+EventCollector *event_collector_new (const gchar *event_type);
+void event_collector_wait (EventCollector *collector, guint n_events, guint timeout_ms);
+void event_collector_free (EventCollector *collector);
 #endif /* _ATK_TEST_UTIL_H */
@@ -122,6 +122,55 @@ atk_test_value_get_text (TestAppFixture *fixture, gconstpointer user_data)
   g_object_unref (child);
 }
 
+/*
+ * With ATSPI_VALUE_CHANGE_INTERVAL set, a burst of value changes is sent
+ * as its first and last values.
+ */
+static void
+value_throttle_fixture_setup (TestAppFixture *fixture, gconstpointer user_data)
+{
+  g_setenv ("ATSPI_VALUE_CHANGE_INTERVAL", "500", TRUE);
+  fixture_setup (fixture, user_data);
+  g_unsetenv ("ATSPI_VALUE_CHANGE_INTERVAL");
+}
+
+static void
+check_value_event (AtspiEvent *event, gdouble value)
+{
+  g_assert_cmpstr (event->type, ==, "object:property-change:accessible-value");
+  g_assert_true (G_VALUE_HOLDS_DOUBLE (&event->any_data));
+  g_assert_cmpfloat (g_value_get_double (&event->any_data), ==, value);
+}
+
+static void
+atk_test_value_changes_throttled (TestAppFixture *fixture, gconstpointer user_data)
+{
+  AtspiAccessible *child = atspi_accessible_get_child_at_index (fixture->root_obj, 0, NULL);
+  AtspiValue *obj = atspi_accessible_get_value_iface (child);
+  EventCollector *collector;
+
+  collector = event_collector_new ("object:property-change:accessible-value");
+  atspi_accessible_set_cache_mask (child, ATSPI_CACHE_DEFAULT | ATSPI_CACHE_VALUE);
+
+  /* None of these changes is a tenth of the range */
+  g_assert_true (atspi_value_set_current_value (obj, 2.3, NULL));
+  g_assert_true (atspi_value_set_current_value (obj, 2.35, NULL));
+  g_assert_true (atspi_value_set_current_value (obj, 2.4, NULL));
+  g_assert_true (atspi_value_set_current_value (obj, 2.45, NULL));
+  event_collector_wait (collector, G_MAXUINT, 1000);
+
+  g_assert_cmpint (collector->events->len, ==, 2);
+  check_value_event (g_ptr_array_index (collector->events, 0), 2.3);
+  check_value_event (g_ptr_array_index (collector->events, 1), 2.45);
+
+  /* The final value is cached from the event */
+  g_assert_cmpfloat (atspi_value_get_current_value (obj, NULL), ==, 2.45);
+
+  event_collector_free (collector);
+  g_object_unref (obj);
+  g_object_unref (child);
+}
+
 void
 atk_test_value (void)
 {
@@ -139,4 +188,6 @@ atk_test_value (void)
               TestAppFixture, DATA_FILE, fixture_setup, atk_test_value_get_minimum_increment, fixture_teardown);
   g_test_add ("/value/atk_test_value_get_text",
               TestAppFixture, DATA_FILE, fixture_setup, atk_test_value_get_text, fixture_teardown);
+  g_test_add ("/value/atk_test_value_changes_throttled",
+              TestAppFixture, DATA_FILE, value_throttle_fixture_setup, atk_test_value_changes_throttled, fixture_teardown);
 }
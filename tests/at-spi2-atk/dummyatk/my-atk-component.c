@@ -31,12 +31,23 @@
 typedef struct _MyAtkComponentInfo MyAtkComponentInfo;
 
 static void atk_component_interface_init (AtkComponentIface *iface);
+static void atk_action_interface_init (AtkActionIface *iface);
 
 G_DEFINE_TYPE_WITH_CODE (MyAtkComponent,
                          my_atk_component,
                          MY_TYPE_ATK_OBJECT,
                          G_IMPLEMENT_INTERFACE (ATK_TYPE_COMPONENT,
-                                                atk_component_interface_init));
+                                                atk_component_interface_init);
+                         G_IMPLEMENT_INTERFACE (ATK_TYPE_ACTION,
+                                                atk_action_interface_init));
+
+/*
+ * The position on the screen of the window that all components are in.
+ * Moving it changes their screen extents without any bounds change, as
+ * with real toolkits.
+ */
+static gint window_x = 0;
+static gint window_y = 0;
 
 void
 my_atk_component_set_layer (AtkComponent *component,
@@ -84,6 +95,13 @@ my_atk_component_get_extents (AtkComponent *component,
   *height = self->extent.height;
   *x = self->extent.x;
   *y = self->extent.y;
+
+  /* The first two are the position, whatever their names */
+  if (coord_type == ATK_XY_SCREEN)
+    {
+      *width += window_x;
+      *height += window_y;
+    }
 }
 
 static gboolean
@@ -104,6 +122,7 @@ my_atk_component_set_extents (AtkComponent *component,
       self->extent.height = height;
       self->extent.x = x;
       self->extent.y = y;
+      g_signal_emit_by_name (component, "bounds-changed", &self->extent);
       return TRUE;
     }
   return FALSE;
@@ -205,6 +224,36 @@ atk_component_interface_init (AtkComponentIface *iface)
   iface->get_alpha = my_atk_component_get_alpha;
 }
 
+static gint
+my_atk_component_action_get_n_actions (AtkAction *action)
+{
+  return 1;
+}
+
+static const gchar *
+my_atk_component_action_get_name (AtkAction *action, gint i)
+{
+  return (i == 0 ? "move_window" : NULL);
+}
+
+static gboolean
+my_atk_component_action_do_action (AtkAction *action, gint i)
+{
+  if (i != 0)
+    return FALSE;
+  window_x += 100;
+  window_y += 100;
+  return TRUE;
+}
+
+static void
+atk_action_interface_init (AtkActionIface *iface)
+{
+  iface->get_n_actions = my_atk_component_action_get_n_actions;
+  iface->get_name = my_atk_component_action_get_name;
+  iface->do_action = my_atk_component_action_do_action;
+}
+
 static void
 my_atk_component_initialize (AtkObject *obj, gpointer data)
 {
@@ -31,25 +31,60 @@
 typedef struct _MyAtkEditableTextInfo MyAtkEditableTextInfo;
 
 static void atk_editable_text_interface_init (AtkEditableTextIface *iface);
+static void atk_text_interface_init (AtkTextIface *iface);
 
 G_DEFINE_TYPE_WITH_CODE (MyAtkEditableText,
                          my_atk_editable_text,
                          MY_TYPE_ATK_OBJECT,
                          G_IMPLEMENT_INTERFACE (ATK_TYPE_EDITABLE_TEXT,
-                                                atk_editable_text_interface_init));
+                                                atk_editable_text_interface_init);
+                         G_IMPLEMENT_INTERFACE (ATK_TYPE_TEXT,
+                                                atk_text_interface_init));
 
 guint
 my_atk_set_editable_text (AtkEditableText *editable_text, const gchar *text)
 {
+  MyAtkEditableText *self = MY_ATK_EDITABLE_TEXT (editable_text);
+
   g_return_val_if_fail (MY_IS_ATK_EDITABLE_TEXT (editable_text), -1);
 
+  g_free (self->text);
+  self->text = g_strdup (text ? text : "");
   return 0;
 }
 
 static void
 my_atk_editable_text_init (MyAtkEditableText *obj)
 {
-  obj->text = NULL;
+  obj->text = g_strdup ("");
+  obj->clipboard = NULL;
+}
+
+/* Offsets are in characters; an end_pos of -1 means the end of the text */
+static gchar *
+my_atk_editable_text_get_text (AtkText *text, gint start_pos, gint end_pos)
+{
+  MyAtkEditableText *self = MY_ATK_EDITABLE_TEXT (text);
+  glong length = g_utf8_strlen (self->text, -1);
+
+  if (end_pos < 0 || end_pos > length)
+    end_pos = length;
+  if (start_pos < 0 || start_pos > end_pos)
+    return NULL;
+  return g_utf8_substring (self->text, start_pos, end_pos);
+}
+
+static gint
+my_atk_editable_text_get_character_count (AtkText *text)
+{
+  return g_utf8_strlen (MY_ATK_EDITABLE_TEXT (text)->text, -1);
+}
+
+static void
+atk_text_interface_init (AtkTextIface *iface)
+{
+  iface->get_text = my_atk_editable_text_get_text;
+  iface->get_character_count = my_atk_editable_text_get_character_count;
 }
 
 static gboolean
@@ -61,18 +96,75 @@ my_atk_set_editable_text_set_run_attributes (AtkEditableText *text,
   return FALSE;
 }
 
-static void
-my_atk_set_editable_text_set_text_contents (AtkEditableText *text,
-                                            const gchar *string)
-{
-}
-
 static void
 my_atk_set_editable_text_insert_text (AtkEditableText *text,
                                       const gchar *string,
                                       gint length,
                                       gint *position)
 {
+  MyAtkEditableText *self = MY_ATK_EDITABLE_TEXT (text);
+  GString *new_text;
+  gchar *inserted;
+  const gchar *p;
+  glong n_chars;
+
+  if (*position < 0 || *position > g_utf8_strlen (self->text, -1))
+    return;
+  inserted = g_strndup (string, length < 0 ? strlen (string) : (gsize) length);
+  n_chars = g_utf8_strlen (inserted, -1);
+  if (n_chars == 0)
+    {
+      g_free (inserted);
+      return;
+    }
+
+  p = g_utf8_offset_to_pointer (self->text, *position);
+  new_text = g_string_new_len (self->text, p - self->text);
+  g_string_append (new_text, inserted);
+  g_string_append (new_text, p);
+  g_free (self->text);
+  self->text = g_string_free (new_text, FALSE);
+
+  g_signal_emit_by_name (text, "text-insert", *position, (gint) n_chars, inserted);
+  *position += n_chars;
+  g_free (inserted);
+}
+
+static void
+my_atk_set_editable_text_delete_text (AtkEditableText *text,
+                                      gint start_pos,
+                                      gint end_pos)
+{
+  MyAtkEditableText *self = MY_ATK_EDITABLE_TEXT (text);
+  gchar *removed;
+  const gchar *p, *q;
+  gchar *new_text;
+
+  removed = my_atk_editable_text_get_text (ATK_TEXT (text), start_pos, end_pos);
+  if (!removed || !removed[0])
+    {
+      g_free (removed);
+      return;
+    }
+
+  p = g_utf8_offset_to_pointer (self->text, start_pos);
+  q = p + strlen (removed);
+  new_text = g_strdup_printf ("%.*s%s", (int) (p - self->text), self->text, q);
+  g_free (self->text);
+  self->text = new_text;
+
+  g_signal_emit_by_name (text, "text-remove", start_pos, (gint) g_utf8_strlen (removed, -1), removed);
+  g_free (removed);
+}
+
+static void
+my_atk_set_editable_text_set_text_contents (AtkEditableText *text,
+                                            const gchar *string)
+{
+  gint position = 0;
+
+  my_atk_set_editable_text_delete_text (text, 0, -1);
+  my_atk_set_editable_text_insert_text (text, string, -1, &position);
 }
 
 static void
@@ -80,6 +172,10 @@ my_atk_set_editable_text_copy_text (AtkEditableText *text,
                                     gint start_pos,
                                     gint end_pos)
 {
+  MyAtkEditableText *self = MY_ATK_EDITABLE_TEXT (text);
+
+  g_free (self->clipboard);
+  self->clipboard = my_atk_editable_text_get_text (ATK_TEXT (text), start_pos, end_pos);
 }
 
 static void
@@ -87,19 +183,18 @@ my_atk_set_editable_text_cut_text (AtkEditableText *text,
                                    gint start_pos,
                                    gint end_pos)
 {
-}
-
-static void
-my_atk_set_editable_text_delete_text (AtkEditableText *text,
-                                      gint start_pos,
-                                      gint end_pos)
-{
+  my_atk_set_editable_text_copy_text (text, start_pos, end_pos);
+  my_atk_set_editable_text_delete_text (text, start_pos, end_pos);
 }
 
 static void
 my_atk_set_editable_text_paste_text (AtkEditableText *text,
                                      gint position)
 {
+  MyAtkEditableText *self = MY_ATK_EDITABLE_TEXT (text);
+
+  if (self->clipboard)
+    my_atk_set_editable_text_insert_text (text, self->clipboard, -1, &position);
 }
 
 static void
@@ -124,6 +219,11 @@ my_atk_editable_text_initialize (AtkObject *obj, gpointer data)
 static void
 my_atk_editable_text_finalize (GObject *object)
 {
+  MyAtkEditableText *self = MY_ATK_EDITABLE_TEXT (object);
+
+  g_free (self->text);
+  g_free (self->clipboard);
+  G_OBJECT_CLASS (my_atk_editable_text_parent_class)->finalize (object);
 }
 
 static void
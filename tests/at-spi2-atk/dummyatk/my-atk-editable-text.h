@@ -45,6 +45,7 @@ struct _MyAtkEditableText
 {
   MyAtkObject parent;
   gchar *text;
+  gchar *clipboard;
 };
 
 struct _MyAtkEditableTextClass
@@ -50,6 +50,7 @@ my_atk_selection_add_selection (AtkSelection *selection, gint i)
   AtkObject *child = atk_object_ref_accessible_child (ATK_OBJECT (selection), i);
   AtkStateSet *ss = atk_object_ref_state_set (child);
   atk_state_set_add_state (ss, ATK_STATE_SELECTED);
+  g_signal_emit_by_name (selection, "selection-changed");
   return atk_state_set_contains_state (ss, ATK_STATE_SELECTED);
 }
 
@@ -70,6 +71,7 @@ my_atk_selection_clear_selection (AtkSelection *selection)
       states = atk_object_ref_state_set (child);
       atk_state_set_remove_state (states, ATK_STATE_SELECTED);
     }
+  g_signal_emit_by_name (selection, "selection-changed");
   return TRUE;
 }
 
@@ -163,6 +165,7 @@ my_atk_selection_remove_selection (AtkSelection *selection, gint no)
   atk_state_set_remove_state (states, ATK_STATE_SELECTED);
 
   ret = !atk_state_set_contains_state (states, ATK_STATE_SELECTED);
+  g_signal_emit_by_name (selection, "selection-changed");
   g_object_unref (states);
   g_object_unref (o);
   g_object_unref (self);
@@ -193,6 +196,7 @@ my_atk_selection_select_all_selection (AtkSelection *selection)
       g_object_unref (child);
     }
 
+  g_signal_emit_by_name (selection, "selection-changed");
   g_object_unref (self);
   return TRUE;
 }
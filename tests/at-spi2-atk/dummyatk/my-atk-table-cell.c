@@ -87,12 +87,27 @@ my_atk_tablecell_get_row_column_span (AtkTableCell *obj, gint *row, gint *col, g
   return TRUE;
 }
 
+/* The header cells of a cell of a grid table are just its own row or column header */
+static GPtrArray *
+grid_header_cells (AtkObject *header)
+{
+  GPtrArray *ret = g_ptr_array_new_full (1, g_object_unref);
+
+  if (header)
+    g_ptr_array_add (ret, g_object_ref (header));
+  return ret;
+}
+
 static GPtrArray *
 my_atk_tablecell_get_column_header_cells (AtkTableCell *obj)
 {
   g_return_val_if_fail (MY_IS_ATK_TABLE_CELL (obj), FALSE);
   MyAtkTable *tab = MY_ATK_TABLE (atk_object_get_parent (ATK_OBJECT (obj)));
 
+  if (tab->grid_rows)
+    return grid_header_cells (atk_table_get_column_header (ATK_TABLE (tab),
+                                                           MY_ATK_TABLE_CELL (obj)->x));
+
   gint i, all_child;
   all_child = MY_ATK_OBJECT (tab)->children->len;
   AtkObject *child = NULL;
@@ -144,6 +159,10 @@ my_atk_tablecell_get_row_header_cells (AtkTableCell *obj)
   g_return_val_if_fail (MY_IS_ATK_TABLE_CELL (obj), FALSE);
   MyAtkTable *tab = MY_ATK_TABLE (atk_object_get_parent (ATK_OBJECT (obj)));
 
+  if (tab->grid_rows)
+    return grid_header_cells (atk_table_get_row_header (ATK_TABLE (tab),
+                                                        MY_ATK_TABLE_CELL (obj)->y));
+
   gint i, all_child;
   all_child = MY_ATK_OBJECT (tab)->children->len;
   AtkObject *child = NULL;
@@ -30,18 +30,261 @@ typedef struct _MyAtkTableInfo MyAtkTableInfo;
 
 static void GDestroyNotifyGPTRARRAYptrArray (gpointer data);
 static void atk_table_interface_init (AtkTableIface *iface);
+static void atk_action_interface_init (AtkActionIface *iface);
 
 G_DEFINE_TYPE_WITH_CODE (MyAtkTable,
                          my_atk_table,
                          MY_TYPE_ATK_OBJECT,
                          G_IMPLEMENT_INTERFACE (ATK_TYPE_TABLE,
-                                                atk_table_interface_init));
+                                                atk_table_interface_init);
+                         G_IMPLEMENT_INTERFACE (ATK_TYPE_ACTION,
+                                                atk_action_interface_init));
+
+/*
+ * Grid tables.
+ *
+ * A table made a grid with my_atk_table_set_grid() has no cell children.
+ * Like the virtualized tables of real toolkits, it manages its descendants
+ * and creates a new cell object whenever one is asked for, so that it can
+ * have millions of cells. Its headers are created up front but are not
+ * children either, and all lookups are constant time, so that benchmarks
+ * measure the bridge rather than the dummy implementation.
+ */
+
+static AtkObject *
+grid_header_new (MyAtkTable *self, AtkRole role, const gchar *kind, gint index)
+{
+  gchar *name = g_strdup_printf ("%s %d header", kind, index);
+  AtkObject *header = g_object_new (MY_TYPE_ATK_OBJECT,
+                                    "accessible-name", name,
+                                    "accessible-role", role,
+                                    NULL);
+
+  atk_object_set_parent (header, ATK_OBJECT (self));
+  g_free (name);
+  return header;
+}
+
+/*
+ * Makes the table a grid of n_rows by n_columns cells. If row_span is
+ * greater than 1, the cells of the first column span that many rows. If
+ * selected_step is greater than 0, every selected_step-th row starts out
+ * selected.
+ */
+void
+my_atk_table_set_grid (AtkTable *obj,
+                       gint n_rows,
+                       gint n_columns,
+                       gint row_span,
+                       gint selected_step)
+{
+  MyAtkTable *self = MY_ATK_TABLE (obj);
+  AtkStateSet *ss;
+  gint i;
+
+  g_return_if_fail (MY_IS_ATK_TABLE (obj));
+  g_return_if_fail (n_rows > 0 && n_columns > 0);
+
+  self->grid_rows = n_rows;
+  self->grid_columns = n_columns;
+  self->grid_row_span = MAX (row_span, 1);
+
+  self->grid_row_headers = g_ptr_array_new_full (n_rows, g_object_unref);
+  for (i = 0; i < n_rows; i++)
+    g_ptr_array_add (self->grid_row_headers,
+                     grid_header_new (self, ATK_ROLE_ROW_HEADER, "row", i));
+  self->grid_column_headers = g_ptr_array_new_full (n_columns, g_object_unref);
+  for (i = 0; i < n_columns; i++)
+    g_ptr_array_add (self->grid_column_headers,
+                     grid_header_new (self, ATK_ROLE_COLUMN_HEADER, "column", i));
+
+  self->grid_selected_rows = g_new0 (gboolean, n_rows);
+  self->grid_selected_columns = g_new0 (gboolean, n_columns);
+  for (i = 0; selected_step > 0 && i < n_rows; i += selected_step)
+    self->grid_selected_rows[i] = TRUE;
+
+  ss = atk_object_ref_state_set (ATK_OBJECT (obj));
+  atk_state_set_add_state (ss, ATK_STATE_MANAGES_DESCENDANTS);
+  g_object_unref (ss);
+}
+
+static gint
+grid_first_row (MyAtkTable *self, gint row, gint column)
+{
+  if (column == 0)
+    return row - row % self->grid_row_span;
+  return row;
+}
+
+static gint
+grid_row_span (MyAtkTable *self, gint row, gint column)
+{
+  if (column == 0)
+    return MIN (self->grid_row_span, self->grid_rows - grid_first_row (self, row, column));
+  return 1;
+}
+
+static gboolean
+grid_contains (MyAtkTable *self, gint row, gint column)
+{
+  return (row >= 0 && row < self->grid_rows &&
+          column >= 0 && column < self->grid_columns);
+}
+
+static gboolean
+grid_is_selected (MyAtkTable *self, gint row, gint column)
+{
+  return self->grid_selected_rows[row] || self->grid_selected_columns[column];
+}
+
+/*
+ * Makes a grid table keep the cells it creates, and return the same cell
+ * object every time one is asked for, rather than a new one. Only then can
+ * rows be inserted with my_atk_table_grid_insert_row(), moving the cells
+ * below them.
+ */
+void
+my_atk_table_grid_keep_cells (AtkTable *obj)
+{
+  MyAtkTable *self = MY_ATK_TABLE (obj);
+
+  g_return_if_fail (MY_IS_ATK_TABLE (obj) && self->grid_rows);
+
+  if (!self->grid_cells)
+    self->grid_cells = g_hash_table_new_full (NULL, NULL, NULL, g_object_unref);
+}
+
+static gpointer
+grid_cell_key (MyAtkTable *self, gint row, gint column)
+{
+  return GINT_TO_POINTER (row * self->grid_columns + column);
+}
+
+static void
+grid_cell_move (MyAtkTableCell *cell, gint row, gint column)
+{
+  my_atk_set_table_cell (ATK_TABLE_CELL (cell), column, row, cell->row_span, cell->column_span);
+  cell->xy[0] = row;
+  cell->xy[1] = column;
+}
+
+/*
+ * Inserts an empty row before row in a grid table that keeps its cells,
+ * moving the cells below it down, and emits row-inserted. The cells of the
+ * first column must not span several rows.
+ */
+gboolean
+my_atk_table_grid_insert_row (AtkTable *obj, gint row)
+{
+  MyAtkTable *self = MY_ATK_TABLE (obj);
+  GHashTable *cells;
+  GHashTableIter iter;
+  gpointer value;
+  gint i;
+
+  g_return_val_if_fail (MY_IS_ATK_TABLE (obj), FALSE);
+  if (!self->grid_cells || self->grid_row_span > 1 || row < 0 || row > self->grid_rows)
+    return FALSE;
+
+  self->grid_rows++;
+  cells = g_hash_table_new_full (NULL, NULL, NULL, g_object_unref);
+  g_hash_table_iter_init (&iter, self->grid_cells);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+      MyAtkTableCell *cell = value;
+      gint cell_row = cell->xy[0], cell_column = cell->xy[1];
+
+      if (cell_row >= row)
+        grid_cell_move (cell, ++cell_row, cell_column);
+      g_hash_table_insert (cells, grid_cell_key (self, cell_row, cell_column), g_object_ref (cell));
+    }
+  g_hash_table_unref (self->grid_cells);
+  self->grid_cells = cells;
+
+  g_ptr_array_add (self->grid_row_headers,
+                   grid_header_new (self, ATK_ROLE_ROW_HEADER, "row", self->grid_rows - 1));
+  self->grid_selected_rows = g_renew (gboolean, self->grid_selected_rows, self->grid_rows);
+  for (i = self->grid_rows - 1; i > row; i--)
+    self->grid_selected_rows[i] = self->grid_selected_rows[i - 1];
+  self->grid_selected_rows[row] = FALSE;
+
+  g_signal_emit_by_name (obj, "row-inserted", row, 1);
+  return TRUE;
+}
+
+static AtkObject *
+grid_ref_at (MyAtkTable *self, gint row, gint column)
+{
+  MyAtkTableCell *cell;
+  gint first_row, xy[2];
+  gchar *name;
+
+  if (!grid_contains (self, row, column))
+    return NULL;
+
+  first_row = grid_first_row (self, row, column);
+  if (self->grid_cells)
+    {
+      cell = g_hash_table_lookup (self->grid_cells, grid_cell_key (self, first_row, column));
+      if (cell)
+        return g_object_ref (ATK_OBJECT (cell));
+    }
+  name = g_strdup_printf ("cell %d/%d", column, first_row);
+  cell = g_object_new (MY_TYPE_ATK_TABLE_CELL,
+                       "accessible-name", name,
+                       "accessible-role", ATK_ROLE_TABLE_CELL,
+                       NULL);
+  g_free (name);
+
+  my_atk_set_table_cell (ATK_TABLE_CELL (cell), column, first_row,
+                         grid_row_span (self, row, column), 1);
+  xy[0] = first_row;
+  xy[1] = column;
+  my_atk_set_tablecell (cell, NULL, NULL, MY_ATK_OBJECT (self), FALSE, xy);
+  if (grid_is_selected (self, first_row, column))
+    atk_state_set_add_state (MY_ATK_OBJECT (cell)->state_set, ATK_STATE_SELECTED);
+  atk_object_set_parent (ATK_OBJECT (cell), ATK_OBJECT (self));
+  if (self->grid_cells)
+    g_hash_table_insert (self->grid_cells, grid_cell_key (self, first_row, column), g_object_ref (cell));
+
+  return ATK_OBJECT (cell);
+}
+
+static gint
+grid_get_selected (gboolean *selected, gint n, gint **indices)
+{
+  GArray *array = g_array_new (FALSE, FALSE, sizeof (gint));
+  gint i, ret;
+
+  for (i = 0; i < n; i++)
+    if (selected[i])
+      g_array_append_val (array, i);
+
+  ret = array->len;
+  if (indices)
+    *indices = (gint *) g_array_free (array, FALSE);
+  else
+    g_array_free (array, TRUE);
+  return ret;
+}
+
+static gboolean
+grid_set_selected (gboolean *selected, gint n, gint index, gboolean value)
+{
+  if (index < 0 || index >= n || selected[index] == value)
+    return FALSE;
+  selected[index] = value;
+  return TRUE;
+}
 
 static gint
 my_atk_table_get_index_at (AtkTable *obj, gint row, gint column)
 {
   MyAtkTable *self = MY_ATK_TABLE (obj);
   g_return_val_if_fail (MY_IS_ATK_TABLE (obj), -1);
+  if (self->grid_rows)
+    return (grid_contains (self, row, column) ? row * self->grid_columns + column : -1);
+
   gint i, all_child, index_first_cell = -1;
   gint ret = -1;
 
@@ -73,6 +316,9 @@ my_atk_table_get_column_at_index (AtkTable *obj, gint index)
 {
   MyAtkTable *table = MY_ATK_TABLE (obj);
   g_return_val_if_fail (MY_IS_ATK_TABLE (obj), -1);
+  if (table->grid_rows)
+    return (index >= 0 && index < table->grid_rows * table->grid_columns ? index % table->grid_columns : -1);
+
   gint columns = -1;
   gint rows = -1;
   gint i, j;
@@ -96,6 +342,9 @@ my_atk_table_get_row_at_index (AtkTable *obj, gint index)
 {
   MyAtkTable *table = MY_ATK_TABLE (obj);
   g_return_val_if_fail (MY_IS_ATK_TABLE (obj), -1);
+  if (table->grid_rows)
+    return (index >= 0 && index < table->grid_rows * table->grid_columns ? index / table->grid_columns : -1);
+
   gint columns = -1;
   gint rows = -1;
   gint i, j;
@@ -120,6 +369,9 @@ my_atk_table_get_n_columns (AtkTable *obj)
 {
   MyAtkTable *self = MY_ATK_TABLE (obj);
   g_return_val_if_fail (MY_IS_ATK_TABLE (obj), -1);
+  if (self->grid_rows)
+    return self->grid_columns;
+
   gint i, all_child, ret = 0;
 
   all_child = MY_ATK_OBJECT (self)->children->len;
@@ -138,6 +390,9 @@ my_atk_table_get_n_rows (AtkTable *obj)
 {
   MyAtkTable *self = MY_ATK_TABLE (obj);
   g_return_val_if_fail (MY_IS_ATK_TABLE (obj), -1);
+  if (self->grid_rows)
+    return self->grid_rows;
+
   gint i, all_child, ret = 0;
 
   all_child = MY_ATK_OBJECT (self)->children->len;
@@ -176,6 +431,9 @@ my_atk_table_ref_at (AtkTable *obj, gint row, gint column)
 {
   MyAtkTable *self = MY_ATK_TABLE (obj);
   g_return_val_if_fail (MY_IS_ATK_TABLE (obj), NULL);
+  if (self->grid_rows)
+    return grid_ref_at (self, row, column);
+
   gint i, all_child;
   AtkObject *ret = NULL;
 
@@ -201,6 +459,9 @@ my_atk_table_get_row_description (AtkTable *obj, gint index)
 {
   MyAtkTable *self = MY_ATK_TABLE (obj);
   g_return_val_if_fail (MY_IS_ATK_TABLE (obj), NULL);
+  if (self->grid_rows)
+    return NULL;
+
   gint i, all_child;
   GPtrArray *ret = g_ptr_array_new_full (my_atk_table_get_n_rows (obj),
                                          g_object_unref);
@@ -224,6 +485,9 @@ my_atk_table_get_column_description (AtkTable *obj, gint index)
 {
   MyAtkTable *self = MY_ATK_TABLE (obj);
   g_return_val_if_fail (MY_IS_ATK_TABLE (obj), NULL);
+  if (self->grid_rows)
+    return NULL;
+
   gint i, all_child;
   GPtrArray *ret = g_ptr_array_new_full (my_atk_table_get_n_columns (obj), g_object_unref);
 
@@ -244,6 +508,10 @@ my_atk_table_get_column_description (AtkTable *obj, gint index)
 static gint
 my_atk_table_test_table_get_row_extent_at (AtkTable *obj, gint row, gint col)
 {
+  MyAtkTable *table = MY_ATK_TABLE (obj);
+  if (table->grid_rows)
+    return (grid_contains (table, row, col) ? grid_row_span (table, row, col) : 0);
+
   AtkObject *cell = my_atk_table_ref_at (obj, row, col);
 
   MyAtkTableCell *self = MY_ATK_TABLE_CELL (cell);
@@ -254,6 +522,10 @@ my_atk_table_test_table_get_row_extent_at (AtkTable *obj, gint row, gint col)
 static gint
 my_atk_table_test_table_get_column_extent_at (AtkTable *obj, gint row, gint col)
 {
+  MyAtkTable *table = MY_ATK_TABLE (obj);
+  if (table->grid_rows)
+    return (grid_contains (table, row, col) ? 1 : 0);
+
   AtkObject *cell = my_atk_table_ref_at (obj, row, col);
 
   MyAtkTableCell *self = MY_ATK_TABLE_CELL (cell);
@@ -266,6 +538,9 @@ my_atk_table_get_row_header (AtkTable *obj, gint row)
 {
   MyAtkTable *self = MY_ATK_TABLE (obj);
   g_return_val_if_fail (MY_IS_ATK_TABLE (obj), NULL);
+  if (self->grid_rows)
+    return (row >= 0 && row < self->grid_rows ? g_ptr_array_index (self->grid_row_headers, row) : NULL);
+
   gint i, all_child;
   GPtrArray *ret = g_ptr_array_new_full (my_atk_table_get_n_rows (obj), g_object_unref);
 
@@ -289,6 +564,9 @@ my_atk_table_get_column_header (AtkTable *obj, gint col)
 {
   MyAtkTable *self = MY_ATK_TABLE (obj);
   g_return_val_if_fail (MY_IS_ATK_TABLE (obj), NULL);
+  if (self->grid_rows)
+    return (col >= 0 && col < self->grid_columns ? g_ptr_array_index (self->grid_column_headers, col) : NULL);
+
   gint i, all_child;
   GPtrArray *ret = g_ptr_array_new_full (my_atk_table_get_n_rows (obj), g_object_unref);
 
@@ -312,6 +590,9 @@ my_atk_table_get_selected_rows (AtkTable *obj, gint **selected)
 {
   MyAtkTable *self = MY_ATK_TABLE (obj);
   g_return_val_if_fail (MY_IS_ATK_TABLE (obj), -1);
+  if (self->grid_rows)
+    return grid_get_selected (self->grid_selected_rows, self->grid_rows, selected);
+
   gint i, all_child, row = 0, ret = 0;
   AtkObject *child = NULL;
   AtkStateSet *ss = NULL;
@@ -343,6 +624,9 @@ my_atk_table_get_selected_columns (AtkTable *obj, gint **selected)
 {
   MyAtkTable *self = MY_ATK_TABLE (obj);
   g_return_val_if_fail (MY_IS_ATK_TABLE (obj), -1);
+  if (self->grid_rows)
+    return grid_get_selected (self->grid_selected_columns, self->grid_columns, selected);
+
   gint i, all_child, column = 0, ret = 0;
   AtkObject *child = NULL;
   AtkStateSet *ss = NULL;
@@ -374,6 +658,9 @@ my_atk_table_is_row_selected (AtkTable *obj, gint row)
 {
   MyAtkTable *self = MY_ATK_TABLE (obj);
   g_return_val_if_fail (MY_IS_ATK_TABLE (obj), FALSE);
+  if (self->grid_rows)
+    return (row >= 0 && row < self->grid_rows && self->grid_selected_rows[row]);
+
   gint i, all_child;
   AtkObject *child = NULL;
   AtkObject *c = NULL;
@@ -399,6 +686,9 @@ my_atk_table_is_column_selected (AtkTable *obj, gint col)
 {
   MyAtkTable *self = MY_ATK_TABLE (obj);
   g_return_val_if_fail (MY_IS_ATK_TABLE (obj), FALSE);
+  if (self->grid_rows)
+    return (col >= 0 && col < self->grid_columns && self->grid_selected_columns[col]);
+
   gint i, all_child;
   AtkObject *child = NULL;
   AtkObject *c = NULL;
@@ -422,6 +712,11 @@ my_atk_table_is_column_selected (AtkTable *obj, gint col)
 static gboolean
 my_atk_table_is_selected (AtkTable *obj, gint row, gint col)
 {
+  MyAtkTable *table = MY_ATK_TABLE (obj);
+  if (table->grid_rows)
+    return (grid_contains (table, row, col) &&
+            grid_is_selected (table, grid_first_row (table, row, col), col));
+
   AtkObject *cell = atk_table_ref_at (obj, row, col);
   AtkStateSet *ss = atk_object_ref_state_set (cell);
   gboolean ret = FALSE;
@@ -436,6 +731,9 @@ my_atk_table_add_column_selection (AtkTable *obj, gint col)
 {
   MyAtkTable *self = MY_ATK_TABLE (obj);
   g_return_val_if_fail (MY_IS_ATK_TABLE (obj), FALSE);
+  if (self->grid_rows)
+    return grid_set_selected (self->grid_selected_columns, self->grid_columns, col, TRUE);
+
   gint i, all_child, counter = 0;
   AtkObject *child = NULL;
   AtkStateSet *ss = NULL;
@@ -466,6 +764,9 @@ my_atk_table_add_row_selection (AtkTable *obj, gint row)
 {
   MyAtkTable *self = MY_ATK_TABLE (obj);
   g_return_val_if_fail (MY_IS_ATK_TABLE (obj), FALSE);
+  if (self->grid_rows)
+    return grid_set_selected (self->grid_selected_rows, self->grid_rows, row, TRUE);
+
   gint i, all_child, counter = 0;
   AtkObject *child = NULL;
   AtkStateSet *ss = NULL;
@@ -496,6 +797,9 @@ my_atk_table_remove_column_selection (AtkTable *obj, gint col)
 {
   MyAtkTable *self = MY_ATK_TABLE (obj);
   g_return_val_if_fail (MY_IS_ATK_TABLE (obj), FALSE);
+  if (self->grid_rows)
+    return grid_set_selected (self->grid_selected_columns, self->grid_columns, col, FALSE);
+
   gint i, all_child, counter = 0;
   AtkObject *child = NULL;
   AtkStateSet *ss = NULL;
@@ -526,6 +830,9 @@ my_atk_table_remove_row_selection (AtkTable *obj, gint row)
 {
   MyAtkTable *self = MY_ATK_TABLE (obj);
   g_return_val_if_fail (MY_IS_ATK_TABLE (obj), FALSE);
+  if (self->grid_rows)
+    return grid_set_selected (self->grid_selected_rows, self->grid_rows, row, FALSE);
+
   gint i, all_child, counter = 0;
   AtkObject *child = NULL;
   AtkStateSet *ss = NULL;
@@ -684,6 +991,33 @@ atk_table_interface_init (AtkTableIface *iface)
   iface->model_changed = my_atk_table_model_changed;
 }
 
+/* Grid tables that keep their cells can have rows inserted at the top */
+static gint
+my_atk_table_action_get_n_actions (AtkAction *action)
+{
+  return (MY_ATK_TABLE (action)->grid_cells ? 1 : 0);
+}
+
+static const gchar *
+my_atk_table_action_get_name (AtkAction *action, gint i)
+{
+  return (i == 0 && MY_ATK_TABLE (action)->grid_cells ? "insert_row" : NULL);
+}
+
+static gboolean
+my_atk_table_action_do_action (AtkAction *action, gint i)
+{
+  return (i == 0 && my_atk_table_grid_insert_row (ATK_TABLE (action), 0));
+}
+
+static void
+atk_action_interface_init (AtkActionIface *iface)
+{
+  iface->get_n_actions = my_atk_table_action_get_n_actions;
+  iface->get_name = my_atk_table_action_get_name;
+  iface->do_action = my_atk_table_action_do_action;
+}
+
 static void
 my_atk_table_init (MyAtkTable *self)
 {
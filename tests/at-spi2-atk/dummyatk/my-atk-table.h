@@ -46,6 +46,14 @@ struct _MyAtkTable
   GPtrArray *row_header;
   gchar *col_desc;
   gboolean selected;
+  gint grid_rows;
+  gint grid_columns;
+  gint grid_row_span;
+  GPtrArray *grid_row_headers;
+  GPtrArray *grid_column_headers;
+  gboolean *grid_selected_rows;
+  gboolean *grid_selected_columns;
+  GHashTable *grid_cells;
 };
 
 struct _MyAtkTableClass
@@ -67,4 +75,14 @@ guint my_atk_set_table (AtkTable *obj,
 AtkObject *
 test_get_cell_from_table (AtkTable *obj, gint row);
 
+void my_atk_table_set_grid (AtkTable *obj,
+                            gint n_rows,
+                            gint n_columns,
+                            gint row_span,
+                            gint selected_step);
+
+void my_atk_table_grid_keep_cells (AtkTable *obj);
+
+gboolean my_atk_table_grid_insert_row (AtkTable *obj, gint row);
+
 #endif /* MY_ATK_TABLE_H_ */
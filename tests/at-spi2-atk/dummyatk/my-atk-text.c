@@ -68,6 +68,19 @@ my_atk_set_text (AtkText *obj,
   return 0;
 }
 
+/*
+ * Splits the text into attribute runs of run_length characters, alternating
+ * between bold and normal weight. A run length of 0 restores the fixed run
+ * the tests expect.
+ */
+void
+my_atk_text_set_run_length (AtkText *obj, gint run_length)
+{
+  g_return_if_fail (MY_IS_ATK_TEXT (obj));
+
+  MY_ATK_TEXT (obj)->run_length = run_length;
+}
+
 MyAtkText *
 my_atk_text_new (void)
 {
@@ -80,6 +93,8 @@ my_atk_text_get_text (AtkText *obj, gint start_offset, gint end_offset)
   g_return_val_if_fail (MY_IS_ATK_TEXT (obj), NULL);
   gchar *str = MY_ATK_TEXT (obj)->text;
 
+  if (str && end_offset == -1)
+    end_offset = strlen (str);
   if ((end_offset < start_offset) || start_offset < 0 || !str)
     return NULL;
   if (strlen (str) < end_offset)
@@ -249,9 +264,25 @@ static AtkAttributeSet *
 my_atk_text_get_run_attributes (AtkText *obj, gint offset, gint *start_offset, gint *end_offset)
 {
   g_return_val_if_fail (MY_IS_ATK_TEXT (obj), NULL);
+  MyAtkText *self = MY_ATK_TEXT (obj);
   AtkAttributeSet *attributes;
   AtkAttribute *attr;
 
+  if (self->run_length > 0)
+    {
+      gint run = offset / self->run_length;
+
+      attr = g_malloc (sizeof (AtkAttribute));
+      attr->name = g_strdup ("weight");
+      attr->value = g_strdup ((run % 2) ? "700" : "400");
+      attributes = g_slist_append (NULL, attr);
+
+      *start_offset = run * self->run_length;
+      *end_offset = MIN (*start_offset + self->run_length,
+                         my_atk_text_get_character_count (obj));
+      return attributes;
+    }
+
   attr = g_malloc (sizeof (AtkAttribute));
   attr->name = g_strdup ("text_test_attr1");
   attr->value = g_strdup ("on");
@@ -440,6 +471,7 @@ my_atk_text_init (MyAtkText *self)
   self->height = -1;
   self->selection = NULL;
   self->attributes = NULL;
+  self->run_length = 0;
 }
 
 static void
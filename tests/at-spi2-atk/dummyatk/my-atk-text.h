@@ -51,6 +51,7 @@ struct _MyAtkText
   gint height;
   GList *selection;
   AtkAttributeSet *attributes;
+  gint run_length;
 };
 
 struct _MyAtkTextClass
@@ -68,6 +69,8 @@ guint my_atk_set_text (AtkText *obj,
                        const gint height,
                        AtkAttributeSet *attrSet);
 
+void my_atk_text_set_run_length (AtkText *obj, gint run_length);
+
 MyAtkText *my_atk_text_new (void);
 
 #endif /* MY_ATK_TEXT_H_ */
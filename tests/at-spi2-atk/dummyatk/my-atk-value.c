@@ -91,8 +91,11 @@ my_atk_value_set_value (AtkValue *obj, const gdouble val)
   MyAtkValue *self = MY_ATK_VALUE (obj);
   g_return_if_fail (MY_IS_ATK_VALUE (obj));
 
-  if (self->min < val && val < self->max)
-    self->cur = val;
+  if (self->min < val && val < self->max && val != self->cur)
+    {
+      self->cur = val;
+      g_object_notify (G_OBJECT (obj), "accessible-value");
+    }
   return;
 }
 
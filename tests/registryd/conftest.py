@@ -21,9 +21,23 @@
 #
 # * registry - A dbus.proxies.ProxyObject for the registry's root object.  This automatically
 #   depends on a session_manager fixture to control its lifetime.
+#
+# * window_app - A StubApplication with two toplevel windows, embedded in the registry.  The
+#   first window is at (0, 0) and the second at (50, 50), both 100x100 pixels; the registry
+#   has asked both for their extents by the time the fixture is set up.
 
 import pytest
 import dbus
+import dbus.service
+import time
+
+ACCESSIBLE_IFACE = 'org.a11y.atspi.Accessible'
+COMPONENT_IFACE = 'org.a11y.atspi.Component'
+SOCKET_IFACE = 'org.a11y.atspi.Socket'
+WINDOW_EVENT_IFACE = 'org.a11y.atspi.Event.Window'
+
+ROOT_PATH = '/org/a11y/atspi/accessible/root'
+COORD_TYPE_SCREEN = 0
 
 @pytest.fixture
 def main_loop():
@@ -86,3 +100,100 @@ def registry_registry(main_loop, session_manager):
     a11y_bus = dbus.bus.BusConnection(a11y_address)
 
     return a11y_bus.get_object('org.a11y.atspi.Registry', '/org/a11y/atspi/registry')
+
+def run_until(condition, timeout=5):
+    from gi.repository import GLib
+
+    context = GLib.MainContext.default()
+    deadline = time.monotonic() + timeout
+    while not condition():
+        assert time.monotonic() < deadline, 'timed out'
+        if not context.iteration(False):
+            time.sleep(0.01)
+
+class StubWindow(dbus.service.Object):
+    """A toplevel window, which gives its extents and emits window events."""
+
+    def __init__(self, bus, path, extents):
+        super().__init__(bus, path)
+        self.path = path
+        self.extents = extents
+        self.n_get_extents = 0
+
+    @dbus.service.method(COMPONENT_IFACE, in_signature='u', out_signature='(iiii)')
+    def GetExtents(self, coord_type):
+        self.n_get_extents += 1
+        return dbus.Struct(self.extents, signature='iiii')
+
+    @dbus.service.signal(WINDOW_EVENT_IFACE, signature='siiva{sv}')
+    def Activate(self, minor, detail1, detail2, any_data, properties):
+        pass
+
+    @dbus.service.signal(WINDOW_EVENT_IFACE, signature='siiva{sv}')
+    def Minimize(self, minor, detail1, detail2, any_data, properties):
+        pass
+
+    @dbus.service.signal(WINDOW_EVENT_IFACE, signature='siiva{sv}')
+    def Restore(self, minor, detail1, detail2, any_data, properties):
+        pass
+
+    @dbus.service.signal(WINDOW_EVENT_IFACE, signature='siiva{sv}')
+    def Destroy(self, minor, detail1, detail2, any_data, properties):
+        pass
+
+    def emit(self, event):
+        getattr(self, event)('', 0, 0, dbus.Int32(0, variant_level=1),
+                             dbus.Dictionary({}, signature='sv'))
+
+class StubApplication(dbus.service.Object):
+    """The root of an application with the given toplevel windows.
+
+    Calls to the registry are made on the application's own connection, so
+    that they reach the registry after the events the application emitted.
+    """
+
+    def __init__(self, bus, window_extents):
+        super().__init__(bus, ROOT_PATH)
+        self.bus = bus
+        self.windows = [StubWindow(bus, '/org/a11y/atspi/accessible/%d' % (i + 1), extents)
+                        for (i, extents) in enumerate(window_extents)]
+        self.registry = bus.get_object('org.a11y.atspi.Registry', ROOT_PATH)
+
+    @dbus.service.method(ACCESSIBLE_IFACE, in_signature='', out_signature='a(so)')
+    def GetChildren(self):
+        return [(self.bus.get_unique_name(), dbus.ObjectPath(window.path))
+                for window in self.windows]
+
+    def embed(self):
+        reference = dbus.Struct((self.bus.get_unique_name(), dbus.ObjectPath(ROOT_PATH)),
+                                signature='so')
+        self.registry.Embed(reference, dbus_interface=SOCKET_IFACE)
+
+    def hit_test(self, x, y):
+        """Returns the path of the accessible that the registry finds at the point."""
+        result = {}
+
+        self.registry.GetAccessibleAtPoint(x, y, COORD_TYPE_SCREEN,
+                                           dbus_interface=COMPONENT_IFACE,
+                                           reply_handler=lambda ref: result.update(ref=ref),
+                                           error_handler=lambda e: result.update(error=e))
+        run_until(lambda: result)
+        if 'error' in result:
+            raise result['error']
+        (name, path) = result['ref']
+        return str(path)
+
+@pytest.fixture
+def window_app(main_loop, session_manager):
+    a11y_address = get_accesssibility_bus_address()
+    a11y_bus = dbus.bus.BusConnection(a11y_address)
+
+    app = StubApplication(a11y_bus, [(0, 0, 100, 100), (50, 50, 100, 100)])
+    app.embed()
+
+    # The registry lists the windows, then asks each of them for its extents
+    run_until(lambda: all(window.n_get_extents for window in app.windows))
+
+    yield app
+
+    a11y_bus.close()
@@ -0,0 +1,59 @@
+# Tests for the registry's window map, which answers GetAccessibleAtPoint on
+# the desktop with the topmost toplevel window at the point.  The window_app
+# fixture in conftest.py provides an application with two overlapping windows.
+
+import pytest
+import dbus
+
+REGISTRY_IFACE = 'org.a11y.atspi.Registry'
+
+NULL_PATH = '/org/a11y/atspi/null'
+
+def test_hit_test_finds_topmost_window(window_app):
+    (first, second) = window_app.windows
+
+    assert window_app.hit_test(25, 25) == first.path
+    assert window_app.hit_test(75, 75) == first.path
+    assert window_app.hit_test(125, 125) == second.path
+    assert window_app.hit_test(500, 500) == NULL_PATH
+
+def test_activate_raises_window(window_app):
+    (first, second) = window_app.windows
+
+    second.emit('Activate')
+    assert window_app.hit_test(75, 75) == second.path
+    assert window_app.hit_test(25, 25) == first.path
+
+def test_minimized_window_is_skipped(window_app):
+    (first, second) = window_app.windows
+
+    first.emit('Minimize')
+    assert window_app.hit_test(25, 25) == NULL_PATH
+    assert window_app.hit_test(75, 75) == second.path
+
+    first.emit('Restore')
+    assert window_app.hit_test(25, 25) == first.path
+
+def test_moved_window_is_confirmed(window_app):
+    (first, second) = window_app.windows
+
+    # Windows can move without any event; the registry asks before answering
+    first.extents = (200, 200, 100, 100)
+    assert window_app.hit_test(25, 25) == NULL_PATH
+    assert window_app.hit_test(75, 75) == second.path
+    assert window_app.hit_test(250, 250) == first.path
+
+def test_destroyed_window_is_removed(window_app):
+    (first, second) = window_app.windows
+
+    first.emit('Destroy')
+    assert window_app.hit_test(25, 25) == NULL_PATH
+    assert window_app.hit_test(75, 75) == second.path
+
+def test_registry_listens_to_used_window_events(registry_registry):
+    events = registry_registry.GetRegisteredEvents(dbus_interface=REGISTRY_IFACE)
+    window_events = sorted(str(event) for (bus_name, event) in events
+                           if str(event).startswith('Window:'))
+
+    assert window_events == ['Window:Activate:', 'Window:Create:', 'Window:Destroy:',
+                             'Window:Maximize:', 'Window:Minimize:', 'Window:Restore:']
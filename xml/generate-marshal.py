@@ -0,0 +1,244 @@
+#!/usr/bin/env python3
+#
+# Takes DBus XML files and writes out a spi-marshal.h file with type-specialized
+# functions to marshal and demarshal the arguments of methods that are all of
+# basic types, for use in place of the varargs
+# dbus_message_get_args / dbus_message_append_args and dbind signature strings.
+#
+# For a method Interface.Method taking (in) and returning (out), it defines
+# for the adaptor those of the following whose arguments are all of basic
+# types:
+#
+#   spi_demarshal_Interface_Method (message, in *...)
+#       reads the arguments of a method call, returning FALSE if they are of
+#       the wrong types;
+#   spi_marshal_Interface_Method_reply (message, out...)
+#       creates the reply to a method call;
+#
+# and, when all the arguments are of basic types, for the client:
+#
+#   spi_marshal_Interface_Method (message, in...)
+#       appends the arguments to a new method call;
+#   spi_demarshal_Interface_Method_reply (reply, out *...)
+#       reads the reply to a method call, returning FALSE if it is of the
+#       wrong types;
+#   _atspi_dbus_call_Interface_Method (obj, error, in..., out *...)
+#       which makes the call in the same way as _atspi_dbus_call (), and is
+#       only defined when SPI_MARSHAL_CLIENT is (within libatspi).
+#
+# The client keeps hand-written code for methods with container arguments,
+# so nothing is generated for it there.
+#
+# Only the interfaces given are generated, so that the header only has
+# functions for the interfaces converted to it.
+
+import argparse
+from xml.etree import ElementTree
+
+HTEMPLATE = """
+/*
+ * This file has been auto-generated from the introspection data available
+ * in the at-spi2-core repository. The D-Bus protocol is defined in this
+ * repository, which can be found at:
+ *
+ * https://gitlab.gnome.org/GNOME/at-spi2-core
+ *
+ * DO NOT EDIT.
+ */
+
+#ifndef SPI_MARSHAL_H_
+#define SPI_MARSHAL_H_
+
+#include <dbus/dbus.h>
+
+%s
+#ifdef SPI_MARSHAL_CLIENT
+%s
+#endif /* SPI_MARSHAL_CLIENT */
+
+#endif /* SPI_MARSHAL_H_ */
+"""
+
+# D-Bus type code: (C type, DBUS_TYPE_ constant)
+BASIC_TYPES = {
+    "y": ("unsigned char", "DBUS_TYPE_BYTE"),
+    "b": ("dbus_bool_t", "DBUS_TYPE_BOOLEAN"),
+    "n": ("dbus_int16_t", "DBUS_TYPE_INT16"),
+    "q": ("dbus_uint16_t", "DBUS_TYPE_UINT16"),
+    "i": ("dbus_int32_t", "DBUS_TYPE_INT32"),
+    "u": ("dbus_uint32_t", "DBUS_TYPE_UINT32"),
+    "x": ("dbus_int64_t", "DBUS_TYPE_INT64"),
+    "t": ("dbus_uint64_t", "DBUS_TYPE_UINT64"),
+    "d": ("double", "DBUS_TYPE_DOUBLE"),
+    "s": ("const char *", "DBUS_TYPE_STRING"),
+    "o": ("const char *", "DBUS_TYPE_OBJECT_PATH"),
+}
+
+C_KEYWORDS = {
+    "auto", "break", "case", "char", "const", "continue", "default", "do",
+    "double", "else", "enum", "extern", "float", "for", "goto", "if", "int",
+    "long", "register", "return", "short", "signed", "sizeof", "static",
+    "struct", "switch", "typedef", "union", "unsigned", "void", "volatile",
+    "while", "index", "message", "reply", "iter", "obj", "error", "success",
+}
+
+def is_string (arg):
+    return arg["type"] in ("s", "o")
+
+def param (arg, pointer):
+    ctype = BASIC_TYPES[arg["type"]][0]
+    if pointer:
+        return "%s%s*%s" % (ctype, "" if ctype.endswith ("*") else " ", arg["name"])
+    return "%s%s%s" % (ctype, "" if ctype.endswith ("*") else " ", arg["name"])
+
+def params (args, pointer):
+    return "".join (", " + param (arg, pointer) for arg in args)
+
+def convert_args (method, direction):
+    args = []
+    elements = [a for a in method.findall ("arg") if a.attrib.get ("direction", "in") == direction]
+    for i, element in enumerate (elements):
+        name = element.attrib.get ("name")
+        if not name:
+            name = "ret" if len (elements) == 1 else "ret%d" % i
+        name = name.replace ("-", "_")
+        if name in C_KEYWORDS:
+            name = "_" + name
+        args.append ({"name": name, "type": element.attrib["type"]})
+    return args
+
+def demarshal_body (args, message):
+    signature = "".join (arg["type"] for arg in args)
+    lines = []
+    lines.append ("  DBusMessageIter iter;\n")
+    lines.append ("  if (!dbus_message_has_signature (%s, \"%s\"))" % (message, signature))
+    lines.append ("    return FALSE;")
+    lines.append ("  dbus_message_iter_init (%s, &iter);" % message)
+    for i, arg in enumerate (args):
+        if i > 0:
+            lines.append ("  dbus_message_iter_next (&iter);")
+        lines.append ("  dbus_message_iter_get_basic (&iter, %s);" % arg["name"])
+    lines.append ("  return TRUE;")
+    return "\n".join (lines)
+
+def marshal_lines (args):
+    lines = []
+    for arg in args:
+        lines.append ("  dbus_message_iter_append_basic (&iter, %s, &%s);" %
+                      (BASIC_TYPES[arg["type"]][1], arg["name"]))
+    return lines
+
+def generate_method (short_name, interface, method):
+    name = method.attrib["name"]
+    ins = convert_args (method, "in")
+    outs = convert_args (method, "out")
+    basic_ins = all (arg["type"] in BASIC_TYPES for arg in ins)
+    basic_outs = all (arg["type"] in BASIC_TYPES for arg in outs)
+    if not basic_ins and not basic_outs:
+        return "", ""
+
+    prefix = "%s_%s" % (short_name, name)
+    in_sig = "".join (arg["type"] for arg in ins)
+    out_sig = "".join (arg["type"] for arg in outs)
+    code = "\n/* %s.%s: (%s) => (%s) */\n" % (interface, name, in_sig, out_sig)
+
+    # Server side
+    if ins and basic_ins:
+        code += "\nstatic inline dbus_bool_t\nspi_demarshal_%s (DBusMessage *message%s)\n{\n%s\n}\n" % \
+            (prefix, params (ins, True), demarshal_body (ins, "message"))
+    if basic_outs:
+        body = ["  DBusMessage *reply;"]
+        if outs:
+            body.append ("  DBusMessageIter iter;")
+        body.append ("")
+        body.append ("  reply = dbus_message_new_method_return (message);")
+        if outs:
+            body.append ("  if (!reply)")
+            body.append ("    return NULL;")
+            body.append ("  dbus_message_iter_init_append (reply, &iter);")
+            body += marshal_lines (outs)
+        body.append ("  return reply;")
+        code += "\nstatic inline DBusMessage *\nspi_marshal_%s_reply (DBusMessage *message%s)\n{\n%s\n}\n" % \
+            (prefix, params (outs, False), "\n".join (body))
+
+    if not basic_ins or not basic_outs:
+        return code, ""
+
+    # Client side
+    if ins:
+        body = ["  DBusMessageIter iter;", "", "  dbus_message_iter_init_append (message, &iter);"]
+        body += marshal_lines (ins)
+        code += "\nstatic inline void\nspi_marshal_%s (DBusMessage *message%s)\n{\n%s\n}\n" % \
+            (prefix, params (ins, False), "\n".join (body))
+    if outs:
+        code += "\nstatic inline dbus_bool_t\nspi_demarshal_%s_reply (DBusMessage *reply%s)\n{\n%s\n}\n" % \
+            (prefix, params (outs, True), demarshal_body (outs, "reply"))
+
+    # Client call, which copies returned strings
+    client_outs = "".join (", %s*%s" % ("char *" if is_string (arg) else BASIC_TYPES[arg["type"]][0] + " ", arg["name"])
+                           for arg in outs)
+    body = ["  DBusMessage *message, *reply;"]
+    for arg in outs:
+        if is_string (arg):
+            body.append ("  const char *%s_str = NULL;" % arg["name"])
+    body.append ("  dbus_bool_t success = TRUE;")
+    body.append ("")
+    body.append ("  message = _atspi_dbus_method_call_new (obj, \"%s\", \"%s\", error);" % (interface, name))
+    body.append ("  if (!message)")
+    body.append ("    return FALSE;")
+    if ins:
+        body.append ("  spi_marshal_%s (message%s);" % (prefix, "".join (", " + arg["name"] for arg in ins)))
+    body.append ("  reply = _atspi_dbus_send_with_reply (obj, message, error);")
+    body.append ("  dbus_message_unref (message);")
+    body.append ("  if (!reply)")
+    body.append ("    return FALSE;")
+    if outs:
+        out_ptrs = "".join (", " + ("&%s_str" % arg["name"] if is_string (arg) else arg["name"]) for arg in outs)
+        body.append ("  if (!spi_demarshal_%s_reply (reply%s))" % (prefix, out_ptrs))
+        body.append ("    success = _atspi_dbus_set_signature_error (reply, \"%s\", \"%s\", error);" % (name, out_sig))
+        copies = ["*%s = g_strdup (%s_str);" % (arg["name"], arg["name"]) for arg in outs if is_string (arg)]
+        if len (copies) == 1:
+            body.append ("  else")
+            body.append ("    " + copies[0])
+        elif copies:
+            body.append ("  else")
+            body.append ("    {")
+            body += ["      " + copy for copy in copies]
+            body.append ("    }")
+    body.append ("  dbus_message_unref (reply);")
+    body.append ("  return success;")
+    client = "\nstatic inline dbus_bool_t\n_atspi_dbus_call_%s (gpointer obj, GError **error%s%s)\n{\n%s\n}\n" % \
+        (prefix, params (ins, False), client_outs, "\n".join (body))
+
+    return code, client
+
+def generate_marshal (inputs, h_output_filename):
+    hcontents = ""
+    ccontents = ""
+
+    for input_filename in inputs:
+        try:
+            tree = ElementTree.parse (input_filename)
+        except Exception as e:
+            raise type(e)(f"Invalid XML while parsing {input_filename}: {str(e)}")
+
+        root = tree.getroot ()
+
+        for itf in root.findall ("interface"):
+            interface = itf.attrib["name"]
+            short_name = interface.split (".")[-1]
+            for method in itf.findall ("method"):
+                code, client = generate_method (short_name, interface, method)
+                hcontents += code
+                ccontents += client
+
+    with open (h_output_filename, "w") as hfile:
+        hfile.write (HTEMPLATE % (hcontents, ccontents))
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Create a C header file of marshalling functions from DBus XML files")
+    parser.add_argument('sources', metavar='FILE.XML', nargs='+', help='DBus XML interface file')
+    parser.add_argument('--h-output', metavar='OUT.H', required=True, help='Name of output H file')
+    args = parser.parse_args()
+
+    generate_marshal (args.sources, args.h_output)